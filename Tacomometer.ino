@@ -10,126 +10,120 @@
 #include <lvgl.h>
 #include "src/lvgl_port.h"
 #include "src/board_config.h"
+#include "src/i2c_bus.h"
 #include "src/touch_driver.h"
 #include "src/imu_driver.h"
+#include "src/imu_recorder.h"
+#include "src/button.h"
+#include "src/persist.h"
+#include "src/loop_sched.h"
+#include "src/boot_timeline.h"
+#include "src/power.h"
+#include "src/perf_counters.h"
+#include "src/latency_probe.h"
 #include "src/ui.h"
 #include "src/web_server.h"
 
+// Pin 6 of the IO expander switches the panel's supply. Waits for the bus
+// (one-shot, nothing to retry it later) and retries a NACK.
+static bool displayPowerOn() {
+    // Set Pin 6 to Output (0 in Config Register)
+    uint8_t io_cfg = (uint8_t)~IO_EXPANDER_PIN_6_MASK; // 0xBF: Pin 6 Low (Output), others High (Input) default
+    // Set Pin 6 High (Power On)
+    uint8_t io_out = IO_EXPANDER_PIN_6_MASK;
+    for (int attempt = 1; attempt <= DISPLAY_POWER_ATTEMPTS; attempt++) {
+        if (i2cWriteReg(I2C_DEV_EXPANDER, IO_EXPANDER_ADDR, IO_EXPANDER_CONFIG_REG, &io_cfg, 1, I2C_WAIT_FOREVER) &&
+            i2cWriteReg(I2C_DEV_EXPANDER, IO_EXPANDER_ADDR, IO_EXPANDER_OUTPUT_REG, &io_out, 1, I2C_WAIT_FOREVER)) {
+            return true;
+        }
+        Serial.printf("Display power-on: IO expander NACK (attempt %d)\n", attempt);
+        delay(DISPLAY_POWER_SETTLE_MS);
+    }
+    return false;
+}
+
 void setup() {
     Serial.begin(115200);
-    delay(1000);
+    bootMark("setup");
+    perfInit();
     Serial.println("Starting Tacomometer (LVGL)...");
+    initPersist(); // NVS writes go through the persistence task; settings load from it
 
-    // 0. Check Boot Button for Factory Reset (Safe Mode)
+    // 0. Factory Reset: BOOT held at power-on, confirmed once the first frame is up
     pinMode(BOOT_BUTTON_PIN, INPUT_PULLUP);
-    if (digitalRead(BOOT_BUTTON_PIN) == LOW) {
-        Serial.println("Button Pressed at Boot -> Factory Reset...");
-        delay(100); // Debounce
-        // We need UI initialized first to reset UI preferences?
-        // ui_prefs is in ui.cpp. 
-        // We can init NVS manually or just init UI then reset.
-        // Let's Init everything then Reset.
-    }
-    Wire.begin(ESP32_SDA_NUM, ESP32_SCL_NUM);
-    delay(100);
+    bool reset_held = digitalRead(BOOT_BUTTON_PIN) == LOW;
+    if (reset_held) Serial.println("Button Pressed at Boot -> Factory Reset if still held...");
+
+    i2cBusInit(); // Owns Wire: IMU, touch and the IO expander share it
 
-    // 2. Enable Display Power (TCA9554 IO Expander)
+    // 1. Enable Display Power (TCA9554 IO Expander), before the IMU task:
+    // its bring-up holds the bus through the sensor reset. The rail then
+    // settles while the sensor comes up.
     Serial.println("Powering up display...");
-    
-    // Set Pin 6 to Output (0 in Config Register)
-    Wire.beginTransmission(IO_EXPANDER_ADDR);
-    Wire.write(IO_EXPANDER_CONFIG_REG); 
-    Wire.write(~IO_EXPANDER_PIN_6_MASK); // 0xBF: Pin 6 Low (Output), others High (Input) default
-    Wire.endTransmission();
-    
-    // Set Pin 6 High (Power On)
-    Wire.beginTransmission(IO_EXPANDER_ADDR);
-    Wire.write(IO_EXPANDER_OUTPUT_REG); 
-    Wire.write(IO_EXPANDER_PIN_6_MASK); 
-    Wire.endTransmission();
-    
-    delay(200);
+    if (!displayPowerOn()) Serial.println("Display power-on FAILED: IO expander not responding");
+
+    // 2. IMU (own task: sensor init overlaps the display bring-up below)
+    Serial.println("Initializing IMU...");
+    initRecorder(); // Raw IMU logging (idle until started from the Web UI)
+    startIMUTask(); // Loads the IMU settings now; sampling + fusion then run independently of loop()
+
+    delay(DISPLAY_POWER_SETTLE_MS);
+    bootMark("display power");
 
     // 3. Init LVGL Port (Display)
     Serial.println("Initializing LVGL Port...");
     lvgl_port_init();
     Serial.println("LVGL Initialized.");
+    bootMark("display ready");
 
     // 4. Init Touch
     Serial.println("Initializing Touch...");
     initTouch();
 
-    // 5. Init IMU
-    Serial.println("Initializing IMU...");
-    initIMU();
-
-    // 6. Init UI
+    // 5. Init UI, and push the first frame now rather than on the next LVGL tick
     Serial.println("Initializing UI...");
     lvgl_port_lock(-1);
-
     initUI();
-    
-    // 6b. FACTORY RESET CHECK (Dedicated Window)
-    // Hold BOOT button during first 2 seconds to reset
-    Serial.println("Press BOOT button now to Factory Reset...");
-    unsigned long boot_check_start = millis();
-    bool reset_triggered = false;
-    
-    // Initial check + small window
-    while(millis() - boot_check_start < 2000) {
-        if (digitalRead(BOOT_BUTTON_PIN) == LOW) {
-            // Button is pressed
-            delay(50); // Debounce
-            if (digitalRead(BOOT_BUTTON_PIN) == LOW) {
-                 Serial.println("FACTORY RESET TRIGGERED!");
-                 showToast("Resetting...");
-                 // Wait a moment for toast to render
-                 lv_timer_handler(); // Force UI update
-                 delay(500); 
-                 resetSettings(); // WWill wipe and Restart
-                 reset_triggered = true;
-                 break;
-            }
-        }
-        delay(10);
-    }
-    
-    if (!reset_triggered) {
-         Serial.println("Boot Continues...");
+    lv_refr_now(NULL);
+    bootMark("first frame");
+
+    if (reset_held && digitalRead(BOOT_BUTTON_PIN) == LOW) {
+        Serial.println("FACTORY RESET TRIGGERED!");
+        showToast("Resetting...");
+        lv_refr_now(NULL);
+        resetSettings(); // Will wipe and Restart
     }
-    
     lvgl_port_unlock();
     
-    // 7. Init Web Server (Standby)
+    // 6. Init Web Server (Standby)
     initWebServer();
     
-    // 8. Init Button
-    pinMode(BOOT_BUTTON_PIN, INPUT_PULLUP);
-}
-
-// Button State
-bool btn_last_state = HIGH;
-uint32_t btn_press_start = 0;
-bool btn_long_press_handled = false;
+    // 7. Init Button (Interrupt driven, events queued for loop())
+    initButton();
 
-// Double Tap State
-uint32_t last_btn_release = 0;
-uint32_t last_tap_time = 0; // Added for double click logic
-int btn_click_count = 0;
+    // 8. Power Management (motion-aware rates, dimming, light sleep)
+    initPower();
+    bootMark("setup done");
+}
 
 // --- Background NVS Save (Deferred) ---
 bool save_cal_pending = false;
 unsigned long save_cal_timer = 0;
 
-void loop() {
-    // Read IMU
-    updateIMU();
-    float roll = getRoll();
-    float pitch = getPitch();
+// --- Loop Jobs (see LOOP_* periods in board_config.h) ---
+static void uiJob() {
+    // Latest attitude from the IMU task (non-blocking snapshot)
+    static IMUAttitude att = {0};
+    readIMUAttitude(&att);
+    uint32_t read_us = micros();
 
     // Update UI (Thread Safe)
     lvgl_port_lock(-1);
-    updateUI(roll, pitch);
+    setIMUDegraded(att.degraded);
+    uint32_t perf = perfBegin();
+    updateUI(att.roll, att.pitch);
+    perfEnd(PERF_UI_UPDATE, perf);
+    if (!att.degraded && att.publish_us) latencyUIUpdate(att.timestamp_us, att.publish_us, read_us);
     
     lvgl_port_unlock();
     
@@ -139,64 +133,133 @@ void loop() {
         Serial.println("Calibration Triggered! (RAM Update)");
         // delay(100); // No longer needed for RAM update
         zeroIMU(); 
-        yield(); 
         
-        // Schedule NVS Save for later (when UI is idle/safe)
+        // Schedule NVS Save for later (persistJob, once the IMU task applied the zero)
         save_cal_pending = true;
         save_cal_timer = millis();
     }
-    
+}
+
+static void webJob() {
     // Handle Web Server Clients
+    uint32_t perf = perfBegin();
     handleWebServer();
-    
-    // --- Button Logic (BOOT Button) ---
-    bool btn_state = digitalRead(BOOT_BUTTON_PIN);
-    
-    // Press Detected (Active Low)
-    if (btn_state == LOW && btn_last_state == HIGH) {
-        btn_press_start = millis();
-        btn_long_press_handled = false;
+    perfEnd(PERF_WEB, perf);
+}
+
+static void recorderJob() {
+    // --- IMU Recorder (Flush full buffers to flash) ---
+    serviceRecorder();
+}
+
+static void persistJob() {
+    // --- Background NVS Save (Deferred) ---
+    if (save_cal_pending && millis() - save_cal_timer > 3000) {
+        Serial.println("Saving Calibration to NVS (Safe Time)...");
+        saveIMUOffsets();
+        save_cal_pending = false;
+        // showToast("Settings Saved"); // Removed as requested
     }
-    
-    // Pending active press
-    if (btn_state == LOW) {
-        // Check for long press (e.g., 2000ms) to ENABLE WiFi
-        if (!isAPMode()) {
-             if (millis() - btn_press_start > 2000 && !btn_long_press_handled) {
-                // Long Press Detected -> Turn ON AP
-                btn_long_press_handled = true;
+
+    // --- Warm Start Snapshot (Periodic) ---
+    static unsigned long warmstart_timer = 0;
+    if (millis() - warmstart_timer > IMU_WARMSTART_SAVE_MS) {
+        saveIMUWarmStart(); // No-op until bias + filter are valid, or if unchanged
+        warmstart_timer = millis();
+    }
+}
+
+// --- BOOT Button Events ---
+static void handleButtonEvent(const ButtonEvent& ev) {
+    powerNoteActivity();
+    switch (ev.type) {
+        case BTN_EV_LONG:
+            // Long Press (BUTTON_LONG_MS) -> Turn ON AP
+            if (!isAPMode()) {
                 lvgl_port_lock(-1);
                 showToast("Ready to Pair\nWiFi: Tacomometer\nIP: 192.168.4.1", 0);
                 lvgl_port_unlock();
                 startAPMode();
-             }
-        }
+            }
+            break;
+        case BTN_EV_CLICK:
+            // Single Click Action: Turn off AP Mode if active
+            if (isAPMode()) {
+                stopAPMode();
+            }
+            break;
+        case BTN_EV_DOUBLE:
+            // Double Click: Zero the inclinometer (same as the long touch on screen)
+            lvgl_port_lock(-1);
+            triggerCalibrationUI();
+            lvgl_port_unlock();
+            break;
     }
-    
-    // Release Detected
-    if (btn_state == HIGH && btn_last_state == LOW) {
-        uint32_t release_time = millis();
-        uint32_t press_duration = release_time - btn_press_start;
-        
-        // Short Press Logic (< 1000ms)
-        if (press_duration < 1000 && !btn_long_press_handled) {
-             // Single Click Action: Turn off AP Mode if active
-             if (isAPMode()) {
-                 stopAPMode();
-             }
-             // Rotation logic removed as per request (Moved to Web UI)
+}
+
+static void powerJob();
+
+static void perfJob() {
+    perfRollWindow();
+}
+
+static void consoleJob() {
+    // Serial commands, one per line: "perf" dumps the last counter window,
+    // "lat" the motion-to-photon latency ("lat reset" clears it)
+    static char line[16];
+    static uint8_t len = 0;
+    while (Serial.available()) {
+        char c = Serial.read();
+        if (c == '\r' || c == '\n') {
+            line[len] = 0;
+            if (!strcmp(line, "perf")) printPerf();
+            else if (!strcmp(line, "lat")) printLatency();
+            else if (!strcmp(line, "lat reset")) latencyReset();
+            len = 0;
+        } else if (len < sizeof(line) - 1) {
+            line[len++] = c;
         }
     }
-    
-    btn_last_state = btn_state;
-    
-    // --- Background NVS Save (Deferred) ---
-    if (save_cal_pending && millis() - save_cal_timer > 3000) {
-        Serial.println("Saving Calibration to NVS (Safe Time)...");
-        saveIMUOffsets();
-        save_cal_pending = false;
-        // showToast("Settings Saved"); // Removed as requested
+}
+
+static SchedJob loop_jobs[] = {
+    { "ui",       uiJob,       LOOP_UI_PERIOD_MS * 1000UL,       0 },  // Period set by powerJob()
+    { "web",      webJob,      LOOP_WEB_PERIOD_MS * 1000UL,      0 },
+    { "recorder", recorderJob, LOOP_RECORDER_PERIOD_MS * 1000UL, 0 },
+    { "persist",  persistJob,  LOOP_PERSIST_PERIOD_MS * 1000UL,  SCHED_IDLE },
+    { "power",    powerJob,    POWER_POLL_MS * 1000UL,           0 },
+    { "perf",     perfJob,     PERF_WINDOW_MS * 1000UL,          0 },
+    { "console",  consoleJob,  LOOP_CONSOLE_PERIOD_MS * 1000UL,  0 },
+};
+static SchedLoop loop_sched;
+
+static uint32_t schedClock() {
+    return micros();
+}
+
+static void powerJob() {
+    // May light sleep in here until motion (power.h)
+    servicePower();
+
+    // New UI rate: due now, so full rate resumes without waiting out a slow period
+    uint32_t ui_us = getPowerUIPeriodMs() * 1000UL;
+    if (loop_jobs[0].period_us != ui_us) {
+        loop_jobs[0].period_us = ui_us;
+        loop_jobs[0].next_us = schedClock();
+    }
+}
+
+void loop() {
+    static bool sched_ready = false;
+    if (!sched_ready) {
+        schedInit(&loop_sched, loop_jobs, sizeof(loop_jobs) / sizeof(loop_jobs[0]),
+                  schedClock, LOOP_IDLE_SLACK_MS * 1000UL);
+        sched_ready = true;
     }
 
-    delay(20); // 50Hz Update Rate (Faster for button response)
+    // Sleep until the next deadline (whole 1ms ticks; waking a tick early just
+    // costs a short extra pass). A button event wakes the loop straight away.
+    uint32_t wait_us = schedRun(&loop_sched);
+    ButtonEvent ev;
+    if (waitButtonEvent(&ev, (wait_us + 999) / 1000)) handleButtonEvent(ev);
 }
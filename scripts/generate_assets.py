@@ -16,12 +16,19 @@ COLOR_TICK_MAJOR = "#FFFFFF"
 COLOR_TICK_MINOR = "#404040"
 COLOR_POINTER = "#FF3D00" # Red-Orange
 
+# Pointer Atlas (pre-rotated A8 frames, tinted by image_recolor)
+ATLAS_FRAME = 38       # Covers the 20x30 pointer at any angle around its pivot (10, 15)
+ATLAS_STEP = 2         # Degrees between frames
+ATLAS_HALF = 23        # Frames each side of a range centre: +/-46 deg
+ATLAS_CENTRES = [270, 90]  # lv_image_set_rotation() of a level roll / pitch pointer
+
 def write_c_file(name, img, cf_type="LV_COLOR_FORMAT_ARGB8888"):
     """
     Writes a C file compatible with LVGL image converter.
     cf_type: 
       - LV_COLOR_FORMAT_ARGB8888 (32-bit)
       - LV_COLOR_FORMAT_RGB565 (16-bit)
+      - LV_COLOR_FORMAT_RGB565_SWAPPED (16-bit, panel byte order, LVGL 9.2+)
     """
     width, height = img.size
     
@@ -53,6 +60,13 @@ def write_c_file(name, img, cf_type="LV_COLOR_FORMAT_ARGB8888"):
                 low = c & 0xFF
                 high = (c >> 8) & 0xFF
                 f.write(f"  0x{low:02x}, 0x{high:02x}, \n")
+
+        elif cf_type == "LV_COLOR_FORMAT_RGB565_SWAPPED":
+            # 16-bit RGB565, High byte first (SH8601 order, copied as is
+            # into an LCD_NATIVE_SWAP draw buffer)
+            for r, g, b, a in data: # Alpha ignored
+                c = ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3)
+                f.write(f"  0x{(c >> 8) & 0xFF:02x}, 0x{c & 0xFF:02x}, \n")
         
         f.write("};\n\n")
         
@@ -454,6 +468,66 @@ def generate_pointer():
     img = c.finish()
     write_c_file("img_pointer", img, "LV_COLOR_FORMAT_ARGB8888")
 
+def pointer_shape(c, angle, ox, oy):
+    # The generate_pointer() triangle, rotated clockwise about its pivot.
+    # LVGL pivots on pixel (10, 15), whose centre is at (10.5, 15.5).
+    rad = math.radians(angle)
+    cos_a, sin_a = math.cos(rad), math.sin(rad)
+    def rot(x, y):
+        dx, dy = x - 10.5, y - 15.5
+        return (ox + dx * cos_a - dy * sin_a, oy + dx * sin_a + dy * cos_a)
+    c.polygon([rot(10, 0), rot(20, 30), rot(0, 30)], "#FFFFFF")
+
+def generate_pointer_atlas():
+    # Every frame the gauges can show, pre-rotated: updateUI() picks one
+    # instead of having LVGL transform the ARGB8888 pointer on each redraw.
+    # Alpha only (1 byte/px); the colour comes from image_recolor.
+    angles = []
+    for centre in ATLAS_CENTRES:
+        for k in range(-ATLAS_HALF, ATLAS_HALF + 1):
+            angles.append(centre + k * ATLAS_STEP)
+
+    name = "img_pointer_atlas"
+    frame_bytes = ATLAS_FRAME * ATLAS_FRAME
+    print(f"Writing {name} ({len(angles)} frames, {ATLAS_FRAME}x{ATLAS_FRAME} A8, {len(angles) * frame_bytes} bytes)...")
+
+    with open(f"src/{name}.c", 'w') as f:
+        f.write(f"#include <lvgl.h>\n")
+        f.write(f"#include \"{name}.h\"\n\n")
+        f.write(f"const uint8_t {name}_map[] = {{\n")
+        for angle in angles:
+            c = Canvas(ATLAS_FRAME, ATLAS_FRAME)
+            pointer_shape(c, angle, ATLAS_FRAME // 2 + 0.5, ATLAS_FRAME // 2 + 0.5)
+            alpha = c.finish().getchannel("A")
+            f.write(f"  /* {angle} deg */\n")
+            for y in range(ATLAS_FRAME):
+                row = [alpha.getpixel((x, y)) for x in range(ATLAS_FRAME)]
+                f.write("  " + "".join(f"0x{v:02x}, " for v in row) + "\n")
+        f.write("};\n\n")
+
+        f.write(f"#define FRAME(i) {{ .header.cf = LV_COLOR_FORMAT_A8, .header.magic = LV_IMAGE_HEADER_MAGIC, \\\n")
+        f.write(f"    .header.w = {ATLAS_FRAME}, .header.h = {ATLAS_FRAME}, .data_size = {frame_bytes}, .data = {name}_map + (i) * {frame_bytes} }}\n\n")
+        f.write(f"const lv_image_dsc_t {name}[{len(angles)}] = {{\n")
+        for i in range(len(angles)):
+            f.write(f"  FRAME({i}),\n")
+        f.write("};\n")
+
+    with open(f"src/{name}.h", 'w') as f:
+        f.write(f"#ifndef {name.upper()}_H\n")
+        f.write(f"#define {name.upper()}_H\n\n")
+        f.write(f"#include <lvgl.h>\n\n")
+        f.write(f"// Pointer pre-rotated about its pivot, which sits at pixel (FRAME / 2, FRAME / 2).\n")
+        f.write(f"// Range r holds frames for POINTER_ATLAS_CENTRE_r +/- k * POINTER_ATLAS_STEP.\n")
+        f.write(f"#define POINTER_ATLAS_FRAME   {ATLAS_FRAME}\n")
+        f.write(f"#define POINTER_ATLAS_STEP    {ATLAS_STEP}\n")
+        f.write(f"#define POINTER_ATLAS_HALF    {ATLAS_HALF}\n")
+        f.write(f"#define POINTER_ATLAS_RANGE   {2 * ATLAS_HALF + 1}   // Frames per range\n")
+        for r, centre in enumerate(ATLAS_CENTRES):
+            f.write(f"#define POINTER_ATLAS_CENTRE_{r} {centre}\n")
+        f.write(f"\nextern const uint8_t {name}_map[];\n")
+        f.write(f"extern const lv_image_dsc_t {name}[{len(angles)}];\n\n")
+        f.write(f"#endif\n")
+
 if __name__ == "__main__":
     if not os.path.exists("src"):
         os.makedirs("src")
@@ -462,4 +536,5 @@ if __name__ == "__main__":
     # generate_truck_rear()
     generate_truck_side()
     # generate_pointer()
+    generate_pointer_atlas()
     print("Done!")
@@ -6,3 +6,4 @@
 #include "img_truck_rear.h"
 #include "img_truck_side.h"
 #include "img_pointer.h"
+#include "img_pointer_atlas.h"
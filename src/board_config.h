@@ -5,11 +5,22 @@
 // --- I2C ---
 #define ESP32_SCL_NUM (GPIO_NUM_8)
 #define ESP32_SDA_NUM (GPIO_NUM_18)
+#define I2C_BUS_CLOCK_HZ        400000 // Fast mode (QMI8658, touch and TCA9554 all support it)
+#define I2C_IMU_TIMEOUT_MS      5      // Longest wait for the bus (i2c_bus.h)
+#define I2C_TOUCH_TIMEOUT_MS    2      // Touch skips a poll rather than wait
+#define I2C_EXPANDER_TIMEOUT_MS 50     // Runtime writes; the boot power-on waits with I2C_WAIT_FOREVER
 
 // --- DISPLAY ---
 #define LCD_H_RES 466
 #define LCD_V_RES 466
 #define LVGL_BUF_HEIGHT 50 
+#define LCD_NATIVE_SWAP 1  // LVGL renders panel byte order (RGB565_SWAPPED, LVGL 9.2+); 0 = swap in the flush callback
+
+// Round panel: render and send only the visible disk (circle_clip.h)
+#define LCD_CIRCLE_CLIP       1
+#define LCD_CIRCLE_MARGIN_PX  1   // Disk radius beyond LCD_H_RES / 2
+#define LCD_CIRCLE_BAND_ROWS  40  // Invalidated areas: rows per band (even; full screen = 12 of LV_INV_BUF_SIZE)
+#define LCD_CIRCLE_FLUSH_ROWS 50  // Flush chunks: rows per address window (even; each extra window waits out the previous DMA)
 
 #define LCD_CS_PIN         GPIO_NUM_10
 #define LCD_PCLK_PIN       GPIO_NUM_11
@@ -29,11 +40,97 @@
 #define LVGL_TASK_MIN_DELAY_MS 1
 #define LVGL_TASK_STACK_SIZE   (4 * 1024)
 #define LVGL_TASK_PRIORITY     2
+
+// --- TRUCK IMAGES (truck_cache.h) ---
+#define TRUCK_CACHE_SLOTS      2    // Rendered angles kept per truck (RGB565A8: 24 KB roll, 27 KB pitch each)
+#define TRUCK_CACHE_STEP       10   // Angle key in 0.1 deg: a step moves the trucks' far edge < 1 px
+
 // --- IO EXPANDER (TCA9554) ---
 #define IO_EXPANDER_ADDR       0x20
 #define IO_EXPANDER_CONFIG_REG 0x03
 #define IO_EXPANDER_OUTPUT_REG 0x01
 #define IO_EXPANDER_PIN_6_MASK 0x40 // Display Power Control
 
+// --- BOOT ---
+// The panel reset (esp_lcd_panel_reset) has its own post-reset wait, so only
+// the power rail ramp is needed between the expander write and the reset.
+#define DISPLAY_POWER_SETTLE_MS 20
+#define DISPLAY_POWER_ATTEMPTS  3  // IO expander writes at boot (NACK retries)
+
+// --- IMU (QMI8658) ---
+// FIFO acquisition drains every sample in one burst per update instead of
+// polling the latest one. Set to 0 to fall back to data-ready polling.
+#define IMU_USE_FIFO           1
+#define IMU_SAMPLE_PERIOD_US   1115 // Accel+Gyro run in sync at the Gyro ODR (896.8Hz)
+#define IMU_FIFO_WATERMARK     8    // Samples (~9ms at 896.8Hz)
+#define IMU_FIFO_MAX_SAMPLES   128  // Hardware FIFO depth (per sensor)
+#define IMU_MAX_GAP_SAMPLES    1024 // Larger sample counter jumps are a sensor reset, not a gap
+
+// Q16.16 integer filter for modes 0/1 (imu_fixed.h). Needs raw FIFO counts.
+// Mode 2 (Quaternion) always runs in float.
+#define IMU_USE_FIXED_POINT    0
+
+#define IMU_TASK_PERIOD_MS     10
+#define IMU_TASK_STACK_SIZE    (4 * 1024)
+#define IMU_TASK_PRIORITY      5    // Above LVGL (2) and the Arduino loop (1)
+
+// QMI8658 INT2 (FIFO watermark, or data-ready when IMU_USE_FIFO=0).
+// -1 = not routed: the IMU task falls back to timed wakeups at IMU_TASK_PERIOD_MS.
+#define IMU_INT_PIN            (-1)
+#define IMU_INT_TIMEOUT_MS     50   // Drain anyway if no interrupt arrives (missed edge)
+
+// Warm start: Gyro bias + filter attitude snapshot in NVS, restored at boot
+#define IMU_WARMSTART_SAVE_MS   (10UL * 60 * 1000) // Periodic snapshot (flash wear)
+#define IMU_WARMSTART_MAX_BOOTS 20   // Snapshots older than this many boots are ignored
+#define IMU_SEED_SAMPLES        16   // Averaged accel window before the filter starts (~18ms)
+
+// Health watchdog: Re-init the sensor when samples stop, freeze or the bus keeps failing
+#define IMU_STALL_MS              200  // No new sample for this long
+#define IMU_STUCK_SAMPLES         256  // Identical raw frames in a row (noise always moves an LSB)
+#define IMU_BUS_ERROR_MAX         8    // I2C errors per IMU_BUS_ERROR_WINDOW_MS
+#define IMU_BUS_ERROR_WINDOW_MS   1000
+#define IMU_REINIT_BACKOFF_MS     250  // Between re-init attempts, doubling per failure
+#define IMU_REINIT_BACKOFF_MAX_MS 8000
+
+// --- LOOP SCHEDULER (loop_sched.h) ---
+// The IMU has its own task (above); these are the Arduino loop's jobs.
+#define LOOP_UI_PERIOD_MS       33   // Attitude -> UI at the LVGL refresh rate (~30Hz)
+#define LOOP_WEB_PERIOD_MS      50   // handleClient() (AP mode only)
+#define LOOP_RECORDER_PERIOD_MS 100  // IMU log flush (each 4KB buffer lasts ~0.5s)
+#define LOOP_PERSIST_PERIOD_MS  250  // Deferred calibration / warm start saves (idle job, queued to persist.h)
+#define LOOP_IDLE_SLACK_MS      5    // Idle jobs start only with this much room before the next deadline
+#define LOOP_CONSOLE_PERIOD_MS  100  // Serial commands ("perf")
+
+// --- PERSISTENCE (persist.h) ---
+#define PERSIST_COMMIT_MS       2000 // Batch window: commit this long after the first pending write
+#define PERSIST_QUEUE_LEN       32
+#define PERSIST_MAX_PENDING     24   // Distinct keys per batch (commits early when full)
+#define PERSIST_OVERFLOW_SLOTS  24   // Queue full: newest value per key held for the task (>= keys in use)
+#define PERSIST_TASK_STACK_SIZE (3 * 1024)
+#define PERSIST_TASK_PRIORITY   1    // Background, same as the Arduino loop
+
+// --- POWER (power_policy.h) ---
+// Stillness: every poll under both thresholds. Idle times count from the
+// last motion or user input (touch, button). 0 disables a stage.
+#define POWER_ENABLE               1
+#define POWER_POLL_MS              100
+#define POWER_STILL_GYRO_DPS       3    // Engine idle vibration stays well under this
+#define POWER_STILL_ACC_MG         40
+#define POWER_STILL_MS             (15UL * 1000)      // -> reduced rates
+#define POWER_DIM_MS               (2UL * 60 * 1000)  // -> panel dimmed
+#define POWER_SLEEP_MS             (10UL * 60 * 1000) // -> panel off, light sleep
+#define POWER_STILL_REFR_MS        200  // LVGL refresh while still / dim (5 fps)
+#define POWER_STILL_UI_PERIOD_MS   200  // Loop UI job while still / dim
+#define POWER_STILL_IMU_PERIOD_MS  50   // IMU FIFO drain while still / dim (45 samples)
+#define POWER_DIM_BRIGHTNESS       40   // Of 255
+#define POWER_WOM_MG               60   // QMI8658 wake-on-motion threshold
+#define POWER_SLEEP_POLL_MS        250  // Light sleep timer wakeup: bounds the wake latency
+
 // --- BUTTONS ---
 #define BOOT_BUTTON_PIN        9 // ESP32-C6 Boot Button
+#define BUTTON_DEBOUNCE_MS     20   // Quiet time before a level counts
+#define BUTTON_CLICK_MAX_MS    1000 // Longer presses aren't clicks
+#define BUTTON_DOUBLE_GAP_MS   300  // Release -> second press (single clicks wait this long)
+#define BUTTON_LONG_MS         2000 // Held -> long press (AP mode)
+#define BUTTON_TASK_STACK_SIZE (2 * 1024)
+#define BUTTON_TASK_PRIORITY   4    // Below the IMU (5), above LVGL (2)
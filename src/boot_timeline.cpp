@@ -0,0 +1,38 @@
+/*
+ * File: boot_timeline.cpp
+ * Description: Timestamped Boot Phases Implementation
+ * Author: zzackk125
+ * License: MIT
+ */
+
+#include "boot_timeline.h"
+#include <Arduino.h>
+#include <atomic>
+
+static BootPhase phases[BOOT_TIMELINE_MAX];
+static std::atomic<int> claimed(0);
+
+void bootMark(const char* name) {
+    uint32_t t = micros();
+    int i = claimed.fetch_add(1);
+    if (i >= BOOT_TIMELINE_MAX) return;
+    phases[i].t_us = t;
+    std::atomic_thread_fence(std::memory_order_release);
+    phases[i].name = name; // Published last: readers skip slots without a name
+    Serial.printf("[boot] %7.1f ms  %s\n", t / 1000.0f, name);
+}
+
+int getBootTimeline(BootPhase* out, int max) {
+    int n = claimed.load();
+    if (n > BOOT_TIMELINE_MAX) n = BOOT_TIMELINE_MAX;
+    int count = 0;
+    for (int i = 0; i < n && count < max; i++) {
+        const char* name = phases[i].name;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (!name) continue; // Claimed, not written yet
+        out[count].name = name;
+        out[count].t_us = phases[i].t_us;
+        count++;
+    }
+    return count;
+}
@@ -0,0 +1,26 @@
+/*
+ * File: boot_timeline.h
+ * Description: Timestamped Boot Phases (serial + /boot)
+ * Author: zzackk125
+ * License: MIT
+ *
+ * bootMark() stamps a phase with micros() (esp_timer, which starts with the
+ * app; ROM and bootloader time isn't included) and logs it. Any task may
+ * mark: the IMU task reports its own phases while setup() carries on.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#define BOOT_TIMELINE_MAX 16
+
+struct BootPhase {
+    const char* name;   // String literal
+    uint32_t t_us;
+};
+
+void bootMark(const char* name);
+
+// Copies the phases recorded so far, returns how many
+int getBootTimeline(BootPhase* out, int max);
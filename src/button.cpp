@@ -0,0 +1,80 @@
+/*
+ * File: button.cpp
+ * Description: Interrupt Driven BOOT Button Implementation
+ * Author: zzackk125
+ * License: MIT
+ */
+
+#include "button.h"
+#include "board_config.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+
+static ButtonEngine engine;           // Button task only
+static QueueHandle_t ev_queue = NULL;
+static TaskHandle_t btn_task_handle = NULL;
+static volatile uint32_t isr_edge_ms = 0;
+static uint32_t queue_dropped = 0;
+static uint32_t events = 0;
+
+static void IRAM_ATTR button_isr() {
+    BaseType_t woken = pdFALSE;
+    isr_edge_ms = millis();
+    vTaskNotifyGiveFromISR(btn_task_handle, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+static bool pinPressed() {
+    return digitalRead(BOOT_BUTTON_PIN) == LOW; // Active low
+}
+
+static void button_task(void* arg) {
+    for (;;) {
+        uint32_t timeout = btnNextTimeout(&engine, millis());
+        TickType_t ticks = (timeout == BTN_NO_TIMEOUT) ? portMAX_DELAY : pdMS_TO_TICKS(timeout);
+
+        // Woken by an edge, or by the decoder's next deadline
+        if (ulTaskNotifyTake(pdTRUE, ticks)) btnEdge(&engine, isr_edge_ms, pinPressed());
+        btnUpdate(&engine, millis());
+
+        // Settled but the pin disagrees: an edge was lost, resync
+        if (!engine.settling && pinPressed() != engine.stable) btnEdge(&engine, millis(), pinPressed());
+
+        ButtonEvent ev;
+        while (btnPop(&engine, &ev)) {
+            if (xQueueSend(ev_queue, &ev, 0) == pdTRUE) events++;
+            else queue_dropped++;
+        }
+    }
+}
+
+void initButton() {
+    if (btn_task_handle) return;
+
+    pinMode(BOOT_BUTTON_PIN, INPUT_PULLUP);
+    ButtonTiming timing = { BUTTON_DEBOUNCE_MS, BUTTON_CLICK_MAX_MS, BUTTON_DOUBLE_GAP_MS, BUTTON_LONG_MS };
+    btnInit(&engine, &timing, pinPressed());
+
+    ev_queue = xQueueCreate(BTN_QUEUE_LEN, sizeof(ButtonEvent));
+    xTaskCreate(button_task, "Button", BUTTON_TASK_STACK_SIZE, NULL, BUTTON_TASK_PRIORITY, &btn_task_handle);
+
+    // Attach after the task exists so the ISR always has someone to notify
+    attachInterrupt(digitalPinToInterrupt(BOOT_BUTTON_PIN), button_isr, CHANGE);
+}
+
+bool waitButtonEvent(ButtonEvent* ev, uint32_t timeout_ms) {
+    if (!ev_queue) {
+        if (timeout_ms) delay(timeout_ms);
+        return false;
+    }
+    return xQueueReceive(ev_queue, ev, pdMS_TO_TICKS(timeout_ms)) == pdTRUE;
+}
+
+void getButtonStats(ButtonStats* out) {
+    if (!out) return;
+    out->edges = engine.edges;
+    out->glitches = engine.glitches;
+    out->events = events;
+    out->dropped = engine.dropped + queue_dropped;
+}
@@ -0,0 +1,29 @@
+/*
+ * File: button.h
+ * Description: Interrupt Driven BOOT Button (button_engine.h on the device)
+ * Author: zzackk125
+ * License: MIT
+ *
+ * The GPIO interrupt timestamps edges and wakes a small task that runs the
+ * debounce / click decoder and queues the events for the loop. Timing comes
+ * from the edges, so a busy loop delays handling but never the decoding.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include "button_engine.h"
+
+struct ButtonStats {
+    uint32_t edges;
+    uint32_t glitches;   // Bursts that settled back where they started
+    uint32_t events;
+    uint32_t dropped;    // Queue full (loop not draining)
+};
+
+void initButton();       // After the factory reset window (setup)
+
+// Loop: Next event, blocking up to timeout_ms (0 = poll). False on timeout.
+bool waitButtonEvent(ButtonEvent* ev, uint32_t timeout_ms);
+
+void getButtonStats(ButtonStats* out);
@@ -0,0 +1,127 @@
+/*
+ * File: button_engine.cpp
+ * Description: Button Debounce + Click / Double-Click / Long-Press Decoder Implementation
+ * Author: zzackk125
+ * License: MIT
+ */
+
+#include "button_engine.h"
+#include <string.h>
+
+void btnInit(ButtonEngine* b, const ButtonTiming* timing, bool pressed) {
+    memset(b, 0, sizeof(*b));
+    b->timing = *timing;
+    b->raw = b->stable = pressed;
+    b->long_fired = pressed; // Held since boot: not a long press
+}
+
+static void emit(ButtonEngine* b, uint8_t type, uint32_t press_ms, uint32_t held_ms) {
+    uint8_t next = (b->head + 1) % BTN_QUEUE_LEN;
+    if (next == b->tail) {
+        b->dropped++;
+        return;
+    }
+    b->queue[b->head] = { type, press_ms, held_ms };
+    b->head = next;
+}
+
+bool btnPop(ButtonEngine* b, ButtonEvent* ev) {
+    if (b->tail == b->head) return false;
+    *ev = b->queue[b->tail];
+    b->tail = (b->tail + 1) % BTN_QUEUE_LEN;
+    return true;
+}
+
+// The click owed from a first press whose second press didn't complete a double
+static void flushClick(ButtonEngine* b) {
+    if (b->click_pending) emit(b, BTN_EV_CLICK, b->first_press_ms, b->release_ms - b->first_press_ms);
+    b->click_pending = false;
+    b->second_press = false;
+}
+
+static void pressed(ButtonEngine* b, uint32_t t) {
+    if (b->click_pending && t - b->release_ms <= b->timing.double_gap_ms) b->second_press = true;
+    else flushClick(b);
+    b->press_ms = t;
+    b->long_fired = false;
+}
+
+static void released(ButtonEngine* b, uint32_t t) {
+    uint32_t held = t - b->press_ms;
+    if (b->long_fired) return;
+
+    if (held >= b->timing.click_max_ms) {
+        flushClick(b); // Too long for a click, too short for a long press
+    } else if (b->second_press) {
+        emit(b, BTN_EV_DOUBLE, b->first_press_ms, held);
+        b->click_pending = false;
+        b->second_press = false;
+    } else {
+        b->click_pending = true;
+        b->first_press_ms = b->press_ms;
+        b->release_ms = t;
+    }
+}
+
+void btnEdge(ButtonEngine* b, uint32_t t_ms, bool level) {
+    b->edges++;
+    if (!b->settling) b->burst_ms = t_ms;
+    b->raw = level;
+    b->last_edge_ms = t_ms;
+    b->settling = true;
+}
+
+// Deadlines are held off while an edge that would cancel them is settling
+static bool longArmed(const ButtonEngine* b) {
+    return b->stable && !b->long_fired && !(b->settling && !b->raw);
+}
+
+static bool clickArmed(const ButtonEngine* b) {
+    return b->click_pending && !b->stable && !(b->settling && b->raw);
+}
+
+void btnUpdate(ButtonEngine* b, uint32_t t_ms) {
+    if (b->settling && t_ms - b->last_edge_ms >= b->timing.debounce_ms) {
+        b->settling = false;
+        if (b->raw == b->stable) {
+            b->glitches++;
+        } else {
+            b->stable = b->raw;
+            if (b->stable) pressed(b, b->burst_ms);
+            else released(b, b->burst_ms);
+        }
+    }
+
+    if (longArmed(b) && t_ms - b->press_ms >= b->timing.long_ms) {
+        b->long_fired = true;
+        flushClick(b);
+        emit(b, BTN_EV_LONG, b->press_ms, b->timing.long_ms);
+    }
+
+    if (clickArmed(b) && t_ms - b->release_ms > b->timing.double_gap_ms) flushClick(b);
+}
+
+uint32_t btnNextTimeout(const ButtonEngine* b, uint32_t t_ms) {
+    uint32_t best = BTN_NO_TIMEOUT;
+    uint32_t due[3];
+    int n = 0;
+    if (b->settling) due[n++] = b->last_edge_ms + b->timing.debounce_ms;
+    if (longArmed(b)) due[n++] = b->press_ms + b->timing.long_ms;
+    if (clickArmed(b)) due[n++] = b->release_ms + b->timing.double_gap_ms + 1;
+
+    for (int i = 0; i < n; i++) {
+        int32_t left = (int32_t)(due[i] - t_ms);
+        uint32_t ms = left > 0 ? (uint32_t)left : 0;
+        if (ms < best) best = ms;
+    }
+    return best;
+}
+
+const char* btnEventName(uint8_t type) {
+    switch (type) {
+        case BTN_EV_CLICK:  return "click";
+        case BTN_EV_DOUBLE: return "double";
+        case BTN_EV_LONG:   return "long";
+        default:            return "?";
+    }
+}
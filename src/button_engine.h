@@ -0,0 +1,79 @@
+/*
+ * File: button_engine.h
+ * Description: Button Debounce + Click / Double-Click / Long-Press Decoder - No Arduino dependencies
+ * Author: zzackk125
+ * License: MIT
+ *
+ * Fed raw (bouncing) edges with their timestamps. A level counts once no
+ * edge has arrived for debounce_ms; the press / release time is the first
+ * edge of the burst, so bounce never shifts the timing.
+ *
+ *   CLICK   released within click_max_ms, no second press within double_gap_ms
+ *   DOUBLE  two such presses, the second starting within double_gap_ms
+ *   LONG    held for long_ms (emitted while still held)
+ *
+ * Presses between click_max_ms and long_ms are ignored. The caller calls
+ * btnUpdate() when btnNextTimeout() says so (settle, long press and double
+ * click deadlines); tools/button_sim drives it from a script.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#define BTN_QUEUE_LEN   8
+#define BTN_NO_TIMEOUT  UINT32_MAX
+
+enum ButtonEventType : uint8_t {
+    BTN_EV_CLICK = 1,
+    BTN_EV_DOUBLE,
+    BTN_EV_LONG,
+};
+
+struct ButtonEvent {
+    uint8_t type;
+    uint32_t press_ms;     // Start of the (first) press
+    uint32_t held_ms;      // Length of the last press (LONG: long_ms)
+};
+
+struct ButtonTiming {
+    uint16_t debounce_ms;
+    uint16_t click_max_ms;
+    uint16_t double_gap_ms;
+    uint16_t long_ms;
+};
+
+struct ButtonEngine {
+    ButtonTiming timing;
+
+    // Debounce
+    bool raw;              // Pressed, as of the last edge
+    bool stable;
+    uint32_t burst_ms;     // First edge since the last stable level
+    uint32_t last_edge_ms;
+    bool settling;
+
+    // Decoder
+    uint32_t press_ms;
+    bool long_fired;
+    bool click_pending;    // First click released, waiting for a second press
+    bool second_press;
+    uint32_t first_press_ms;
+    uint32_t release_ms;
+
+    // Output ring (overwrites nothing: full = dropped)
+    ButtonEvent queue[BTN_QUEUE_LEN];
+    uint8_t head, tail;
+
+    uint32_t edges;
+    uint32_t glitches;     // Bursts that settled back to the stable level
+    uint32_t dropped;
+};
+
+void btnInit(ButtonEngine* b, const ButtonTiming* timing, bool pressed);
+void btnEdge(ButtonEngine* b, uint32_t t_ms, bool pressed);
+void btnUpdate(ButtonEngine* b, uint32_t t_ms);
+uint32_t btnNextTimeout(const ButtonEngine* b, uint32_t t_ms);  // ms from t_ms, BTN_NO_TIMEOUT = none
+bool btnPop(ButtonEngine* b, ButtonEvent* ev);
+
+const char* btnEventName(uint8_t type);
@@ -0,0 +1,92 @@
+/*
+ * File: circle_clip.c
+ * Description: Round Panel Span Table Implementation
+ * Author: zzackk125
+ * License: MIT
+ */
+
+#include "circle_clip.h"
+#include <math.h>
+#include <stddef.h>
+
+// Per row pair: x1 > x2 = no visible pixel
+static int16_t span_x1[CIRCLE_MAX_H / 2];
+static int16_t span_x2[CIRCLE_MAX_H / 2];
+static int32_t pairs = 0;
+
+void circleInit(int32_t w, int32_t h, int32_t margin)
+{
+  if (h > CIRCLE_MAX_H) h = CIRCLE_MAX_H;
+  pairs = h / 2;
+  float cx = w / 2.0f, cy = h / 2.0f;
+  float r = (w < h ? w : h) / 2.0f + margin;
+
+  for (int32_t p = 0; p < pairs; p++) {
+    // The pair's row nearest the centre has the wider span
+    float dy0 = fabsf(2 * p + 0.5f - cy), dy1 = fabsf(2 * p + 1.5f - cy);
+    float dy = dy0 < dy1 ? dy0 : dy1;
+    if (dy > r) {
+      span_x1[p] = 1;
+      span_x2[p] = 0;
+      continue;
+    }
+    // Pixels whose centre is inside the disk, widened to the 2 pixel grid
+    float dx = sqrtf(r * r - dy * dy);
+    int32_t x1 = (int32_t)ceilf(cx - dx - 0.5f);
+    int32_t x2 = (int32_t)floorf(cx + dx - 0.5f);
+    if (x1 < 0) x1 = 0;
+    if (x2 > w - 1) x2 = w - 1;
+    span_x1[p] = (int16_t)(x1 & ~1);
+    span_x2[p] = (int16_t)(x2 | 1);
+  }
+}
+
+bool circleRowSpan(int32_t y, int32_t* x1, int32_t* x2)
+{
+  if (y < 0 || y / 2 >= pairs) return false;
+  int32_t p = y / 2;
+  if (span_x1[p] > span_x2[p]) return false;
+  *x1 = span_x1[p];
+  *x2 = span_x2[p];
+  return true;
+}
+
+int circleSplit(const CircleArea* a, int32_t band_rows, CircleArea* out, int max)
+{
+  int n = 0;
+  int32_t y = a->y1 < 0 ? 0 : a->y1;
+  while (y <= a->y2 && y / 2 < pairs) {
+    int32_t band_end = (y / band_rows + 1) * band_rows - 1;
+    if (band_end > a->y2) band_end = a->y2;
+
+    // Union of the trimmed spans over the band's rows
+    CircleArea b = { INT32_MAX, INT32_MAX, INT32_MIN, INT32_MIN };
+    for (int32_t row = y; row <= band_end; row++) {
+      int32_t sx1, sx2;
+      if (!circleRowSpan(row, &sx1, &sx2)) continue;
+      if (sx1 < a->x1) sx1 = a->x1;
+      if (sx2 > a->x2) sx2 = a->x2;
+      if (sx1 > sx2) continue;
+      if (sx1 < b.x1) b.x1 = sx1;
+      if (sx2 > b.x2) b.x2 = sx2;
+      if (row < b.y1) b.y1 = row;
+      b.y2 = row;
+    }
+
+    if (b.y2 >= b.y1) {
+      CircleArea* prev = n ? &out[n - 1] : NULL;
+      if (prev && prev->x1 == b.x1 && prev->x2 == b.x2 && prev->y2 + 1 == b.y1) {
+        prev->y2 = b.y2;
+      } else if (n < max) {
+        out[n++] = b;
+      } else if (prev) {
+        // Out of slots: widen the last one over the rest
+        if (b.x1 < prev->x1) prev->x1 = b.x1;
+        if (b.x2 > prev->x2) prev->x2 = b.x2;
+        prev->y2 = b.y2;
+      }
+    }
+    y = band_end + 1;
+  }
+  return n;
+}
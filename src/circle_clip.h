@@ -0,0 +1,42 @@
+/*
+ * File: circle_clip.h
+ * Description: Round Panel Span Table (Invalidate Clipping, Flush Row Groups)
+ * Author: zzackk125
+ * License: MIT
+ *
+ * The 466x466 panel shows a disk; the corners outside it (~21%) are never
+ * seen. circleInit() builds the visible x span of every row pair, rounded
+ * to the SH8601's 2 pixel grid. circleSplit() cuts an area into row bands
+ * on a fixed grid and trims each to the disk: lvgl_port.c uses it on
+ * invalidated areas (less to render) and on flush chunks (less to send).
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CIRCLE_MAX_H  480
+
+typedef struct {
+    int32_t x1, y1, x2, y2;   // Inclusive, like lv_area_t
+} CircleArea;
+
+// Disk inscribed in w x h, grown by margin pixels
+void circleInit(int32_t w, int32_t h, int32_t margin);
+
+// Visible x range of row y (its row pair). false = nothing visible
+bool circleRowSpan(int32_t y, int32_t* x1, int32_t* x2);
+
+// Split into bands of band_rows (even) rows on a grid from y = 0, each
+// trimmed to the visible part of the area. Bands with the same x range
+// are merged. Returns the count, 0 = the area is entirely outside the disk.
+int circleSplit(const CircleArea* a, int32_t band_rows, CircleArea* out, int max);
+
+#ifdef __cplusplus
+}
+#endif
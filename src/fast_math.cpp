@@ -0,0 +1,53 @@
+/*
+ * File: fast_math.cpp
+ * Description: Single Precision Math Kernels Implementation
+ * Author: zzackk125
+ * License: MIT
+ */
+
+#include "fast_math.h"
+#include <string.h>
+
+#define RAD_TO_DEG_F 57.2957795f
+
+float fastInvSqrt(float x) {
+    // Bit-level initial guess + one Newton-Raphson step, magic and step
+    // constants tuned together (Moroz et al. 2018) for 2.7x less error than
+    // 0x5f375a86 with the plain step
+    uint32_t i;
+    memcpy(&i, &x, sizeof(i));
+    i = 0x5f1ffff9 - (i >> 1);
+    float y;
+    memcpy(&y, &i, sizeof(y));
+    y = 0.703952253f * y * (2.38924456f - x * y * y);
+    return y;
+}
+
+float fastSqrt(float x) {
+    if (x <= 0.0f) return 0.0f;
+    // Second Newton step on the inverse brings it to near float precision
+    float half = 0.5f * x;
+    float y = fastInvSqrt(x);
+    y = y * (1.5f - half * y * y);
+    return x * y;
+}
+
+float fastAtan2Deg(float y, float x) {
+    float ax = (x < 0.0f) ? -x : x;
+    float ay = (y < 0.0f) ? -y : y;
+    if (ax == 0.0f && ay == 0.0f) return 0.0f;
+
+    // Reduce to z in [0, 1], then odd minimax polynomial for atan(z)
+    bool swap = ay > ax;
+    float z = swap ? (ax / ay) : (ay / ax);
+    float z2 = z * z;
+    float a = z * (0.99997726f + z2 * (-0.33262347f + z2 * (0.19354346f +
+              z2 * (-0.11643287f + z2 * (0.05265332f + z2 * -0.01172120f)))));
+
+    // Fold in degrees: 90 and 180 are exact in float, pi/2 and pi are not
+    a *= RAD_TO_DEG_F;
+    if (swap) a = 90.0f - a;
+    if (x < 0.0f) a = 180.0f - a;
+    if (y < 0.0f) a = -a;
+    return a;
+}
@@ -0,0 +1,24 @@
+/*
+ * File: fast_math.h
+ * Description: Single Precision Math Kernels for the Per-Sample Tilt Path
+ * Author: zzackk125
+ * License: MIT
+ *
+ * The ESP32-C6 has no FPU, so libm double atan2/sqrt run as soft-float.
+ * These stay in float and avoid libm entirely. Max errors below were
+ * measured against double libm over every float in the reduced range
+ * (tools/filter_bench checks them).
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+// 1/sqrt(x), one Newton step. Max relative error 6.51e-4.
+float fastInvSqrt(float x);
+
+// sqrt(x), two Newton steps. Max relative error 8.1e-7 (x >= 0).
+float fastSqrt(float x);
+
+// atan2(y, x) in degrees, full quadrant range. Max error 1.2e-4 deg.
+float fastAtan2Deg(float y, float x);
@@ -0,0 +1,144 @@
+/*
+ * File: i2c_bus.cpp
+ * Description: Shared I2C Bus Manager Implementation
+ * Author: zzackk125
+ * License: MIT
+ */
+
+#include "i2c_bus.h"
+#include "board_config.h"
+#include <atomic>
+
+// One mutex owns Wire. FreeRTOS hands a contended mutex to the highest
+// priority waiter and boosts the holder (priority inheritance), so the IMU
+// task (IMU_TASK_PRIORITY) waits for at most one in-flight transaction.
+// Lower priority devices additionally back off while a higher one is queued.
+static SemaphoreHandle_t bus_mux = NULL;
+
+static std::atomic<uint32_t> waiting[I2C_DEV_COUNT];
+static std::atomic<uint32_t> queue_depth(0);
+static uint32_t max_queue_depth = 0;
+
+// Each device is driven from a single task, so its stats have one writer
+static I2CDeviceStats dev_stats[I2C_DEV_COUNT];
+static uint32_t lock_start_us[I2C_DEV_COUNT];
+
+// Nested locks from the holder (SensorLib section wrapping register helpers)
+static TaskHandle_t holder = NULL;
+static uint32_t nest = 0;
+
+static const uint32_t dev_timeout_ms[I2C_DEV_COUNT] = {
+    I2C_IMU_TIMEOUT_MS,
+    I2C_TOUCH_TIMEOUT_MS,
+    I2C_EXPANDER_TIMEOUT_MS,
+};
+
+void i2cBusInit() {
+    if (bus_mux) return;
+    bus_mux = xSemaphoreCreateMutex();
+    Wire.begin(ESP32_SDA_NUM, ESP32_SCL_NUM);
+    Wire.setClock(I2C_BUS_CLOCK_HZ);
+    Serial.printf("I2C Bus: %d Hz\n", I2C_BUS_CLOCK_HZ);
+}
+
+static bool higherPriorityWaiting(I2CDevice dev) {
+    for (int d = 0; d < dev; d++) {
+        if (waiting[d].load(std::memory_order_relaxed)) return true;
+    }
+    return false;
+}
+
+bool i2cBusLock(I2CDevice dev, uint32_t timeout_ms) {
+    if (!bus_mux) return false;
+    if (holder == xTaskGetCurrentTaskHandle()) {
+        nest++;
+        return true;
+    }
+
+    uint32_t start = micros();
+    TickType_t t0 = xTaskGetTickCount();
+    if (timeout_ms == I2C_TIMEOUT_DEVICE) timeout_ms = dev_timeout_ms[dev];
+    bool forever = timeout_ms == I2C_WAIT_FOREVER;
+    TickType_t timeout = forever ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+
+    waiting[dev]++;
+    uint32_t depth = ++queue_depth;
+    if (depth > max_queue_depth) max_queue_depth = depth;
+
+    bool deferred = false;
+    while (higherPriorityWaiting(dev) && (forever || (xTaskGetTickCount() - t0) < timeout)) {
+        deferred = true;
+        vTaskDelay(1);
+    }
+    if (deferred) dev_stats[dev].deferred++;
+
+    TickType_t elapsed = xTaskGetTickCount() - t0;
+    TickType_t remaining = forever ? portMAX_DELAY : (elapsed < timeout) ? (timeout - elapsed) : 0;
+    bool granted = xSemaphoreTake(bus_mux, remaining) == pdTRUE;
+    waiting[dev]--;
+
+    if (!granted) {
+        queue_depth--;
+        dev_stats[dev].timeouts++;
+        return false;
+    }
+
+    uint32_t wait = micros() - start;
+    if (wait > dev_stats[dev].max_wait_us) dev_stats[dev].max_wait_us = wait;
+    lock_start_us[dev] = start;
+    holder = xTaskGetCurrentTaskHandle();
+    return true;
+}
+
+void i2cBusUnlock(I2CDevice dev, bool ok) {
+    I2CDeviceStats& s = dev_stats[dev];
+    if (nest) {
+        nest--;
+        if (!ok) s.errors++;
+        return;
+    }
+
+    uint32_t us = micros() - lock_start_us[dev];
+    s.transactions++;
+    s.total_us += us;
+    if (us > s.max_us) s.max_us = us;
+    if (!ok) s.errors++;
+
+    queue_depth--;
+    holder = NULL;
+    xSemaphoreGive(bus_mux);
+}
+
+bool i2cWriteReg(I2CDevice dev, uint8_t addr, uint8_t reg, const uint8_t* data, size_t len, uint32_t timeout_ms) {
+    if (!i2cBusLock(dev, timeout_ms)) return false;
+    Wire.beginTransmission(addr);
+    Wire.write(reg);
+    if (len) Wire.write(data, len);
+    bool ok = Wire.endTransmission() == 0;
+    i2cBusUnlock(dev, ok);
+    return ok;
+}
+
+bool i2cReadRegs(I2CDevice dev, uint8_t addr, uint8_t reg, uint8_t* buf, size_t len, uint32_t timeout_ms) {
+    if (!i2cBusLock(dev, timeout_ms)) return false;
+    bool ok = false;
+    Wire.beginTransmission(addr);
+    Wire.write(reg);
+    if (Wire.endTransmission(false) == 0 && Wire.requestFrom(addr, len) == len) {
+        for (size_t i = 0; i < len; i++) {
+            buf[i] = Wire.read();
+        }
+        ok = true;
+    }
+    i2cBusUnlock(dev, ok);
+    return ok;
+}
+
+void getI2CBusStats(I2CBusStats* out) {
+    if (!out) return;
+    out->queue_depth = queue_depth.load(std::memory_order_relaxed);
+    out->max_queue_depth = max_queue_depth;
+    for (int d = 0; d < I2C_DEV_COUNT; d++) {
+        out->devices[d] = dev_stats[d];
+    }
+}
@@ -0,0 +1,57 @@
+/*
+ * File: i2c_bus.h
+ * Description: Shared I2C Bus Manager (IMU, Touch, IO Expander)
+ * Author: zzackk125
+ * License: MIT
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <Wire.h>
+
+// Bus clients in priority order (lowest value wins).
+// A client will not start a transaction while a higher priority one is waiting.
+enum I2CDevice {
+    I2C_DEV_IMU = 0,
+    I2C_DEV_TOUCH,
+    I2C_DEV_EXPANDER,
+    I2C_DEV_COUNT
+};
+
+struct I2CDeviceStats {
+    uint32_t transactions;
+    uint32_t errors;       // NACK / short reads
+    uint32_t timeouts;     // Bus not granted within the device timeout
+    uint32_t deferred;     // Backed off for a higher priority client
+    uint64_t total_us;     // Wait + transfer
+    uint32_t max_us;
+    uint32_t max_wait_us;  // Longest time spent waiting for the bus
+};
+
+struct I2CBusStats {
+    uint32_t queue_depth;      // Clients holding or waiting for the bus right now
+    uint32_t max_queue_depth;
+    I2CDeviceStats devices[I2C_DEV_COUNT];
+};
+
+// Bus wait for i2cBusLock() and the register helpers
+#define I2C_TIMEOUT_DEVICE 0           // The device's timeout from board_config.h
+#define I2C_WAIT_FOREVER   UINT32_MAX  // Until granted (one-shot boot writes that must not be lost)
+
+void i2cBusInit(); // Wire.begin() + I2C_BUS_CLOCK_HZ. Call once before any client.
+
+// Exclusive access for code that drives Wire itself (e.g. SensorLib calls).
+// false = bus not granted within timeout_ms (still backing off for higher
+// priority devices meanwhile). The holding task may nest
+// i2cWriteReg/i2cReadRegs inside the lock.
+bool i2cBusLock(I2CDevice dev, uint32_t timeout_ms = I2C_TIMEOUT_DEVICE);
+void i2cBusUnlock(I2CDevice dev, bool ok = true);
+
+// Register transactions (lock, transfer, unlock, stats)
+bool i2cWriteReg(I2CDevice dev, uint8_t addr, uint8_t reg, const uint8_t* data, size_t len,
+                 uint32_t timeout_ms = I2C_TIMEOUT_DEVICE);
+bool i2cReadRegs(I2CDevice dev, uint8_t addr, uint8_t reg, uint8_t* buf, size_t len,
+                 uint32_t timeout_ms = I2C_TIMEOUT_DEVICE);
+
+void getI2CBusStats(I2CBusStats* out);
@@ -0,0 +1,18 @@
+#ifndef IMG_POINTER_ATLAS_H
+#define IMG_POINTER_ATLAS_H
+
+#include <lvgl.h>
+
+// Pointer pre-rotated about its pivot, which sits at pixel (FRAME / 2, FRAME / 2).
+// Range r holds frames for POINTER_ATLAS_CENTRE_r +/- k * POINTER_ATLAS_STEP.
+#define POINTER_ATLAS_FRAME   38
+#define POINTER_ATLAS_STEP    2
+#define POINTER_ATLAS_HALF    23
+#define POINTER_ATLAS_RANGE   47   // Frames per range
+#define POINTER_ATLAS_CENTRE_0 270
+#define POINTER_ATLAS_CENTRE_1 90
+
+extern const uint8_t img_pointer_atlas_map[];
+extern const lv_image_dsc_t img_pointer_atlas[94];
+
+#endif
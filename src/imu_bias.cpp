@@ -0,0 +1,88 @@
+/*
+ * File: imu_bias.cpp
+ * Description: Online Gyro Bias Estimator Implementation
+ * Author: zzackk125
+ * License: MIT
+ */
+
+#include "imu_bias.h"
+#include <string.h>
+
+// Tunings (in physical units, scaled to counts at runtime)
+#define BIAS_MAX_STD_MDPS      400   // Gyro std dev per axis while still (0.4 deg/s)
+#define BIAS_ACC_TOL_PERMILLE  50    // | |a| - 1g | < 0.05g
+#define BIAS_MAX_INITIAL_MDPS  8000  // First window: reject if |mean| > 8 deg/s (slow turn)
+#define BIAS_MAX_STEP_MDPS     2000  // Later windows: reject jumps > 2 deg/s from the estimate
+#define BIAS_BLEND_SHIFT       2     // bias += (mean - bias) / 4 (tracks temperature drift)
+
+static void resetWindow(GyroBiasEstimator* e) {
+    e->n = 0;
+    e->moving = false;
+    for (int i = 0; i < 3; i++) {
+        e->sum[i] = 0;
+        e->sum_sq[i] = 0;
+    }
+}
+
+void gyroBiasInit(GyroBiasEstimator* e) {
+    memset(e, 0, sizeof(*e));
+}
+
+void gyroBiasSeed(GyroBiasEstimator* e, const int32_t bias_q8[3]) {
+    for (int i = 0; i < 3; i++) e->bias_q8[i] = bias_q8[i];
+    e->valid = true;
+    resetWindow(e);
+}
+
+bool gyroBiasUpdate(GyroBiasEstimator* e, const int16_t acc[3], const int16_t gyr[3],
+                    int32_t acc_lsb_per_g, int32_t gyr_lsb_per_dps) {
+    // Accel magnitude band check (squared, no sqrt)
+    uint32_t mag_sq = (uint32_t)((int32_t)acc[0] * acc[0]) + (uint32_t)((int32_t)acc[1] * acc[1]) +
+                      (uint32_t)((int32_t)acc[2] * acc[2]);
+    uint32_t lo = (uint32_t)(acc_lsb_per_g * (1000 - BIAS_ACC_TOL_PERMILLE) / 1000);
+    uint32_t hi = (uint32_t)(acc_lsb_per_g * (1000 + BIAS_ACC_TOL_PERMILLE) / 1000);
+    if (mag_sq < lo * lo || mag_sq > hi * hi) e->moving = true;
+
+    for (int i = 0; i < 3; i++) {
+        e->sum[i] += gyr[i];
+        e->sum_sq[i] += (int32_t)gyr[i] * gyr[i];
+    }
+    e->n++;
+
+    if (e->n < BIAS_WINDOW_SAMPLES) return false;
+
+    bool accept = !e->moving;
+    int64_t n = e->n;
+    int64_t max_std = (int64_t)gyr_lsb_per_dps * BIAS_MAX_STD_MDPS / 1000;
+    int32_t mean_q8[3];
+
+    for (int i = 0; i < 3 && accept; i++) {
+        // n^2 * var = n * sum_sq - sum^2
+        int64_t var_n2 = n * e->sum_sq[i] - (int64_t)e->sum[i] * e->sum[i];
+        if (var_n2 > max_std * max_std * n * n) accept = false;
+
+        mean_q8[i] = (int32_t)(((int64_t)e->sum[i] * 256) / n);
+        int64_t limit_q8 = (int64_t)gyr_lsb_per_dps * 256 *
+                           (e->valid ? BIAS_MAX_STEP_MDPS : BIAS_MAX_INITIAL_MDPS) / 1000;
+        int64_t step = (int64_t)mean_q8[i] - (e->valid ? e->bias_q8[i] : 0);
+        if (step > limit_q8 || step < -limit_q8) accept = false;
+    }
+
+    resetWindow(e);
+
+    if (!accept) {
+        e->windows_rejected++;
+        return false;
+    }
+
+    for (int i = 0; i < 3; i++) {
+        if (e->valid) {
+            e->bias_q8[i] += (mean_q8[i] - e->bias_q8[i]) >> BIAS_BLEND_SHIFT;
+        } else {
+            e->bias_q8[i] = mean_q8[i]; // First still window: take it directly
+        }
+    }
+    e->valid = true;
+    e->windows_accepted++;
+    return true;
+}
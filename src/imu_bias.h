@@ -0,0 +1,40 @@
+/*
+ * File: imu_bias.h
+ * Description: Online Gyro Bias Estimator (Stationary Window Detection)
+ * Author: zzackk125
+ * License: MIT
+ *
+ * Works on raw sensor counts so both the float and fixed-point paths can
+ * feed it without conversions. A window is "stationary" when the gyro
+ * variance is low on every axis and |a| stays near 1g; its mean gyro
+ * reading then refines the bias.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#define BIAS_WINDOW_SAMPLES   448   // ~0.5s at 896.8Hz
+
+struct GyroBiasEstimator {
+    // Current window
+    uint32_t n;
+    int32_t sum[3];
+    int64_t sum_sq[3];
+    bool moving;           // Accel magnitude left the 1g band this window
+
+    // Result (counts * 256)
+    int32_t bias_q8[3];
+    bool valid;
+    uint32_t windows_accepted;
+    uint32_t windows_rejected;
+};
+
+void gyroBiasInit(GyroBiasEstimator* e);
+
+// Seed from a known bias (counts * 256), e.g. restored from NVS
+void gyroBiasSeed(GyroBiasEstimator* e, const int32_t bias_q8[3]);
+
+// Feed one raw sample. Returns true when a window closed and the bias changed.
+bool gyroBiasUpdate(GyroBiasEstimator* e, const int16_t acc[3], const int16_t gyr[3],
+                    int32_t acc_lsb_per_g, int32_t gyr_lsb_per_dps);
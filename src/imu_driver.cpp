@@ -7,6 +7,21 @@
 
 #include "imu_driver.h"
 #include "board_config.h"
+#include "imu_fusion.h"
+#include "fast_math.h"
+#include "imu_fixed.h"
+#include "imu_bias.h"
+#include "imu_tau.h"
+#include "i2c_bus.h"
+#include "imu_recorder.h"
+#include "persist.h"
+#include "boot_timeline.h"
+#include "perf_counters.h"
+#include <atomic>
+
+#if IMU_USE_FIXED_POINT && !IMU_USE_FIFO
+#error "IMU_USE_FIXED_POINT requires IMU_USE_FIFO (raw sensor counts)"
+#endif
 
 SensorQMI8658 qmi;
 IMUdata acc;
@@ -15,9 +30,7 @@ IMUdata gyr;
 float currentRoll = 0.0;
 float currentPitch = 0.0;
 
-#include <Preferences.h>
 
-Preferences prefs;
 
 float offsetRoll = 0.0;
 float offsetPitch = 0.0;
@@ -30,43 +43,542 @@ float smoothRoll = 0.0;
 float smoothPitch = 0.0;
 
 // Sensor Fusion
-int calc_mode = 0; // 0=Fusion (Default), 1=EMA
+int calc_mode = 0; // 0=Fusion (Default), 1=EMA, 2=Quaternion
 float gyroX_offset = 0.0;
 float gyroY_offset = 0.0;
 float gyroZ_offset = 0.0;
 
 // Filter Tunings
-const float TAU_NORMAL = 1.5f;       // 1.5s (Steady driving)
-const float TAU_TURNING = 10.0f;     // 10.0s (Turning - Reject lateral accel)
-const float TURN_THRESHOLD_DPS = 8.0f; // Turn detection threshold (deg/s)
+// Time constant is scheduled per sample from yaw rate and accel dynamics (imu_tau.h):
+// TAU_BASE (1.0s) driving straight, up to TAU_MAX (10s) on rough ground and
+// TAU_TURN_MAX (1000s, gyro only) cornering.
+const float MAHONY_KI = 0.0f;        // Integral off: gyro bias is removed up front
+static TauScheduler tau_sched;
+
+// Quaternion Filter (Mode 2)
+static MahonyFilter mahony;
+
+// Online Gyro Bias (replaces the blocking boot calibration)
+static GyroBiasEstimator gyro_bias;
+
+// --- Warm Start ---
+// The filter holds off until IMU_SEED_SAMPLES accel samples are averaged, then
+// seeds from the NVS snapshot if it agrees with gravity, else from the average.
+const float SEED_MATCH_DEG = 3.0f;         // Snapshot vs averaged accel tolerance
+const int32_t WS_BIAS_MAX_Q8 = 8 * 512 * 256; // Reject restored bias > 8 dps
+static bool filter_seeded = false;
+static int32_t seed_acc_sum[3] = {0, 0, 0};
+static int seed_count = 0;
+static bool ws_have_state = false;
+static float ws_roll = 0.0f;  // Raw (pre-offset) attitude from the snapshot
+static float ws_pitch = 0.0f;
+static uint32_t boot_count = 0;
+static uint32_t first_valid_ms = 0;
 
 uint32_t last_update_time = 0;
+
+// --- Sensor Time Base ---
+// dt is counted in QMI8658 samples (24-bit counter at 0x30), so task wakeup
+// jitter and micros() wrap never reach the integration.
+#define QMI_COUNTER_MASK 0xFFFFFF
+#define COUNTER_RESYNC   0xFFFFFFFFu
+static bool counter_valid = false;
+static uint32_t last_sample_counter = 0;
+static int32_t fifo_backlog = 0; // Counted by the sensor, still in the FIFO
+static uint32_t fifo_unconfirmed = 0; // Last overflow's gap, which may include a sample in flight
+static IMUTimeStats time_stats = {0};
+
+// --- Health Watchdog ---
+static uint32_t last_sample_ms = 0;
+static int16_t stuck_prev[6] = {0, 0, 0, 0, 0, 0};
+static uint32_t stuck_run = 0;
+static uint32_t err_window_start_ms = 0;
+static uint32_t err_window_base = 0;
+static bool err_burst = false;
+static uint32_t reinit_next_ms = 0;
+static uint32_t reinit_backoff_ms = IMU_REINIT_BACKOFF_MS;
+static IMUHealthStats health = {0};
 // Fusion variables (accumulators)
 float fusionRoll = 0.0;
 float fusionPitch = 0.0;
+float rateRoll = 0.0;  // Last bias corrected gyro rates (deg/s)
+float ratePitch = 0.0;
+
+// --- IMU Task & Attitude Mailbox ---
+static TaskHandle_t imu_task_handle = NULL;
+static volatile bool zero_pending = false; // zeroIMU() request, applied by the IMU task
+static IMUTaskStats task_stats = {0};
+static uint64_t jitter_sum_us = 0;
+static std::atomic<uint32_t> task_period_ms(IMU_TASK_PERIOD_MS); // setIMUTaskPeriod()
+
+// --- Park (light sleep, parkIMU) ---
+enum ParkState : uint8_t { PARK_RUN = 0, PARK_REQUESTED, PARK_PARKED, PARK_RESUME };
+static std::atomic<uint8_t> park_state(PARK_RUN);
+static uint8_t park_wom_mg = 0;
+
+// Seqlock: Odd sequence = write in progress. Readers retry until they see
+// the same even value before and after copying the slot.
+static std::atomic<uint32_t> att_seq(0);
+static IMUAttitude att_slot = {0};
+
+// --- Data-Ready Interrupt ---
+static bool imu_irq_enabled = false;
+
+#if IMU_INT_PIN >= 0
+static void IRAM_ATTR imu_int_isr() {
+    BaseType_t woken = pdFALSE;
+    if (imu_task_handle) {
+        vTaskNotifyGiveFromISR(imu_task_handle, &woken);
+    }
+    portYIELD_FROM_ISR(woken);
+}
+#endif
+
+// --- FIFO Acquisition ---
+// QMI8658 registers used directly for the FIFO burst path
+#define QMI_REG_CTRL1          0x02
+#define QMI_REG_CTRL7          0x08
+#define QMI_REG_CTRL9          0x0A
+#define QMI_REG_FIFO_WTM_TH    0x13
+#define QMI_REG_FIFO_CTRL      0x14
+#define QMI_REG_FIFO_SMPL_CNT  0x15
+#define QMI_REG_FIFO_STATUS    0x16
+#define QMI_REG_FIFO_DATA      0x17
+#define QMI_REG_STATUSINT      0x2D
+#define QMI_REG_TIMESTAMP_L    0x30        // Burst start: TS[3] TEMP[2] AX..GZ[12]
+
+#define QMI_CMD_ACK            0x00
+#define QMI_CMD_RST_FIFO       0x04
+#define QMI_CMD_REQ_FIFO       0x05
+
+#define QMI_FIFO_MODE_STREAM   0x02        // Overwrite oldest when full
+#define QMI_FIFO_SIZE_128      (0x03 << 2)
+#define QMI_FIFO_OVERFLOW      0x20        // FIFO_STATUS bit 5
+#define QMI_CMD_DONE           0x80        // STATUSINT bit 7
+
+#define QMI_CTRL1_INT2_EN      0x10
+#define QMI_CTRL1_FIFO_INT1    0x04        // FIFO_INT_SEL: 0 = INT2, 1 = INT1
+#define QMI_CTRL7_DRDY_DIS     0x20        // Keep data-ready off INT2
+
+// Wake-on-motion (parkIMU)
+#define QMI_REG_CTRL2          0x03
+#define QMI_REG_CAL1_L         0x0B        // WoM threshold (mg)
+#define QMI_REG_CAL1_H         0x0C        // WoM interrupt select + blanking
+#define QMI_REG_STATUS1        0x2F        // Read clears
+#define QMI_CMD_WRITE_WOM      0x08
+#define QMI_CTRL2_ACC_4G_LP21  0x1D        // aFS 4g, 21Hz low power ODR
+#define QMI_CTRL7_ACC_EN       0x01
+#define QMI_WOM_INT2           0x80        // CAL1_H[7:6]: INT2, initial level low
+#define QMI_WOM_BLANKING       0x04        // CAL1_H[5:0]: Samples ignored after arming
+#define QMI_STATUS1_WOM        0x04
+
+// Sensitivity for the configured ranges (ACC_RANGE_4G, GYR_RANGE_64DPS)
+#define ACC_LSB_PER_G          8192.0f
+#define GYR_LSB_PER_DPS        512.0f
+
+#define FIFO_FRAME_BYTES       12 // AX AY AZ GX GY GZ (int16, little endian)
+#define FIFO_CHUNK_FRAMES      10 // 120 bytes, fits the 128 byte Wire buffer
+
+#if IMU_USE_FIFO
+static uint8_t fifo_buf[IMU_FIFO_MAX_SAMPLES * FIFO_FRAME_BYTES];
+#endif
+static IMUFifoStats fifo_stats = {0};
+static IMUBusStats bus_stats = {0};
+
+#if !IMU_USE_FIFO
+#define QMI_SAMPLE_BYTES       17 // 0x30..0x40: TS[3] TEMP[2] AX AY AZ GX GY GZ
+
+// One decoded burst read. Everything comes from the same sample instant.
+struct QMISample {
+    uint32_t counter;  // 24-bit sample counter
+    int16_t temp;      // 1/256 degC
+    int16_t acc[3];
+    int16_t gyr[3];
+};
+#endif
+
+static void countBusTime(uint32_t start, size_t bytes, bool ok) {
+    uint32_t us = micros() - start;
+    bus_stats.transactions++;
+    bus_stats.bytes += bytes;
+    bus_stats.total_us += us;
+    if (us > bus_stats.max_us) bus_stats.max_us = us;
+    if (!ok) bus_stats.errors++;
+}
+
+// Register access goes through the shared bus manager (IMU has top priority)
+static bool qmiWriteReg(uint8_t reg, uint8_t val) {
+    uint32_t start = micros();
+    bool ok = i2cWriteReg(I2C_DEV_IMU, QMI8658_L_SLAVE_ADDRESS, reg, &val, 1);
+    countBusTime(start, 2, ok);
+    return ok;
+}
+
+static bool qmiReadRegs(uint8_t reg, uint8_t* buf, size_t len) {
+    uint32_t start = micros();
+    bool ok = i2cReadRegs(I2C_DEV_IMU, QMI8658_L_SLAVE_ADDRESS, reg, buf, len);
+    countBusTime(start, len + 1, ok);
+    return ok;
+}
+
+#if !IMU_USE_FIFO
+// Accel, gyro and sample counter in one auto-increment transaction
+// (replaces separate getAccelerometer()/getGyroscope() register reads).
+// The FIFO build reads its samples from FIFO_DATA instead.
+static bool qmiReadSample(QMISample* out) {
+    uint8_t b[QMI_SAMPLE_BYTES];
+    if (!qmiReadRegs(QMI_REG_TIMESTAMP_L, b, sizeof(b))) return false;
+
+    out->counter = (uint32_t)b[0] | ((uint32_t)b[1] << 8) | ((uint32_t)b[2] << 16);
+    out->temp = (int16_t)((uint16_t)b[3] | ((uint16_t)b[4] << 8));
+    for (int k = 0; k < 3; k++) {
+        out->acc[k] = (int16_t)((uint16_t)b[5 + 2 * k] | ((uint16_t)b[6 + 2 * k] << 8));
+        out->gyr[k] = (int16_t)((uint16_t)b[11 + 2 * k] | ((uint16_t)b[12 + 2 * k] << 8));
+    }
+    return true;
+}
+#else
+// Counter alone, read right after a FIFO drain
+static bool qmiReadCounter(uint32_t* counter) {
+    uint8_t b[3];
+    if (!qmiReadRegs(QMI_REG_TIMESTAMP_L, b, sizeof(b))) return false;
+    *counter = (uint32_t)b[0] | ((uint32_t)b[1] << 8) | ((uint32_t)b[2] << 16);
+    return true;
+}
+#endif
+
+// Samples produced since the previous counter reading (wrap safe).
+// COUNTER_RESYNC on the first reading or after an implausible jump.
+static uint32_t counterTicks(uint32_t counter) {
+    bool first = !counter_valid;
+    uint32_t ticks = (counter - last_sample_counter) & QMI_COUNTER_MASK;
+    counter_valid = true;
+    last_sample_counter = counter;
+    if (first) return COUNTER_RESYNC;
+    if (ticks > IMU_MAX_GAP_SAMPLES) {
+        time_stats.resyncs++;
+        Serial.printf("IMU Sample Counter Jumped %u: Time Base Re-anchored\n", (unsigned)ticks);
+        return COUNTER_RESYNC;
+    }
+    return ticks;
+}
+
+static void countDropped(uint32_t lost) {
+    if (lost == 0) return;
+    time_stats.dropped_samples += lost;
+    time_stats.gaps++;
+    if (lost > time_stats.max_gap_samples) time_stats.max_gap_samples = lost;
+}
+
+// CTRL9 handshake: Issue command, wait for CmdDone, acknowledge.
+// Bounded to ~2ms so a missing sensor can't stall the caller.
+static bool qmiCommand(uint8_t cmd) {
+    if (!qmiWriteReg(QMI_REG_CTRL9, cmd)) return false;
+
+    uint8_t status = 0;
+    for (int i = 0; i < 40; i++) {
+        if (qmiReadRegs(QMI_REG_STATUSINT, &status, 1) && (status & QMI_CMD_DONE)) break;
+        delayMicroseconds(50);
+    }
+    qmiWriteReg(QMI_REG_CTRL9, QMI_CMD_ACK);
+    return (status & QMI_CMD_DONE) != 0;
+}
+
+#if IMU_USE_FIFO
+static void configFIFO() {
+    // Must be set while sensors are disabled (before enableGyroscope/enableAccelerometer)
+    qmiWriteReg(QMI_REG_FIFO_WTM_TH, IMU_FIFO_WATERMARK);
+    qmiWriteReg(QMI_REG_FIFO_CTRL, QMI_FIFO_SIZE_128 | QMI_FIFO_MODE_STREAM);
+}
+
+static void resetFIFO() {
+    qmiCommand(QMI_CMD_RST_FIFO);
+}
+#endif
+
+#if IMU_INT_PIN >= 0
+// Route the FIFO watermark (or data-ready without FIFO) to INT2.
+// Call after the sensors are enabled (enable* rewrites CTRL7).
+static void configINT() {
+    uint8_t ctrl1 = 0, ctrl7 = 0;
+    if (!qmiReadRegs(QMI_REG_CTRL1, &ctrl1, 1) || !qmiReadRegs(QMI_REG_CTRL7, &ctrl7, 1)) return;
+
+    ctrl1 |= QMI_CTRL1_INT2_EN;
+    ctrl1 &= ~QMI_CTRL1_FIFO_INT1;
+#if IMU_USE_FIFO
+    ctrl7 |= QMI_CTRL7_DRDY_DIS;   // Watermark only, not every sample
+#else
+    ctrl7 &= ~QMI_CTRL7_DRDY_DIS;
+#endif
+    qmiWriteReg(QMI_REG_CTRL1, ctrl1);
+    qmiWriteReg(QMI_REG_CTRL7, ctrl7);
+}
+#endif
+
+static void fuseSample(float ax, float ay, float az, float gx_raw, float gy_raw, float gz_raw, float dt, float tau);
+
+// --- Motion Activity (power policy input) ---
+// Peaks in raw counts: gyro minus bias on the worst axis, and | |a|^2 - 1g^2 |
+// (no sqrt per sample). Merged into the shared peaks once per update.
+static uint32_t motion_gyr = 0, motion_acc_sq = 0;
+static std::atomic<uint32_t> motion_gyr_peak(0), motion_acc_sq_peak(0);
+
+static void trackMotion(const int16_t acc_counts[3], const int16_t gyr_counts[3]) {
+    for (int i = 0; i < 3; i++) {
+        int32_t g = gyr_counts[i] - (gyro_bias.valid ? (gyro_bias.bias_q8[i] >> 8) : 0);
+        uint32_t mag = (uint32_t)(g < 0 ? -g : g);
+        if (mag > motion_gyr) motion_gyr = mag;
+    }
+    const uint32_t one_g_sq = (uint32_t)ACC_LSB_PER_G * (uint32_t)ACC_LSB_PER_G;
+    uint32_t mag_sq = (uint32_t)((int32_t)acc_counts[0] * acc_counts[0]) +
+                      (uint32_t)((int32_t)acc_counts[1] * acc_counts[1]) +
+                      (uint32_t)((int32_t)acc_counts[2] * acc_counts[2]);
+    uint32_t dev = mag_sq > one_g_sq ? mag_sq - one_g_sq : one_g_sq - mag_sq;
+    if (dev > motion_acc_sq) motion_acc_sq = dev;
+}
+
+// A peak the reader clears mid-merge is only lost for one poll
+static void publishMotion() {
+    if (motion_gyr > motion_gyr_peak.load(std::memory_order_relaxed)) motion_gyr_peak.store(motion_gyr);
+    if (motion_acc_sq > motion_acc_sq_peak.load(std::memory_order_relaxed)) motion_acc_sq_peak.store(motion_acc_sq);
+    motion_gyr = 0;
+    motion_acc_sq = 0;
+}
+
+// Feed the bias estimator; offsets change only when a still window closes
+static void trackGyroBias(const int16_t acc_counts[3], const int16_t gyr_counts[3]) {
+    bool first = !gyro_bias.valid;
+    if (!gyroBiasUpdate(&gyro_bias, acc_counts, gyr_counts, (int32_t)ACC_LSB_PER_G, (int32_t)GYR_LSB_PER_DPS)) return;
+
+    const float scale = 1.0f / (256.0f * GYR_LSB_PER_DPS);
+    gyroX_offset = gyro_bias.bias_q8[0] * scale;
+    gyroY_offset = gyro_bias.bias_q8[1] * scale;
+    gyroZ_offset = gyro_bias.bias_q8[2] * scale;
+
+    if (first) {
+        Serial.printf("Gyro Bias Acquired: Xoff=%f, Yoff=%f, Zoff=%f\n", gyroX_offset, gyroY_offset, gyroZ_offset);
+    }
+}
+
+// Filter time constant for this sample (Q16 seconds), from raw counts
+static int32_t scheduleTau(const int16_t acc_counts[3], int16_t gz_counts) {
+    // (counts * 256 - bias_q8) / (256 * 512) deg/s -> mdps
+    int32_t gz_mdps = (int32_t)(((int64_t)gz_counts * 256 - gyro_bias.bias_q8[2]) * 1000 / (256 * (int32_t)GYR_LSB_PER_DPS));
+    return tauSchedUpdate(&tau_sched, acc_counts, gz_mdps, (int32_t)ACC_LSB_PER_G);
+}
+
+#if IMU_USE_FIXED_POINT
+// Q16 filter state (modes 0/1). Offsets are converted once per batch.
+static FixedFusion fixed_state = {0};
+static q16_t fixed_gyro_off[3];
+static q16_t fixed_off_roll, fixed_off_pitch;
+static q16_t fixed_ema_alpha;
+static q16_t fixed_rate_roll, fixed_rate_pitch;
+
+static void fixedBeginBatch();
+static void fuseSampleFixed(const int16_t raw[6], uint32_t dt_us, q16_t tau);
+static void fixedEndBatch();
+#endif
+
+// Restore the last converged gyro bias and attitude (see saveIMUWarmStart)
+static void loadWarmStart() {
+    boot_count = persistGetUInt(PERSIST_IMU, "boots", 0) + 1;
+    persistPutUInt(PERSIST_IMU, "boots", boot_count);
+
+    int32_t bias_q8[3];
+    if (persistGetBytes(PERSIST_IMU, "ws_bias", bias_q8, sizeof(bias_q8)) != sizeof(bias_q8)) {
+        Serial.println("Warm Start: No snapshot (cold start)");
+        return;
+    }
+    uint32_t age = boot_count - persistGetUInt(PERSIST_IMU, "ws_boot", 0);
+    if (age > IMU_WARMSTART_MAX_BOOTS) {
+        Serial.printf("Warm Start: Snapshot too old (%u boots)\n", (unsigned)age);
+        return;
+    }
+    for (int i = 0; i < 3; i++) {
+        if (bias_q8[i] > WS_BIAS_MAX_Q8 || bias_q8[i] < -WS_BIAS_MAX_Q8) {
+            Serial.println("Warm Start: Snapshot bias out of range");
+            return;
+        }
+    }
+
+    gyroBiasSeed(&gyro_bias, bias_q8);
+    const float scale = 1.0f / (256.0f * GYR_LSB_PER_DPS);
+    gyroX_offset = bias_q8[0] * scale;
+    gyroY_offset = bias_q8[1] * scale;
+    gyroZ_offset = bias_q8[2] * scale;
+
+    ws_roll = persistGetFloat(PERSIST_IMU, "ws_roll", 0.0f);
+    ws_pitch = persistGetFloat(PERSIST_IMU, "ws_pitch", 0.0f);
+    ws_have_state = true;
+    Serial.printf("Warm Start: Bias X=%f Y=%f Z=%f, Raw Roll=%f Pitch=%f (%u boots old)\n",
+                  gyroX_offset, gyroY_offset, gyroZ_offset, ws_roll, ws_pitch, (unsigned)age);
+}
+
+// Accumulate the accel seed window. Returns true once the filter is seeded.
+static bool seedFilter(const int16_t acc_counts[3]) {
+    if (filter_seeded) return true;
+
+    for (int i = 0; i < 3; i++) seed_acc_sum[i] += acc_counts[i];
+    if (++seed_count < IMU_SEED_SAMPLES) return false;
+
+    float ax = seed_acc_sum[0] / (seed_count * ACC_LSB_PER_G);
+    float ay = seed_acc_sum[1] / (seed_count * ACC_LSB_PER_G);
+    float az = seed_acc_sum[2] / (seed_count * ACC_LSB_PER_G);
+    float roll = fastAtan2Deg(ay, az);
+    float pitch = fastAtan2Deg(-ax, fastSqrt(ay * ay + az * az));
+
+    // Snapshot is the converged filter output (lateral accel rejected), but only
+    // trust it if the truck hasn't been moved/re-mounted since it was taken
+    bool from_snapshot = ws_have_state && fabsf(ws_roll - roll) < SEED_MATCH_DEG &&
+                         fabsf(ws_pitch - pitch) < SEED_MATCH_DEG;
+    if (from_snapshot) {
+        roll = ws_roll;
+        pitch = ws_pitch;
+    }
+
+    fusionRoll = smoothRoll = currentRoll = roll - offsetRoll;
+    fusionPitch = smoothPitch = currentPitch = pitch - offsetPitch;
+    mahonySeed(&mahony, ax, ay, az);
+    filter_seeded = true;
+    bootMark("imu seeded");
+
+    Serial.printf("Filter Seeded from %s: Roll=%f, Pitch=%f\n", from_snapshot ? "snapshot" : "accel", currentRoll, currentPitch);
+    return false; // Last window sample is already in the seed
+}
+
+// First angle that is both seeded and bias corrected
+static void checkFirstValid() {
+    if (first_valid_ms || !filter_seeded || !gyro_bias.valid) return;
+    first_valid_ms = millis();
+    if (first_valid_ms == 0) first_valid_ms = 1;
+    bootMark("imu valid");
+    Serial.printf("IMU Valid %lu ms after boot (%s start)\n", (unsigned long)first_valid_ms, ws_have_state ? "warm" : "cold");
+}
+
+// Per raw sample: freshness and frozen output. Returns false while stuck (don't fuse).
+static bool healthSample(const int16_t raw[6]) {
+    last_sample_ms = millis();
+    if (memcmp(raw, stuck_prev, sizeof(stuck_prev)) == 0) {
+        if (stuck_run < IMU_STUCK_SAMPLES) stuck_run++;
+    } else {
+        memcpy(stuck_prev, raw, sizeof(stuck_prev));
+        stuck_run = 0;
+    }
+    return stuck_run < IMU_STUCK_SAMPLES;
+}
+
+static bool configureSensor();
+
+// Bounded: SensorLib fails fast on a NACKing bus and the attempt is skipped if
+// the bus isn't granted within I2C_IMU_TIMEOUT_MS. Runs in the IMU task, so the
+// UI keeps drawing (the last angles, flagged degraded).
+static void reinitSensor() {
+    uint32_t start = micros();
+    bool ok = configureSensor();
+#if IMU_USE_FIFO
+    if (ok) resetFIFO();
+#endif
+    uint32_t us = micros() - start;
+
+    health.reinits++;
+    if (!ok) health.reinit_failures++;
+    if (us > health.reinit_max_us) health.reinit_max_us = us;
+
+    // New sensor timeline: counter restarts, FIFO was emptied.
+    // A stuck fault clears on the first sample that differs.
+    counter_valid = false;
+    fifo_backlog = 0;
+    fifo_unconfirmed = 0;
+    Serial.printf("IMU Re-init %s (%lu us)\n", ok ? "OK" : "Failed", (unsigned long)us);
+}
+
+// Once per update: classify, count fault onsets, re-init with backoff
+static void healthCheck() {
+    uint32_t now = millis();
+
+    if (now - err_window_start_ms >= IMU_BUS_ERROR_WINDOW_MS) {
+        uint32_t errors = bus_stats.errors - err_window_base;
+        err_burst = errors >= IMU_BUS_ERROR_MAX;
+        err_window_base = bus_stats.errors;
+        err_window_start_ms = now;
+    }
+
+    uint8_t fault = IMU_FAULT_NONE;
+    if (now - last_sample_ms > IMU_STALL_MS) fault = IMU_FAULT_STALLED;
+    else if (stuck_run >= IMU_STUCK_SAMPLES) fault = IMU_FAULT_STUCK;
+    else if (err_burst) fault = IMU_FAULT_BUS_ERRORS;
+
+    if (fault != health.fault) {
+        if (fault == IMU_FAULT_STALLED) health.stalls++;
+        else if (fault == IMU_FAULT_STUCK) health.stuck++;
+        else if (fault == IMU_FAULT_BUS_ERRORS) health.error_bursts++;
+
+        if (fault == IMU_FAULT_NONE) {
+            // Errors from the fault episode shouldn't re-trigger it
+            err_burst = false;
+            err_window_base = bus_stats.errors;
+            err_window_start_ms = now;
+            health.recoveries++;
+            Serial.println("IMU Recovered");
+        } else {
+            Serial.printf("IMU Fault: %s\n", getIMUFaultName(fault));
+            if (health.fault == IMU_FAULT_NONE) {
+                reinit_next_ms = now; // First attempt right away
+                reinit_backoff_ms = IMU_REINIT_BACKOFF_MS;
+            }
+        }
+        health.fault = fault;
+    }
+    health.ms_since_sample = now - last_sample_ms;
+
+    if (fault != IMU_FAULT_NONE && (int32_t)(now - reinit_next_ms) >= 0) {
+        reinitSensor();
+        reinit_next_ms = millis() + reinit_backoff_ms;
+        reinit_backoff_ms *= 2;
+        if (reinit_backoff_ms > IMU_REINIT_BACKOFF_MAX_MS) reinit_backoff_ms = IMU_REINIT_BACKOFF_MAX_MS;
+    }
+}
+
+// Sensor setup shared by initIMU() and the health watchdog's re-init.
+// Returns false if the sensor didn't answer (or the bus wasn't granted).
+static bool configureSensor() {
+    // SensorLib drives Wire directly: hold the bus for the whole setup sequence
+    if (!i2cBusLock(I2C_DEV_IMU)) return false;
 
-void initIMU() {
     // Initialize QMI8658
     // Address is usually 0x6B or 0x6A. Demo used QMI8658_L_SLAVE_ADDRESS which is 0x6B.
-    if (!qmi.begin(Wire, QMI8658_L_SLAVE_ADDRESS, ESP32_SDA_NUM, ESP32_SCL_NUM)) {
-        Serial.println("Failed to find QMI8658 - check your wiring!");
-    } else {
-        Serial.println("QMI8658 Found!");
+    bool found = qmi.begin(Wire, QMI8658_L_SLAVE_ADDRESS, ESP32_SDA_NUM, ESP32_SCL_NUM);
+    Wire.setClock(I2C_BUS_CLOCK_HZ); // begin() may re-init the bus at its default clock
+    if (!found) {
+        i2cBusUnlock(I2C_DEV_IMU, false);
+        return false;
     }
 
     // Configure (from demo)
     qmi.configAccelerometer(SensorQMI8658::ACC_RANGE_4G, SensorQMI8658::ACC_ODR_1000Hz, SensorQMI8658::LPF_MODE_0);
     qmi.configGyroscope(SensorQMI8658::GYR_RANGE_64DPS, SensorQMI8658::GYR_ODR_896_8Hz, SensorQMI8658::LPF_MODE_3);
+#if IMU_USE_FIFO
+    configFIFO();
+#endif
     qmi.enableGyroscope();
     qmi.enableAccelerometer();
-    
+#if IMU_INT_PIN >= 0
+    configINT();
+#endif
+    i2cBusUnlock(I2C_DEV_IMU);
+    return true;
+}
+
+// Settings and the warm start snapshot from NVS. Runs in setup() before the
+// task starts, so initUI() / initWebServer() read the stored values.
+static void loadIMUSettings() {
     // Load Offsets
-    prefs.begin("imu", false); // Namespace "imu", read-only false
-    offsetRoll = prefs.getFloat("roll_off", 0.0);
-    offsetPitch = prefs.getFloat("pitch_off", 0.0);
+    offsetRoll = persistGetFloat(PERSIST_IMU, "roll_off", 0.0);
+    offsetPitch = persistGetFloat(PERSIST_IMU, "pitch_off", 0.0);
     
     // Load Smoothing
-    smoothing_percent = prefs.getInt("smooth", 100); // Default 100 (Instant)
+    smoothing_percent = persistGetInt(PERSIST_IMU, "smooth", 100); // Default 100 (Instant)
     if(smoothing_percent < 1) smoothing_percent = 1;
     if(smoothing_percent > 100) smoothing_percent = 100;
     
@@ -76,116 +588,405 @@ void initIMU() {
     smoothing_alpha = (float)smoothing_percent / 100.0;
     
     // Load Calculation Mode
-    calc_mode = prefs.getInt("mode", 0); // Default 0 (Fusion)
+    calc_mode = persistGetInt(PERSIST_IMU, "mode", 0); // Default 0 (Fusion)
+    if (calc_mode < 0 || calc_mode > 2) calc_mode = 0;
+    mahonyInit(&mahony, MAHONY_KI);
+    tauSchedInit(&tau_sched);
     
     Serial.printf("Loaded Offsets: Roll=%f, Pitch=%f, Smooth=%d%%, Mode=%d\n", offsetRoll, offsetPitch, smoothing_percent, calc_mode);
 
-    // Calibrate Gyro (Quick Sample)
-    Serial.println("Calibrating Gyro (Do not move)...");
-    float sumX = 0, sumY = 0, sumZ = 0;
-    int samples = 100;
-    for(int i=0; i<samples; i++) {
-        if(qmi.getDataReady()) {
-            if(qmi.getGyroscope(gyr.x, gyr.y, gyr.z)) {
-                sumX += gyr.x;
-                sumY += gyr.y;
-                sumZ += gyr.z;
-            }
-        }
-        delay(3);
+    // Gyro bias is estimated online from stationary windows (no boot wait)
+    gyroBiasInit(&gyro_bias);
+    loadWarmStart();
+}
+
+// Sensor bring-up (the IMU task, overlapped with the display init)
+static void initIMUSensor() {
+    if (!configureSensor()) {
+        Serial.println("Failed to find QMI8658 - check your wiring!");
+    } else {
+        Serial.println("QMI8658 Found!");
     }
-    gyroX_offset = sumX / samples;
-    gyroY_offset = sumY / samples;
-    gyroZ_offset = sumZ / samples;
-    Serial.printf("Gyro Calibrated: Xoff=%f, Yoff=%f, Zoff=%f\n", gyroX_offset, gyroY_offset, gyroZ_offset);
-    
+
+#if IMU_USE_FIFO
+    // Discard samples queued during setup (stale timestamps)
+    resetFIFO();
+#endif
     last_update_time = micros();
+    last_sample_ms = millis();
+    err_window_start_ms = last_sample_ms;
+}
+
+void initIMU() {
+    loadIMUSettings();
+    initIMUSensor();
+}
+
+#if IMU_USE_FIFO
+// Drain the whole hardware FIFO in one burst and fuse every sample.
+// Samples are timestamped backwards from the drain time at the sensor period.
+static void drainFIFO() {
+    uint32_t batch_start = micros();
+
+    uint8_t status = 0;
+    if (!qmiReadRegs(QMI_REG_FIFO_STATUS, &status, 1)) return;
+    bool overflow = (status & QMI_FIFO_OVERFLOW) != 0;
+    if (overflow) fifo_stats.overflows++;
+
+    if (!qmiCommand(QMI_CMD_REQ_FIFO)) return;
+
+    // Count is in 16-bit words: 3 words per sensor, 2 sensors per frame
+    uint8_t cnt[2];
+    int frames = 0;
+    if (qmiReadRegs(QMI_REG_FIFO_SMPL_CNT, cnt, 2)) {
+        uint16_t words = ((uint16_t)(cnt[1] & 0x03) << 8) | cnt[0];
+        frames = words / 6;
+        if (frames > IMU_FIFO_MAX_SAMPLES) frames = IMU_FIFO_MAX_SAMPLES;
+    }
+
+    int read_frames = 0;
+    while (read_frames < frames) {
+        int chunk = frames - read_frames;
+        if (chunk > FIFO_CHUNK_FRAMES) chunk = FIFO_CHUNK_FRAMES;
+        if (!qmiReadRegs(QMI_REG_FIFO_DATA, &fifo_buf[read_frames * FIFO_FRAME_BYTES], chunk * FIFO_FRAME_BYTES)) break;
+        read_frames += chunk;
+    }
+
+    // Leave FIFO read mode (clears FIFO_RD_MODE)
+    qmiWriteReg(QMI_REG_FIFO_CTRL, QMI_FIFO_SIZE_128 | QMI_FIFO_MODE_STREAM);
+
+    // Newest sample number, to place this batch on the sensor time base
+    uint32_t counter = 0;
+    bool have_counter = qmiReadCounter(&counter);
+
+    if (read_frames == 0) return;
+
+    // Samples the sensor produced that never reached us were overwritten
+    // before this batch (stream mode drops the oldest), so the gap sits
+    // in front of the first frame.
+    uint32_t ticks = have_counter ? counterTicks(counter) : COUNTER_RESYNC;
+    uint32_t lost = 0;
+    if (ticks == COUNTER_RESYNC) {
+        fifo_backlog = 0;
+        fifo_unconfirmed = 0;
+        time_stats.sensor_time_us += (uint64_t)read_frames * IMU_SAMPLE_PERIOD_US;
+    } else {
+        // A sample landing between the FIFO latch and the counter read is
+        // counted now and drained next time: a backlog of 1 is normal.
+        // After an overflow the gap is all counted as lost; if one of those
+        // samples was only in flight it turns up now and is taken back.
+        fifo_backlog += (int32_t)ticks - read_frames;
+        if (fifo_backlog < 0 && fifo_unconfirmed) {
+            time_stats.dropped_samples--;
+            if (time_stats.max_gap_samples == fifo_unconfirmed) time_stats.max_gap_samples--;
+        }
+        fifo_unconfirmed = 0;
+        if (fifo_backlog < 0) fifo_backlog = 0;
+        int32_t keep = overflow ? 0 : 1;
+        if (fifo_backlog > keep) {
+            lost = fifo_backlog - keep;
+            fifo_backlog = keep;
+            if (overflow) fifo_unconfirmed = lost;
+        }
+        time_stats.sensor_time_us += (uint64_t)ticks * IMU_SAMPLE_PERIOD_US;
+    }
+    countDropped(lost);
+
+    uint32_t t_newest = micros();
+    recorderBatch(t_newest, (uint16_t)read_frames, (overflow ? IMU_LOG_BATCH_OVERFLOW : 0) |
+                  (have_counter ? IMU_LOG_BATCH_COUNTER : 0), counter);
+#if IMU_USE_FIXED_POINT
+    bool use_fixed = (calc_mode != 2);
+    if (use_fixed) fixedBeginBatch();
+#endif
+    for (int i = 0; i < read_frames; i++) {
+        const uint8_t* f = &fifo_buf[i * FIFO_FRAME_BYTES];
+        int16_t raw[6];
+        for (int k = 0; k < 6; k++) {
+            raw[k] = (int16_t)((uint16_t)f[2 * k] | ((uint16_t)f[2 * k + 1] << 8));
+        }
+        recorderSample(raw);
+        if (!healthSample(raw)) continue;
+
+        // micros() only timestamps the mailbox; dt is in whole sensor samples
+        last_update_time = t_newest - (uint32_t)(read_frames - 1 - i) * IMU_SAMPLE_PERIOD_US;
+        int32_t delta_us = IMU_SAMPLE_PERIOD_US * (int32_t)(i == 0 ? 1 + lost : 1);
+
+        trackMotion(&raw[0], &raw[3]);
+        trackGyroBias(&raw[0], &raw[3]);
+        int32_t tau_q16 = scheduleTau(&raw[0], raw[5]);
+        if (!seedFilter(&raw[0])) {
+#if IMU_USE_FIXED_POINT
+            if (use_fixed && filter_seeded) fixedBeginBatch(); // Pick up the seed
+#endif
+            continue;
+        }
+
+#if IMU_USE_FIXED_POINT
+        if (use_fixed) {
+            fuseSampleFixed(raw, (uint32_t)delta_us, tau_q16);
+            continue;
+        }
+#endif
+        acc.x = raw[0] / ACC_LSB_PER_G;
+        acc.y = raw[1] / ACC_LSB_PER_G;
+        acc.z = raw[2] / ACC_LSB_PER_G;
+        gyr.x = raw[3] / GYR_LSB_PER_DPS;
+        gyr.y = raw[4] / GYR_LSB_PER_DPS;
+        gyr.z = raw[5] / GYR_LSB_PER_DPS;
+
+        fuseSample(acc.x, acc.y, acc.z, gyr.x, gyr.y, gyr.z, delta_us / 1000000.0f, Q16_TO_FLOAT(tau_q16));
+    }
+#if IMU_USE_FIXED_POINT
+    if (use_fixed && filter_seeded) fixedEndBatch();
+#endif
+    checkFirstValid();
+
+    uint32_t batch_us = micros() - batch_start;
+    fifo_stats.batches++;
+    fifo_stats.samples += read_frames;
+    fifo_stats.last_batch_samples = read_frames;
+    fifo_stats.last_batch_us = batch_us;
+    if (batch_us > fifo_stats.max_batch_us) fifo_stats.max_batch_us = batch_us;
+}
+#endif
+
+// known_ready: Woken by the data-ready interrupt, skip the status poll
+static void readSample(bool known_ready) {
+#if IMU_USE_FIFO
+    drainFIFO();
+#else
+    QMISample smp;
+    bool ready = known_ready;
+    if (!ready && i2cBusLock(I2C_DEV_IMU)) {
+        ready = qmi.getDataReady();
+        i2cBusUnlock(I2C_DEV_IMU);
+    }
+    if (ready && qmiReadSample(&smp)) {
+        // Calculate dt from the sensor counter (micros() only timestamps the mailbox)
+        uint32_t ticks = counterTicks(smp.counter);
+        if (ticks == 0) return; // Same sample as last time (data-ready raced the read)
+        if (ticks == COUNTER_RESYNC) ticks = 1;
+        else countDropped(ticks - 1);
+        time_stats.sensor_time_us += (uint64_t)ticks * IMU_SAMPLE_PERIOD_US;
+        float dt = ticks * (IMU_SAMPLE_PERIOD_US / 1000000.0f); // Seconds
+        uint32_t now = micros();
+        last_update_time = now;
+
+        int16_t raw[6] = { smp.acc[0], smp.acc[1], smp.acc[2], smp.gyr[0], smp.gyr[1], smp.gyr[2] };
+        recorderBatch(now, 1, IMU_LOG_BATCH_COUNTER, smp.counter);
+        recorderSample(raw);
+        if (!healthSample(raw)) return;
+
+        acc.x = smp.acc[0] / ACC_LSB_PER_G;
+        acc.y = smp.acc[1] / ACC_LSB_PER_G;
+        acc.z = smp.acc[2] / ACC_LSB_PER_G;
+        gyr.x = smp.gyr[0] / GYR_LSB_PER_DPS;
+        gyr.y = smp.gyr[1] / GYR_LSB_PER_DPS;
+        gyr.z = smp.gyr[2] / GYR_LSB_PER_DPS;
+
+        trackMotion(smp.acc, smp.gyr);
+        trackGyroBias(smp.acc, smp.gyr);
+        int32_t tau_q16 = scheduleTau(smp.acc, smp.gyr[2]);
+        if (seedFilter(smp.acc)) {
+            fuseSample(acc.x, acc.y, acc.z, gyr.x, gyr.y, gyr.z, dt, Q16_TO_FLOAT(tau_q16));
+        }
+        checkFirstValid();
+    }
+#endif
 }
 
 void updateIMU() {
-    if (qmi.getDataReady()) {
-        if (qmi.getAccelerometer(acc.x, acc.y, acc.z)) {
-            // Calculate Roll and Pitch (Simple Trig)
-            float rawRoll = atan2(acc.y, acc.z) * 180.0 / PI;
-            float rawPitch = atan2(-acc.x, sqrt(acc.y * acc.y + acc.z * acc.z)) * 180.0 / PI;
-            
-            float targetRoll = rawRoll - offsetRoll;
-            float targetPitch = rawPitch - offsetPitch;
-            
-            // Calculate dt
-            uint32_t now = micros();
-            float dt = (now - last_update_time) / 1000000.0; // Seconds
-            last_update_time = now;
-            
-            // --- MODE 0: SENSOR FUSION (Complementary Filter) ---
-            if (calc_mode == 0) {
-                 // Get Gyro data (Degrees Per Second)
-                 qmi.getGyroscope(gyr.x, gyr.y, gyr.z);
-                 
-                 // Apply offsets
-                 float gx = gyr.x - gyroX_offset;
-                 float gy = gyr.y - gyroY_offset;
-                 float gz = gyr.z - gyroZ_offset;
-                 
-                 // Smart Time Constant Logic
-                 // If we are turning (high Yaw rate), the accelerometer reads lateral force as gravity (roll).
-                 // In this case, we rely HEAVILY on the gyro (High Time Constant).
-                 // If driving straight, we use a normal time constant to correct gyro drift.
-                 float tau = TAU_NORMAL;
-                 if (abs(gz) > TURN_THRESHOLD_DPS) {
-                      tau = TAU_TURNING;
-                 }
-                 
-                 // Calculate Alpha based on actual dt
-                 // alpha = tau / (tau + dt)
-                 float alpha = tau / (tau + dt);
-                 
-                 // Use previous FUSED value for integration
-                 // Check for NaN or first run
-                 if(fusionRoll == 0.0 && fusionPitch == 0.0 && targetRoll != 0) {
-                     fusionRoll = targetRoll; // Seed with accel
-                     fusionPitch = targetPitch;
-                 }
-
-                 fusionRoll = alpha * (fusionRoll + gx * dt) + (1.0 - alpha) * targetRoll;
-                 // Pitch is often inverted on gyro depending on mounting, checking simple addition first
-                 fusionPitch = alpha * (fusionPitch + gy * dt) + (1.0 - alpha) * targetPitch;
-                 
-                 smoothRoll = fusionRoll;
-                 smoothPitch = fusionPitch;
-                 
-            } 
-            // --- MODE 1: EMA (Original) ---
-            else {
-                // current = alpha * target + (1-alpha) * current
-                if (smoothing_alpha >= 0.99) {
-                     smoothRoll = targetRoll;
-                     smoothPitch = targetPitch;
-                } else {
-                     smoothRoll = (smoothing_alpha * targetRoll) + ((1.0 - smoothing_alpha) * smoothRoll);
-                     smoothPitch = (smoothing_alpha * targetPitch) + ((1.0 - smoothing_alpha) * smoothPitch);
-                }
-                
-                // Keep fusion synced so if we switch modes it doesn't jump
-                fusionRoll = smoothRoll;
-                fusionPitch = smoothPitch;
-            }
-            
-            currentRoll = smoothRoll;
-            currentPitch = smoothPitch;
+    readSample(false);
+    publishMotion();
+    healthCheck();
+}
+
+// One filter step for a single accel/gyro pair (g, deg/s) spaced dt seconds apart.
+// tau: Scheduled accel time constant (s) for this sample.
+static void fuseSample(float ax, float ay, float az, float gx_raw, float gy_raw, float gz_raw, float dt, float tau) {
+    // Calculate Roll and Pitch (Simple Trig)
+    // Float kernels (fast_math.h): libm double runs as soft-float on the C6
+    float rawRoll = fastAtan2Deg(ay, az);
+    float rawPitch = fastAtan2Deg(-ax, fastSqrt(ay * ay + az * az));
+    
+    float targetRoll = rawRoll - offsetRoll;
+    float targetPitch = rawPitch - offsetPitch;
+    
+    // --- MODE 0: SENSOR FUSION (Complementary Filter) ---
+    if (calc_mode == 0) {
+         // Apply offsets
+         float gx = gx_raw - gyroX_offset;
+         float gy = gy_raw - gyroY_offset;
+         rateRoll = gx;
+         ratePitch = gy;
+         
+         // Smart Time Constant Logic
+         // When turning or bouncing, the accelerometer reads lateral force / bumps as gravity.
+         // tau rises smoothly with yaw rate and accel dynamics, so we rely on the gyro there.
+         // Driving straight, the short base tau corrects gyro drift with little lag.
+         
+         // Calculate Alpha based on actual dt
+         // alpha = tau / (tau + dt)
+         float alpha = tau / (tau + dt);
+         
+         // Use previous FUSED value for integration (seeded by seedFilter())
+         fusionRoll = alpha * (fusionRoll + gx * dt) + (1.0f - alpha) * targetRoll;
+         // Pitch is often inverted on gyro depending on mounting, checking simple addition first
+         fusionPitch = alpha * (fusionPitch + gy * dt) + (1.0f - alpha) * targetPitch;
+         
+         smoothRoll = fusionRoll;
+         smoothPitch = fusionPitch;
+         
+    } 
+    // --- MODE 2: QUATERNION (Mahony) ---
+    // Full 3D attitude, so roll and pitch stay decoupled when both are large.
+    else if (calc_mode == 2) {
+         float gx = gx_raw - gyroX_offset;
+         float gy = gy_raw - gyroY_offset;
+         float gz = gz_raw - gyroZ_offset;
+         rateRoll = gx;
+         ratePitch = gy;
+
+         if (!mahony.seeded) {
+             mahonySeed(&mahony, ax, ay, az);
+         }
+
+         // Same turn / bump rejection as Mode 0: accel gain ~ 1/tau
+         mahonyUpdate(&mahony, gx, gy, gz, ax, ay, az, 1.0f / tau, dt);
+
+         float qRoll, qPitch;
+         mahonyGetRollPitch(&mahony, &qRoll, &qPitch);
+         smoothRoll = qRoll - offsetRoll;
+         smoothPitch = qPitch - offsetPitch;
+
+         // Keep fusion synced so if we switch modes it doesn't jump
+         fusionRoll = smoothRoll;
+         fusionPitch = smoothPitch;
+    }
+    // --- MODE 1: EMA (Original) ---
+    else {
+        // current = alpha * target + (1-alpha) * current
+        if (smoothing_alpha >= 0.99f) {
+             smoothRoll = targetRoll;
+             smoothPitch = targetPitch;
+        } else {
+             smoothRoll = (smoothing_alpha * targetRoll) + ((1.0f - smoothing_alpha) * smoothRoll);
+             smoothPitch = (smoothing_alpha * targetPitch) + ((1.0f - smoothing_alpha) * smoothPitch);
         }
+        
+        // Keep fusion synced so if we switch modes it doesn't jump
+        fusionRoll = smoothRoll;
+        fusionPitch = smoothPitch;
     }
+    
+    currentRoll = smoothRoll;
+    currentPitch = smoothPitch;
 }
 
-float getRoll() {
-    return currentRoll;
+#if IMU_USE_FIXED_POINT
+// GYR_RANGE_64DPS: 512 LSB/dps -> Q16 dps is an exact shift (x128)
+#define GYRO_COUNTS_TO_Q16 128
+
+// Float -> Q16 conversions happen here once per batch, not per sample
+static void fixedBeginBatch() {
+    fixed_gyro_off[0] = Q16_FROM_FLOAT(gyroX_offset);
+    fixed_gyro_off[1] = Q16_FROM_FLOAT(gyroY_offset);
+    fixed_gyro_off[2] = Q16_FROM_FLOAT(gyroZ_offset);
+    fixed_off_roll = Q16_FROM_FLOAT(offsetRoll);
+    fixed_off_pitch = Q16_FROM_FLOAT(offsetPitch);
+    fixed_ema_alpha = (q16_t)(smoothing_percent * Q16_ONE / 100);
+
+    // Pick up zeroing / mode switches made on the float side
+    fixed_state.roll = Q16_FROM_FLOAT(fusionRoll);
+    fixed_state.pitch = Q16_FROM_FLOAT(fusionPitch);
+    fixed_state.smooth_roll = Q16_FROM_FLOAT(smoothRoll);
+    fixed_state.smooth_pitch = Q16_FROM_FLOAT(smoothPitch);
 }
 
-float getPitch() {
-    return currentPitch;
+// Integer-only equivalent of fuseSample() for modes 0/1
+static void fuseSampleFixed(const int16_t raw[6], uint32_t dt_us, q16_t tau) {
+    q16_t rawRoll, rawPitch;
+    fixedTilt(raw[0], raw[1], raw[2], &rawRoll, &rawPitch);
+
+    q16_t targetRoll = q16SatAdd(rawRoll, -fixed_off_roll);
+    q16_t targetPitch = q16SatAdd(rawPitch, -fixed_off_pitch);
+
+    if (calc_mode == 0) {
+        q16_t gx = q16SatAdd((q16_t)raw[3] * GYRO_COUNTS_TO_Q16, -fixed_gyro_off[0]);
+        q16_t gy = q16SatAdd((q16_t)raw[4] * GYRO_COUNTS_TO_Q16, -fixed_gyro_off[1]);
+        fixed_rate_roll = gx;
+        fixed_rate_pitch = gy;
+
+        fixed_state.roll = fixedComplementary(fixed_state.roll, gx, targetRoll, tau, dt_us);
+        fixed_state.pitch = fixedComplementary(fixed_state.pitch, gy, targetPitch, tau, dt_us);
+        fixed_state.smooth_roll = fixed_state.roll;
+        fixed_state.smooth_pitch = fixed_state.pitch;
+    } else {
+        if (fixed_ema_alpha >= Q16_FROM_FLOAT(0.99f)) {
+            fixed_state.smooth_roll = targetRoll;
+            fixed_state.smooth_pitch = targetPitch;
+        } else {
+            fixed_state.smooth_roll = fixedEma(fixed_state.smooth_roll, targetRoll, fixed_ema_alpha);
+            fixed_state.smooth_pitch = fixedEma(fixed_state.smooth_pitch, targetPitch, fixed_ema_alpha);
+        }
+        // Keep fusion synced so if we switch modes it doesn't jump
+        fixed_state.roll = fixed_state.smooth_roll;
+        fixed_state.pitch = fixed_state.smooth_pitch;
+    }
 }
 
-void zeroIMU() {
+// Back to float once per batch for the mailbox / other modes
+static void fixedEndBatch() {
+    fusionRoll = Q16_TO_FLOAT(fixed_state.roll);
+    fusionPitch = Q16_TO_FLOAT(fixed_state.pitch);
+    smoothRoll = Q16_TO_FLOAT(fixed_state.smooth_roll);
+    smoothPitch = Q16_TO_FLOAT(fixed_state.smooth_pitch);
+    rateRoll = Q16_TO_FLOAT(fixed_rate_roll);
+    ratePitch = Q16_TO_FLOAT(fixed_rate_pitch);
+    currentRoll = smoothRoll;
+    currentPitch = smoothPitch;
+}
+#endif
+
+static void publishAttitude() {
+    uint32_t seq = att_seq.load(std::memory_order_relaxed);
+    att_seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    att_slot.roll = currentRoll;
+    att_slot.pitch = currentPitch;
+    att_slot.roll_rate = rateRoll;
+    att_slot.pitch_rate = ratePitch;
+    att_slot.timestamp_us = last_update_time;
+    att_slot.publish_us = micros();
+    att_slot.degraded = (health.fault != IMU_FAULT_NONE);
+
+    std::atomic_thread_fence(std::memory_order_release);
+    att_seq.store(seq + 2, std::memory_order_release);
+}
+
+bool readIMUAttitude(IMUAttitude* out) {
+    if (!out) return false;
+    // Writer is higher priority and never blocks mid-write, so a retry
+    // after being preempted always lands on a complete snapshot.
+    for (int tries = 0; tries < 4; tries++) {
+        uint32_t seq_start = att_seq.load(std::memory_order_acquire);
+        if (seq_start & 1) continue;
+
+        IMUAttitude copy = att_slot;
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (att_seq.load(std::memory_order_relaxed) == seq_start) {
+            *out = copy;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Called from the IMU task only (owner of currentRoll/offsetRoll)
+static void applyZero() {
     // Capture current raw values as offsets
     // We need to reconstruct raw from current + offset
     offsetRoll += currentRoll;
@@ -199,12 +1000,286 @@ void zeroIMU() {
     // Reset current to 0 immediately for visual feedback
     currentRoll = 0;
     currentPitch = 0;
+
+    ImuLogEvent ev = {0};
+    ev.type = IMU_LOG_EV_ZERO;
+    recorderEvent(&ev); // New offsets follow via logConfigEvents()
+}
+
+// Recorder: Current config at start, then every change (IMU task only)
+static void logConfigEvents() {
+    static int last_mode = -1;
+    static int last_smooth = -1;
+    static float last_off_roll = 0.0f, last_off_pitch = 0.0f;
+    static int32_t last_bias[3] = {0, 0, 0};
+
+    bool all = recorderNeedsState();
+    if (!all && !isRecording()) return;
+
+    ImuLogEvent ev = {0};
+    if (all) {
+        // Filter state so a replay can warm start like the device did
+        ev.type = IMU_LOG_EV_ATTITUDE;
+        ev.f[0] = fusionRoll + offsetRoll;
+        ev.f[1] = fusionPitch + offsetPitch;
+        recorderEvent(&ev);
+    }
+    if (all || calc_mode != last_mode) {
+        ev.type = IMU_LOG_EV_MODE;
+        ev.u8 = (uint8_t)calc_mode;
+        recorderEvent(&ev);
+        last_mode = calc_mode;
+    }
+    if (all || smoothing_percent != last_smooth) {
+        ev.type = IMU_LOG_EV_SMOOTHING;
+        ev.u8 = (uint8_t)smoothing_percent;
+        recorderEvent(&ev);
+        last_smooth = smoothing_percent;
+    }
+    if (all || offsetRoll != last_off_roll || offsetPitch != last_off_pitch) {
+        ev.type = IMU_LOG_EV_OFFSETS;
+        ev.f[0] = last_off_roll = offsetRoll;
+        ev.f[1] = last_off_pitch = offsetPitch;
+        recorderEvent(&ev);
+    }
+    if (gyro_bias.valid && (all || memcmp(last_bias, gyro_bias.bias_q8, sizeof(last_bias)) != 0)) {
+        ev.type = IMU_LOG_EV_BIAS;
+        memcpy(ev.bias_q8, gyro_bias.bias_q8, sizeof(ev.bias_q8));
+        memcpy(last_bias, gyro_bias.bias_q8, sizeof(last_bias));
+        recorderEvent(&ev);
+    }
+}
+
+// Sensors off, then accel only at a low power ODR with wake-on-motion armed
+static void armWakeOnMotion(uint8_t mg) {
+    qmiWriteReg(QMI_REG_CTRL7, 0x00);
+    qmiWriteReg(QMI_REG_CTRL2, QMI_CTRL2_ACC_4G_LP21);
+    qmiWriteReg(QMI_REG_CAL1_L, mg);
+    qmiWriteReg(QMI_REG_CAL1_H, QMI_WOM_INT2 | QMI_WOM_BLANKING);
+    qmiCommand(QMI_CMD_WRITE_WOM);
+    qmiWriteReg(QMI_REG_CTRL7, QMI_CTRL7_ACC_EN);
+    uint8_t status;
+    qmiReadRegs(QMI_REG_STATUS1, &status, 1); // Drop a stale latch
+}
+
+// Threshold 0 disables WoM; then the normal setup, as after a re-init
+static void resumeFromPark() {
+    qmiWriteReg(QMI_REG_CTRL7, 0x00);
+    qmiWriteReg(QMI_REG_CAL1_L, 0);
+    qmiWriteReg(QMI_REG_CAL1_H, 0);
+    qmiCommand(QMI_CMD_WRITE_WOM);
+    bool ok = configureSensor();
+#if IMU_USE_FIFO
+    if (ok) resetFIFO();
+#endif
+    if (!ok) Serial.println("IMU Resume Failed (watchdog will retry)");
+
+    // The gap is not a fault: new time base, fresh health windows
+    uint32_t now = millis();
+    counter_valid = false;
+    fifo_backlog = 0;
+    fifo_unconfirmed = 0;
+    last_sample_ms = now;
+    err_window_start_ms = now;
+    err_window_base = bus_stats.errors;
+    last_update_time = micros();
+}
+
+// IMU task: park when asked, block until unparkIMU()
+static void servicePark() {
+    armWakeOnMotion(park_wom_mg);
+    park_state.store(PARK_PARKED);
+    while (park_state.load() != PARK_RESUME) ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    resumeFromPark();
+    park_state.store(PARK_RUN);
+}
+
+static void imu_task(void* arg) {
+    // Sensor bring-up runs here, overlapped with the display init in setup()
+    initIMUSensor();
+    bootMark("imu ready");
+
+    TickType_t last_wake = xTaskGetTickCount();
+    uint32_t last_start = micros();
+
+    for (;;) {
+        uint32_t period_ms = task_period_ms.load();
+        bool woken_by_irq = false;
+        if (imu_irq_enabled) {
+            // Sleep until the sensor has data (FIFO watermark / data-ready)
+            woken_by_irq = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(IMU_INT_TIMEOUT_MS)) > 0;
+            if (woken_by_irq) task_stats.irq_wakeups++;
+            else task_stats.timeout_wakeups++;
+        } else {
+            vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(period_ms));
+        }
+
+        uint32_t start = micros();
+        if (!imu_irq_enabled) {
+            // Wakeup jitter: deviation of the measured period from nominal
+            uint32_t period = start - last_start;
+            uint32_t period_us = period_ms * 1000;
+            uint32_t jitter = (period > period_us) ? (period - period_us) : (period_us - period);
+            jitter_sum_us += jitter;
+            task_stats.jitter_avg_us = (uint32_t)(jitter_sum_us / (task_stats.cycles + 1));
+            if (jitter > task_stats.jitter_max_us) task_stats.jitter_max_us = jitter;
+        }
+        last_start = start;
+
+        if (park_state.load() == PARK_REQUESTED) {
+            servicePark();
+            last_wake = xTaskGetTickCount();
+            last_start = micros();
+            continue;
+        }
+
+        uint32_t perf = perfBegin();
+        if (zero_pending) {
+            applyZero();
+            zero_pending = false;
+        }
+        logConfigEvents();
+
+        readSample(woken_by_irq);
+        publishMotion();
+        healthCheck();
+        publishAttitude();
+        perfEnd(PERF_IMU_UPDATE, perf);
+
+        uint32_t busy = micros() - start;
+        task_stats.cycles++;
+        if (busy > task_stats.update_max_us) task_stats.update_max_us = busy;
+    }
+}
+
+void startIMUTask() {
+    if (imu_task_handle) return;
+    loadIMUSettings(); // Before anyone reads them (UI, web server): only NVS, no bus traffic
+    publishAttitude(); // Valid (zeroed) snapshot until the task has initialised the sensor
+    xTaskCreate(imu_task, "IMU", IMU_TASK_STACK_SIZE, NULL, IMU_TASK_PRIORITY, &imu_task_handle);
+
+#if IMU_INT_PIN >= 0
+    // Attach after the task exists so the ISR always has someone to notify
+    pinMode(IMU_INT_PIN, INPUT);
+    attachInterrupt(digitalPinToInterrupt(IMU_INT_PIN), imu_int_isr, RISING);
+    imu_irq_enabled = true;
+    Serial.printf("IMU Interrupt on GPIO %d\n", IMU_INT_PIN);
+#endif
+}
+
+void readIMUMotion(IMUMotion* out) {
+    if (!out) return;
+    out->gyro_mdps = (uint32_t)((uint64_t)motion_gyr_peak.exchange(0) * 1000 / (uint32_t)GYR_LSB_PER_DPS);
+    // | |a|^2 - g^2 | ~= 2g * | |a| - g | near 1g
+    uint32_t dev_counts = motion_acc_sq_peak.exchange(0) / (2 * (uint32_t)ACC_LSB_PER_G);
+    out->acc_mg = (uint32_t)((uint64_t)dev_counts * 1000 / (uint32_t)ACC_LSB_PER_G);
+}
+
+void setIMUTaskPeriod(uint32_t ms) {
+#if IMU_USE_FIFO
+    if (ms == 0) ms = IMU_TASK_PERIOD_MS;
+    task_period_ms.store(ms);
+#else
+    (void)ms; // Polling needs every sample: stays at IMU_TASK_PERIOD_MS
+#endif
+}
+
+bool parkIMU(uint8_t wom_mg, uint32_t timeout_ms) {
+    if (!imu_task_handle || park_state.load() != PARK_RUN) return false;
+    park_wom_mg = wom_mg;
+    park_state.store(PARK_REQUESTED);
+    xTaskNotifyGive(imu_task_handle); // Interrupt mode: don't wait for the next watermark
+
+    uint32_t start = millis();
+    while (park_state.load() != PARK_PARKED) {
+        if (millis() - start >= timeout_ms) {
+            // Not taken yet: withdraw (the task may still be about to take it)
+            uint8_t expected = PARK_REQUESTED;
+            if (park_state.compare_exchange_strong(expected, PARK_RUN)) return false;
+        }
+        delay(1);
+    }
+    return true;
+}
+
+bool pollIMUWakeOnMotion() {
+    uint8_t status = 0;
+    return qmiReadRegs(QMI_REG_STATUS1, &status, 1) && (status & QMI_STATUS1_WOM);
+}
+
+void unparkIMU() {
+    if (park_state.load() != PARK_PARKED) return;
+    park_state.store(PARK_RESUME);
+    xTaskNotifyGive(imu_task_handle);
+}
+
+void getIMUTaskStats(IMUTaskStats* out) {
+    if (out) *out = task_stats;
+}
+
+// Snapshot accessors for callers outside the IMU task
+float getRoll() {
+    static IMUAttitude last = {0};
+    readIMUAttitude(&last); // Keeps the previous value on a failed read
+    return last.roll;
+}
+
+float getPitch() {
+    static IMUAttitude last = {0};
+    readIMUAttitude(&last);
+    return last.pitch;
+}
+
+void zeroIMU() {
+    if (imu_task_handle) {
+        // Applied by the IMU task before its next update
+        zero_pending = true;
+    } else {
+        applyZero();
+    }
 }
 
 void saveIMUOffsets() {
-    prefs.putFloat("roll_off", offsetRoll);
-    prefs.putFloat("pitch_off", offsetPitch);
-    Serial.println("Offsets Saved to NVS (Background)");
+    persistPutFloat(PERSIST_IMU, "roll_off", offsetRoll);
+    persistPutFloat(PERSIST_IMU, "pitch_off", offsetPitch);
+    Serial.println("Offsets Queued for NVS (Background)");
+    saveIMUWarmStart();
+}
+
+void saveIMUWarmStart() {
+    if (!filter_seeded || !gyro_bias.valid) return;
+
+    // Word-sized reads of IMU task state; a bias blend landing mid-copy
+    // only mixes two nearly identical estimates.
+    int32_t bias_q8[3] = { gyro_bias.bias_q8[0], gyro_bias.bias_q8[1], gyro_bias.bias_q8[2] };
+    IMUAttitude att;
+    if (!readIMUAttitude(&att)) return;
+    float raw_roll = att.roll + offsetRoll;
+    float raw_pitch = att.pitch + offsetPitch;
+
+    // Skip the flash write if nothing moved since the last snapshot
+    static int32_t last_bias[3] = {0, 0, 0};
+    static float last_roll = 0.0f, last_pitch = 0.0f;
+    static bool saved_once = false;
+    if (saved_once && memcmp(bias_q8, last_bias, sizeof(bias_q8)) == 0 &&
+        fabsf(raw_roll - last_roll) < 0.5f && fabsf(raw_pitch - last_pitch) < 0.5f) {
+        return;
+    }
+
+    persistPutBytes(PERSIST_IMU, "ws_bias", bias_q8, sizeof(bias_q8));
+    persistPutFloat(PERSIST_IMU, "ws_roll", raw_roll);
+    persistPutFloat(PERSIST_IMU, "ws_pitch", raw_pitch);
+    persistPutUInt(PERSIST_IMU, "ws_boot", boot_count);
+
+    memcpy(last_bias, bias_q8, sizeof(bias_q8));
+    last_roll = raw_roll;
+    last_pitch = raw_pitch;
+    saved_once = true;
+    Serial.println("Warm Start Snapshot Queued for NVS");
+}
+
+uint32_t getIMUTimeToValidMs() {
+    return first_valid_ms;
 }
 
 void setSmoothing(int percent) {
@@ -214,7 +1289,7 @@ void setSmoothing(int percent) {
     smoothing_percent = percent;
     smoothing_alpha = (float)smoothing_percent / 100.0;
     
-    prefs.putInt("smooth", smoothing_percent);
+    persistPutInt(PERSIST_IMU, "smooth", smoothing_percent);
 }
 
 int getSmoothing() {
@@ -223,12 +1298,39 @@ int getSmoothing() {
 
 void setCalculationMode(int mode) {
     if (mode < 0) mode = 0;
-    if (mode > 1) mode = 1;
+    if (mode > 2) mode = 2;
+    if (mode == 2 && calc_mode != 2) mahony.seeded = false; // Re-seed from accel on entry
     calc_mode = mode;
-    prefs.putInt("mode", calc_mode);
+    persistPutInt(PERSIST_IMU, "mode", calc_mode);
     Serial.printf("Calculation Mode Set to: %d\n", calc_mode);
 }
 
 int getCalculationMode() {
     return calc_mode;
 }
+
+void getIMUFifoStats(IMUFifoStats* out) {
+    if (out) *out = fifo_stats;
+}
+
+void getIMUHealthStats(IMUHealthStats* out) {
+    if (out) *out = health;
+}
+
+const char* getIMUFaultName(uint8_t fault) {
+    switch (fault) {
+        case IMU_FAULT_NONE:       return "OK";
+        case IMU_FAULT_STALLED:    return "Stalled";
+        case IMU_FAULT_STUCK:      return "Stuck";
+        case IMU_FAULT_BUS_ERRORS: return "Bus Errors";
+        default:                   return "Unknown";
+    }
+}
+
+void getIMUTimeStats(IMUTimeStats* out) {
+    if (out) *out = time_stats;
+}
+
+void getIMUBusStats(IMUBusStats* out) {
+    if (out) *out = bus_stats;
+}
@@ -11,14 +11,110 @@
 #include <Wire.h>
 #include "SensorQMI8658.hpp"
 
-void initIMU();
+void initIMU();      // Settings, then the sensor (host tools; the firmware uses startIMUTask())
+void startIMUTask(); // Settings here, then sensor init and updateIMU() at IMU_TASK_PERIOD_MS in its own task
 void updateIMU();
 float getRoll();
 float getPitch();
 void zeroIMU(); // Updates RAM offsets only
-void saveIMUOffsets(); // Explicitly save to NVS
+void saveIMUOffsets(); // Explicitly save to NVS (includes the warm start snapshot)
+void saveIMUWarmStart(); // Gyro bias + attitude snapshot, call from a non-critical context
+uint32_t getIMUTimeToValidMs(); // millis() at the first valid angle, 0 = not yet
 void setSmoothing(int percent); // 0-100
 int getSmoothing();
 
-void setCalculationMode(int mode); // 0=Fusion (Default), 1=EMA
-int getCalculationMode(); // 0=Fusion, 1=EMA
+void setCalculationMode(int mode); // 0=Fusion (Default), 1=EMA, 2=Quaternion
+int getCalculationMode(); // 0=Fusion, 1=EMA, 2=Quaternion
+
+// FIFO Acquisition Stats (IMU_USE_FIFO)
+struct IMUFifoStats {
+    uint32_t batches;
+    uint32_t samples;            // Total samples fused
+    uint32_t overflows;          // Drains that found the FIFO overflowed (samples lost)
+    uint32_t last_batch_samples;
+    uint32_t last_batch_us;      // Drain + fusion time of the last batch
+    uint32_t max_batch_us;
+};
+void getIMUFifoStats(IMUFifoStats* out);
+
+// Sensor Time Base (QMI8658 24-bit sample counter)
+// Integration dt is counted in sensor samples, not measured with micros().
+struct IMUTimeStats {
+    uint64_t sensor_time_us;   // Monotonic: samples produced since boot * IMU_SAMPLE_PERIOD_US
+    uint32_t dropped_samples;  // Produced by the sensor but never fused (FIFO overflow, missed polls)
+    uint32_t gaps;             // Updates that found dropped samples
+    uint32_t max_gap_samples;
+    uint32_t resyncs;          // Counter jumps > IMU_MAX_GAP_SAMPLES (sensor reset): re-anchored
+};
+void getIMUTimeStats(IMUTimeStats* out);
+
+// Health Watchdog (stalled / frozen sensor, I2C error bursts -> re-init with backoff)
+enum IMUFault : uint8_t {
+    IMU_FAULT_NONE = 0,
+    IMU_FAULT_STALLED,     // No sample for IMU_STALL_MS
+    IMU_FAULT_STUCK,       // IMU_STUCK_SAMPLES identical frames
+    IMU_FAULT_BUS_ERRORS,  // IMU_BUS_ERROR_MAX errors in a window
+};
+struct IMUHealthStats {
+    uint8_t fault;            // IMUFault, NONE when healthy
+    uint32_t ms_since_sample;
+    uint32_t stalls;          // Fault onsets by cause
+    uint32_t stuck;
+    uint32_t error_bursts;
+    uint32_t reinits;         // Re-init attempts
+    uint32_t reinit_failures;
+    uint32_t reinit_max_us;
+    uint32_t recoveries;
+};
+void getIMUHealthStats(IMUHealthStats* out);
+const char* getIMUFaultName(uint8_t fault);
+
+// Direct register traffic to the QMI8658 (FIFO drain / burst sample reads)
+struct IMUBusStats {
+    uint32_t transactions;
+    uint32_t bytes;      // Register address + payload
+    uint32_t errors;     // NACK / short reads
+    uint64_t total_us;   // Time spent on the bus, including waits
+    uint32_t max_us;
+};
+void getIMUBusStats(IMUBusStats* out);
+
+// Attitude snapshot published by the IMU task (Seqlock, single producer)
+struct IMUAttitude {
+    float roll;            // Degrees (offset applied)
+    float pitch;
+    float roll_rate;       // Degrees/s (bias corrected gyro)
+    float pitch_rate;
+    uint32_t timestamp_us; // micros() of the newest fused sample
+    uint32_t publish_us;   // micros() when this snapshot was published
+    bool degraded;         // Health watchdog: sensor faulted, angles are stale
+};
+bool readIMUAttitude(IMUAttitude* out); // Lock-free, never blocks. false = no consistent copy
+
+// IMU Task Timing (Wakeup jitter vs IMU_TASK_PERIOD_MS)
+struct IMUTaskStats {
+    uint32_t cycles;
+    uint32_t jitter_avg_us;  // Timed wakeups only
+    uint32_t jitter_max_us;
+    uint32_t update_max_us;  // Longest updateIMU() call
+    uint32_t irq_wakeups;    // Woken by the INT pin (IMU_INT_PIN)
+    uint32_t timeout_wakeups;// Woken by IMU_INT_TIMEOUT_MS with no interrupt
+};
+void getIMUTaskStats(IMUTaskStats* out);
+
+// Motion since the previous call (power policy input): peaks, best effort
+struct IMUMotion {
+    uint32_t gyro_mdps;      // Bias corrected, worst axis
+    uint32_t acc_mg;         // | |a| - 1g |
+};
+void readIMUMotion(IMUMotion* out);
+
+// Timed wakeups of the IMU task (FIFO builds: the FIFO holds ~140ms).
+// The sensor ODR stays put, so dt and the bias estimator are unaffected.
+void setIMUTaskPeriod(uint32_t ms);
+
+// Light sleep: the IMU task arms the QMI8658 wake-on-motion (accel only,
+// low power ODR) and stops sampling until unparkIMU(). false = not parked.
+bool parkIMU(uint8_t wom_mg, uint32_t timeout_ms);
+bool pollIMUWakeOnMotion(); // While parked: motion latched since the last poll
+void unparkIMU();
@@ -0,0 +1,123 @@
+/*
+ * File: imu_fixed.cpp
+ * Description: Q16.16 Fixed-Point Tilt & Complementary Filter Implementation
+ * Author: zzackk125
+ * License: MIT
+ */
+
+#include "imu_fixed.h"
+
+#define Q16_MAX  INT32_MAX
+#define Q16_MIN  INT32_MIN
+
+// 180/PI in Q16 applied to a Q30 radian result: (rad_q30 * RAD2DEG_Q16) >> 30
+#define RAD2DEG_Q16  3754936 // 57.29578 * 65536
+
+static q16_t q16Sat(int64_t v) {
+    if (v > Q16_MAX) return Q16_MAX;
+    if (v < Q16_MIN) return Q16_MIN;
+    return (q16_t)v;
+}
+
+q16_t q16SatAdd(q16_t a, q16_t b) {
+    return q16Sat((int64_t)a + b);
+}
+
+q16_t q16Mul(q16_t a, q16_t b) {
+    // Round to nearest: truncation biases small corrections toward -inf
+    return q16Sat(((int64_t)a * b + (1 << 15)) >> 16);
+}
+
+uint32_t isqrt32(uint32_t v) {
+    uint32_t res = 0;
+    uint32_t bit = 1UL << 30;
+    while (bit > v) bit >>= 2;
+    while (bit) {
+        if (v >= res + bit) {
+            v -= res + bit;
+            res = (res >> 1) + bit;
+        } else {
+            res >>= 1;
+        }
+        bit >>= 2;
+    }
+    return res;
+}
+
+q16_t q16Atan2Deg(int32_t y, int32_t x) {
+    uint32_t ax = (x < 0) ? (uint32_t)(-(int64_t)x) : (uint32_t)x;
+    uint32_t ay = (y < 0) ? (uint32_t)(-(int64_t)y) : (uint32_t)y;
+    if (ax == 0 && ay == 0) return 0;
+
+    // Reduce to z = small/large in [0, 1] as Q30
+    bool swap = ay > ax;
+    uint32_t num = swap ? ax : ay;
+    uint32_t den = swap ? ay : ax;
+    int64_t z = (int64_t)(((uint64_t)num << 30) / den);
+    int64_t z2 = (z * z) >> 30;
+
+    // Same odd minimax polynomial as fastAtan2Deg, coefficients in Q30
+    int64_t p = -12585543;                          // -0.01172120
+    p = 56536072 + ((p * z2) >> 30);                //  0.05265332
+    p = -125018842 + ((p * z2) >> 30);              // -0.11643287
+    p = 207815708 + ((p * z2) >> 30);               //  0.19354346
+    p = -357151731 + ((p * z2) >> 30);              // -0.33262347
+    p = 1073717407 + ((p * z2) >> 30);              //  0.99997726
+    int64_t a = (p * z) >> 30;                      // atan(z), Q30 rad
+
+    const int64_t HALF_PI_Q30 = 1686629713;
+    const int64_t PI_Q30 = 3373259426LL;
+    if (swap) a = HALF_PI_Q30 - a;
+    if (x < 0) a = PI_Q30 - a;
+    if (y < 0) a = -a;
+
+    return (q16_t)((a * RAD2DEG_Q16) >> 30);
+}
+
+void fixedTilt(int16_t ax, int16_t ay, int16_t az, q16_t* roll, q16_t* pitch) {
+    // sqrt(ay^2 + az^2) with 6 fraction bits: the integer root alone is off
+    // by up to a count (~0.007 deg of pitch at 1g). One Newton step on the
+    // remainder supplies the fraction; atan2 takes any common scale.
+    uint32_t v = (uint32_t)((int32_t)ay * ay) + (uint32_t)((int32_t)az * az);
+    uint32_t r = isqrt32(v);
+    uint32_t yz = r << 6;
+    if (r) yz += ((v - r * r) << 6) / (2 * r);
+    *roll = q16Atan2Deg(ay, az);
+    *pitch = q16Atan2Deg(-(int32_t)ax * 64, (int32_t)yz);
+}
+
+q16_t q16DtFromMicros(uint32_t dt_us) {
+    if (dt_us > 250000) dt_us = 250000;
+    // 65536 / 1e6 ~= 4295 / 65536 (8e-6 relative error), fits in 32 bits
+    return (q16_t)((dt_us * 4295UL) >> 16);
+}
+
+q16_t fixedComplementary(q16_t state, q16_t rate, q16_t target, q16_t tau, uint32_t dt_us) {
+    if (dt_us > 250000) dt_us = 250000;
+
+    // Gyro prediction. Integrate on microseconds: a Q16 dt (15us/LSB)
+    // would bias the angle by up to 0.1% of every rotation.
+    // rate * dt_us / 1e6 == (rate * dt_us * 4295) >> 32
+    q16_t predicted = q16SatAdd(state, q16Sat(((int64_t)rate * dt_us * 4295 + (1LL << 31)) >> 32));
+
+    // Accel correction weight (1 - alpha) = dt / (tau + dt), Q30.
+    // Q16 is too coarse here (~49 LSB at 1ms/1.5s). The 64-bit divide is
+    // cached: tau holds steady at TAU_BASE while the accel is fully trusted.
+    static uint32_t cached_dt_us = 0;
+    static q16_t cached_tau = 0;
+    static int64_t beta = 0;
+    if (dt_us != cached_dt_us || tau != cached_tau) {
+        uint64_t tau_us = ((uint64_t)tau * 1000000ULL) >> 16;
+        beta = (int64_t)(((uint64_t)dt_us << 30) / (tau_us + dt_us));
+        cached_dt_us = dt_us;
+        cached_tau = tau;
+    }
+
+    q16_t error = q16Sat((int64_t)target - predicted);
+    return q16SatAdd(predicted, q16Sat((error * beta + (1 << 29)) >> 30));
+}
+
+q16_t fixedEma(q16_t state, q16_t target, q16_t alpha) {
+    q16_t error = q16Sat((int64_t)target - state);
+    return q16SatAdd(state, q16Mul(alpha, error));
+}
@@ -0,0 +1,45 @@
+/*
+ * File: imu_fixed.h
+ * Description: Q16.16 Fixed-Point Tilt & Complementary Filter (IMU_USE_FIXED_POINT)
+ * Author: zzackk125
+ * License: MIT
+ *
+ * Integer-only counterpart of the float filter step in imu_driver.cpp.
+ * Angles and rates are Q16.16 degrees (deg/s). All adds saturate.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+typedef int32_t q16_t;
+
+#define Q16_ONE             65536
+#define Q16_FROM_FLOAT(f)   ((q16_t)((f) * 65536.0f))
+#define Q16_TO_FLOAT(q)     ((float)(q) * (1.0f / 65536.0f))
+
+struct FixedFusion {
+    q16_t roll;          // Complementary filter state
+    q16_t pitch;
+    q16_t smooth_roll;   // EMA state
+    q16_t smooth_pitch;
+};
+
+q16_t q16SatAdd(q16_t a, q16_t b);
+q16_t q16Mul(q16_t a, q16_t b);
+uint32_t isqrt32(uint32_t v);
+
+// atan2 of raw counts (any scale), Q16 degrees. Max error 1.2e-4 deg.
+q16_t q16Atan2Deg(int32_t y, int32_t x);
+
+// Accel counts -> roll/pitch (Q16 deg), same convention as the float path
+void fixedTilt(int16_t ax, int16_t ay, int16_t az, q16_t* roll, q16_t* pitch);
+
+// dt in microseconds -> Q16 seconds (saturates at 0.25s)
+q16_t q16DtFromMicros(uint32_t dt_us);
+
+// state = (state + rate*dt) + dt/(tau+dt) * (target - (state + rate*dt))
+q16_t fixedComplementary(q16_t state, q16_t rate, q16_t target, q16_t tau, uint32_t dt_us);
+
+// state += alpha * (target - state)
+q16_t fixedEma(q16_t state, q16_t target, q16_t alpha);
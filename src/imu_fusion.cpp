@@ -0,0 +1,110 @@
+/*
+ * File: imu_fusion.cpp
+ * Description: Quaternion Attitude Filter (Mahony) Implementation
+ * Author: zzackk125
+ * License: MIT
+ */
+
+#include "imu_fusion.h"
+#include "fast_math.h"
+#include <math.h>
+
+#define DEG_TO_RAD_F 0.0174532925f
+
+void mahonyInit(MahonyFilter* f, float ki) {
+    f->q0 = 1.0f;
+    f->q1 = f->q2 = f->q3 = 0.0f;
+    f->ix = f->iy = f->iz = 0.0f;
+    f->ki = ki;
+    f->seeded = false;
+}
+
+void mahonySeed(MahonyFilter* f, float ax, float ay, float az) {
+    // Zero yaw, roll/pitch from gravity (same convention as the accel tilt)
+    float roll = atan2f(ay, az);
+    float pitch = atan2f(-ax, sqrtf(ay * ay + az * az));
+
+    float cr = cosf(roll * 0.5f), sr = sinf(roll * 0.5f);
+    float cp = cosf(pitch * 0.5f), sp = sinf(pitch * 0.5f);
+    f->q0 = cr * cp;
+    f->q1 = sr * cp;
+    f->q2 = cr * sp;
+    f->q3 = -sr * sp;
+    f->ix = f->iy = f->iz = 0.0f;
+    f->seeded = true;
+}
+
+void mahonyUpdate(MahonyFilter* f, float gx, float gy, float gz,
+                  float ax, float ay, float az, float kp, float dt) {
+    float q0 = f->q0, q1 = f->q1, q2 = f->q2, q3 = f->q3;
+
+    gx *= DEG_TO_RAD_F;
+    gy *= DEG_TO_RAD_F;
+    gz *= DEG_TO_RAD_F;
+
+    // Accel correction (skipped in free fall / bad reading)
+    float norm_sq = ax * ax + ay * ay + az * az;
+    if (norm_sq > 1e-6f) {
+        float recip = fastInvSqrt(norm_sq);
+        ax *= recip;
+        ay *= recip;
+        az *= recip;
+
+        // Gravity direction predicted by the current attitude (|q| ~= 1)
+        float vx = 2.0f * (q1 * q3 - q0 * q2);
+        float vy = 2.0f * (q0 * q1 + q2 * q3);
+        float vz = q0 * q0 - q1 * q1 - q2 * q2 + q3 * q3;
+
+        // Error = measured x predicted
+        float ex = ay * vz - az * vy;
+        float ey = az * vx - ax * vz;
+        float ez = ax * vy - ay * vx;
+
+        if (f->ki > 0.0f) {
+            f->ix += f->ki * ex * dt;
+            f->iy += f->ki * ey * dt;
+            f->iz += f->ki * ez * dt;
+            gx += f->ix;
+            gy += f->iy;
+            gz += f->iz;
+        }
+
+        gx += kp * ex;
+        gy += kp * ey;
+        gz += kp * ez;
+    }
+
+    // Integrate q' = 0.5 * q x omega
+    float h = 0.5f * dt;
+    gx *= h;
+    gy *= h;
+    gz *= h;
+    f->q0 = q0 + (-q1 * gx - q2 * gy - q3 * gz);
+    f->q1 = q1 + (q0 * gx + q2 * gz - q3 * gy);
+    f->q2 = q2 + (q0 * gy - q1 * gz + q3 * gx);
+    f->q3 = q3 + (q0 * gz + q1 * gy - q2 * gx);
+
+    // Second Newton step: one alone leaves |q| up to 6.5e-4 off 1 after every
+    // update, a standing scale error rather than noise
+    float norm_sq_q = f->q0 * f->q0 + f->q1 * f->q1 + f->q2 * f->q2 + f->q3 * f->q3;
+    float recip = fastInvSqrt(norm_sq_q);
+    recip = recip * (1.5f - 0.5f * norm_sq_q * recip * recip);
+    f->q0 *= recip;
+    f->q1 *= recip;
+    f->q2 *= recip;
+    f->q3 *= recip;
+}
+
+void mahonyGetRollPitch(const MahonyFilter* f, float* roll_deg, float* pitch_deg) {
+    float q0 = f->q0, q1 = f->q1, q2 = f->q2, q3 = f->q3;
+
+    // Scale invariant forms: |q| is 1 to ~1e-6 after mahonyUpdate(), but a
+    // seed or a restored state need not be
+    float norm_sq = q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3;
+    float sinp = 2.0f * (q0 * q2 - q1 * q3) / norm_sq;
+    if (sinp > 1.0f) sinp = 1.0f;
+    if (sinp < -1.0f) sinp = -1.0f;
+
+    if (roll_deg) *roll_deg = fastAtan2Deg(2.0f * (q0 * q1 + q2 * q3), q0 * q0 - q1 * q1 - q2 * q2 + q3 * q3);
+    if (pitch_deg) *pitch_deg = fastAtan2Deg(sinp, fastSqrt(1.0f - sinp * sinp)); // asin
+}
@@ -0,0 +1,27 @@
+/*
+ * File: imu_fusion.h
+ * Description: Quaternion Attitude Filter (Mahony) - No Arduino dependencies
+ * Author: zzackk125
+ * License: MIT
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+struct MahonyFilter {
+    float q0, q1, q2, q3;     // Attitude quaternion (sensor -> earth)
+    float ix, iy, iz;         // Integral feedback (gyro bias estimate, rad/s)
+    float ki;                 // Integral gain
+    bool seeded;
+};
+
+void mahonyInit(MahonyFilter* f, float ki);
+void mahonySeed(MahonyFilter* f, float ax, float ay, float az); // Level from a gravity vector
+
+// Gyro in deg/s (bias removed), accel in any unit (normalized internally).
+// kp is the proportional accel gain (1/s); ~1/tau of the complementary filter.
+void mahonyUpdate(MahonyFilter* f, float gx, float gy, float gz,
+                  float ax, float ay, float az, float kp, float dt);
+
+void mahonyGetRollPitch(const MahonyFilter* f, float* roll_deg, float* pitch_deg);
@@ -0,0 +1,233 @@
+/*
+ * File: imu_log.cpp
+ * Description: Compact Binary IMU Recording Format Implementation
+ * Author: zzackk125
+ * License: MIT
+ */
+
+#include "imu_log.h"
+#include <string.h>
+
+// --- Primitives ---
+static size_t putVarint(uint8_t* out, uint32_t v) {
+    size_t n = 0;
+    while (v >= 0x80) {
+        out[n++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    out[n++] = (uint8_t)v;
+    return n;
+}
+
+static size_t getVarint(const uint8_t* in, size_t len, uint32_t* v) {
+    uint32_t result = 0;
+    for (size_t n = 0; n < len && n < 5; n++) {
+        result |= (uint32_t)(in[n] & 0x7F) << (7 * n);
+        if (!(in[n] & 0x80)) {
+            *v = result;
+            return n + 1;
+        }
+    }
+    return 0;
+}
+
+static uint32_t zigzag(int32_t v) {
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static int32_t unzigzag(uint32_t v) {
+    return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+static void put16(uint8_t* out, uint16_t v) {
+    out[0] = (uint8_t)v;
+    out[1] = (uint8_t)(v >> 8);
+}
+
+static void put32(uint8_t* out, uint32_t v) {
+    for (int i = 0; i < 4; i++) out[i] = (uint8_t)(v >> (8 * i));
+}
+
+static uint16_t get16(const uint8_t* in) {
+    return (uint16_t)(in[0] | (in[1] << 8));
+}
+
+static uint32_t get32(const uint8_t* in) {
+    return (uint32_t)in[0] | ((uint32_t)in[1] << 8) | ((uint32_t)in[2] << 16) | ((uint32_t)in[3] << 24);
+}
+
+// --- Header ---
+void imuLogCodecInit(ImuLogCodec* c, uint32_t start_us) {
+    memset(c, 0, sizeof(*c));
+    c->last_t_us = start_us;
+}
+
+size_t imuLogWriteHeader(uint8_t* out, const ImuLogHeader* h) {
+    memcpy(out, IMU_LOG_MAGIC, 4);
+    out[4] = IMU_LOG_VERSION;
+    out[5] = IMU_LOG_HEADER_BYTES;
+    out[6] = h->flags;
+    out[7] = 0;
+    put16(&out[8], h->sample_period_us);
+    put16(&out[10], h->acc_lsb_per_g);
+    put16(&out[12], h->gyr_lsb_per_dps);
+    put16(&out[14], 0);
+    put32(&out[16], h->start_us);
+    return IMU_LOG_HEADER_BYTES;
+}
+
+size_t imuLogReadHeader(const uint8_t* in, size_t len, ImuLogHeader* h) {
+    if (len < IMU_LOG_HEADER_BYTES || memcmp(in, IMU_LOG_MAGIC, 4) != 0) return 0;
+    if (in[4] != IMU_LOG_VERSION) return 0;
+
+    // Later versions may grow the header; honour its declared size
+    size_t header_bytes = in[5];
+    if (header_bytes < IMU_LOG_HEADER_BYTES || header_bytes > len) return 0;
+
+    h->version = in[4];
+    h->flags = in[6];
+    h->sample_period_us = get16(&in[8]);
+    h->acc_lsb_per_g = get16(&in[10]);
+    h->gyr_lsb_per_dps = get16(&in[12]);
+    h->start_us = get32(&in[16]);
+    return header_bytes;
+}
+
+// --- Encode ---
+size_t imuLogEncodeBatch(ImuLogCodec* c, uint8_t* out, const ImuLogBatch* b) {
+    uint8_t flags = b->flags & ~IMU_LOG_BATCH_KEY;
+    if (c->batches % IMU_LOG_KEY_INTERVAL == 0) flags |= IMU_LOG_BATCH_KEY;
+
+    size_t n = 0;
+    out[n++] = IMU_LOG_TAG_BATCH;
+    n += putVarint(&out[n], b->t_us - c->last_t_us);
+    n += putVarint(&out[n], b->n);
+    out[n++] = flags;
+    if (flags & IMU_LOG_BATCH_COUNTER) {
+        n += putVarint(&out[n], zigzag((int32_t)(b->counter - c->last_counter)));
+        c->last_counter = b->counter;
+    }
+    if (flags & IMU_LOG_BATCH_KEY) memset(c->prev, 0, sizeof(c->prev));
+
+    c->last_t_us = b->t_us;
+    c->batches++;
+    return n;
+}
+
+size_t imuLogEncodeSample(ImuLogCodec* c, uint8_t* out, const int16_t raw[6]) {
+    size_t n = 0;
+    for (int k = 0; k < 6; k++) {
+        n += putVarint(&out[n], zigzag((int32_t)raw[k] - c->prev[k]));
+        c->prev[k] = raw[k];
+    }
+    return n;
+}
+
+size_t imuLogEncodeEvent(uint8_t* out, const ImuLogEvent* ev) {
+    size_t n = 0;
+    out[n++] = IMU_LOG_TAG_EVENT;
+    out[n++] = ev->type;
+    switch (ev->type) {
+        case IMU_LOG_EV_MODE:
+        case IMU_LOG_EV_SMOOTHING:
+            out[n++] = ev->u8;
+            break;
+        case IMU_LOG_EV_OFFSETS:
+        case IMU_LOG_EV_ATTITUDE:
+            for (int i = 0; i < 2; i++) {
+                uint32_t bits;
+                memcpy(&bits, &ev->f[i], 4);
+                put32(&out[n], bits);
+                n += 4;
+            }
+            break;
+        case IMU_LOG_EV_BIAS:
+            for (int i = 0; i < 3; i++) {
+                put32(&out[n], (uint32_t)ev->bias_q8[i]);
+                n += 4;
+            }
+            break;
+        default:
+            break;
+    }
+    return n;
+}
+
+// --- Decode ---
+static size_t decodeEvent(const uint8_t* in, size_t len, ImuLogEvent* ev) {
+    if (len < 1) return 0;
+    memset(ev, 0, sizeof(*ev));
+    ev->type = in[0];
+    switch (ev->type) {
+        case IMU_LOG_EV_MODE:
+        case IMU_LOG_EV_SMOOTHING:
+            if (len < 2) return 0;
+            ev->u8 = in[1];
+            return 2;
+        case IMU_LOG_EV_OFFSETS:
+        case IMU_LOG_EV_ATTITUDE:
+            if (len < 9) return 0;
+            for (int i = 0; i < 2; i++) {
+                uint32_t bits = get32(&in[1 + 4 * i]);
+                memcpy(&ev->f[i], &bits, 4);
+            }
+            return 9;
+        case IMU_LOG_EV_BIAS:
+            if (len < 13) return 0;
+            for (int i = 0; i < 3; i++) ev->bias_q8[i] = (int32_t)get32(&in[1 + 4 * i]);
+            return 13;
+        case IMU_LOG_EV_ZERO:
+            return 1;
+        default:
+            return 0; // Unknown payload size: can't skip it
+    }
+}
+
+size_t imuLogDecodeRecord(ImuLogCodec* c, const uint8_t* in, size_t len, uint8_t* tag,
+                          ImuLogBatch* batch, ImuLogEvent* ev) {
+    if (len < 1) return 0;
+    *tag = in[0];
+
+    if (*tag == IMU_LOG_TAG_EVENT) {
+        size_t n = decodeEvent(&in[1], len - 1, ev);
+        return n ? n + 1 : 0;
+    }
+    if (*tag != IMU_LOG_TAG_BATCH) return 0;
+
+    size_t pos = 1, n;
+    uint32_t dt, count;
+    if (!(n = getVarint(&in[pos], len - pos, &dt))) return 0;
+    pos += n;
+    if (!(n = getVarint(&in[pos], len - pos, &count))) return 0;
+    pos += n;
+    if (pos >= len || count > 0xFFFF) return 0;
+    batch->flags = in[pos++];
+    batch->n = (uint16_t)count;
+    batch->t_us = c->last_t_us + dt;
+    batch->counter = 0;
+    if (batch->flags & IMU_LOG_BATCH_COUNTER) {
+        uint32_t delta;
+        if (!(n = getVarint(&in[pos], len - pos, &delta))) return 0;
+        pos += n;
+        c->last_counter += (uint32_t)unzigzag(delta);
+        batch->counter = c->last_counter;
+    }
+    if (batch->flags & IMU_LOG_BATCH_KEY) memset(c->prev, 0, sizeof(c->prev));
+
+    c->last_t_us = batch->t_us;
+    c->batches++;
+    return pos;
+}
+
+size_t imuLogDecodeSample(ImuLogCodec* c, const uint8_t* in, size_t len, int16_t raw[6]) {
+    size_t pos = 0;
+    for (int k = 0; k < 6; k++) {
+        uint32_t v;
+        size_t n = getVarint(&in[pos], len - pos, &v);
+        if (!n) return 0;
+        pos += n;
+        c->prev[k] = (int16_t)(c->prev[k] + unzigzag(v));
+        raw[k] = c->prev[k];
+    }
+    return pos;
+}
@@ -0,0 +1,110 @@
+/*
+ * File: imu_log.h
+ * Description: Compact Binary IMU Recording Format - No Arduino dependencies
+ * Author: zzackk125
+ * License: MIT
+ *
+ * Written by the firmware (imu_recorder.h), read by tools/imu_replay.
+ * All multi-byte fields are little endian.
+ *
+ *   Header (IMU_LOG_HEADER_BYTES)
+ *     "IMUL" version(u8) header_bytes(u8) flags(u8) reserved(u8)
+ *     sample_period_us(u16) acc_lsb_per_g(u16) gyr_lsb_per_dps(u16) reserved(u16)
+ *     start_us(u32)
+ *
+ *   Records, one tag byte each:
+ *     BATCH  dt_us(varint, since previous batch / start_us) n(varint) flags(u8)
+ *            [counter delta (zigzag varint) if IMU_LOG_BATCH_COUNTER]
+ *            followed by n samples: AX AY AZ GX GY GZ, each a zigzag varint delta
+ *            from the previous sample (from 0 on IMU_LOG_BATCH_KEY batches)
+ *     EVENT  type(u8) payload (see ImuLogEvent)
+ *
+ * Sample i of a batch was taken at t - (n - 1 - i) * sample_period_us, the same
+ * back-dating the FIFO drain uses, so a replay sees identical timing.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define IMU_LOG_MAGIC            "IMUL"
+#define IMU_LOG_VERSION          1
+#define IMU_LOG_HEADER_BYTES     20
+
+// Header flags (build the log was recorded with)
+#define IMU_LOG_FLAG_FIFO        0x01
+#define IMU_LOG_FLAG_FIXED_POINT 0x02
+
+#define IMU_LOG_TAG_BATCH        0x01
+#define IMU_LOG_TAG_EVENT        0x02
+
+// Batch flags
+#define IMU_LOG_BATCH_OVERFLOW   0x01  // Sensor FIFO overflowed before this batch
+#define IMU_LOG_BATCH_COUNTER    0x02  // Carries the sensor sample counter
+#define IMU_LOG_BATCH_KEY        0x04  // Samples delta-coded from 0 (resync point)
+#define IMU_LOG_BATCH_GAP        0x08  // Recorder dropped batches before this one
+
+#define IMU_LOG_KEY_INTERVAL     64    // Batches between key batches
+
+// Worst case encoded sizes, for buffer reservations
+#define IMU_LOG_MAX_BATCH_BYTES  (1 + 5 + 3 + 1 + 5)
+#define IMU_LOG_MAX_SAMPLE_BYTES (6 * 3)
+#define IMU_LOG_MAX_EVENT_BYTES  (2 + 12)
+
+enum ImuLogEventType {
+    IMU_LOG_EV_MODE = 1,     // u8 calculation mode
+    IMU_LOG_EV_SMOOTHING,    // u8 percent
+    IMU_LOG_EV_OFFSETS,      // f32 roll, f32 pitch (degrees)
+    IMU_LOG_EV_BIAS,         // i32 x3 gyro bias (counts * 256)
+    IMU_LOG_EV_ZERO,         // No payload: zeroIMU() applied (new offsets follow)
+    IMU_LOG_EV_ATTITUDE,     // f32 roll, f32 pitch: filter state before offsets (degrees)
+};
+
+struct ImuLogHeader {
+    uint8_t version;
+    uint8_t flags;
+    uint16_t sample_period_us;
+    uint16_t acc_lsb_per_g;
+    uint16_t gyr_lsb_per_dps;
+    uint32_t start_us;
+};
+
+struct ImuLogEvent {
+    uint8_t type;
+    uint8_t u8;          // MODE, SMOOTHING
+    float f[2];          // OFFSETS, ATTITUDE
+    int32_t bias_q8[3];  // BIAS
+};
+
+struct ImuLogBatch {
+    uint32_t t_us;       // micros() of the newest sample
+    uint16_t n;
+    uint8_t flags;
+    uint32_t counter;    // Valid with IMU_LOG_BATCH_COUNTER
+};
+
+// Delta coding state. One per direction (encoder or decoder).
+struct ImuLogCodec {
+    uint32_t last_t_us;
+    uint32_t last_counter;
+    int16_t prev[6];
+    uint32_t batches;
+};
+
+void imuLogCodecInit(ImuLogCodec* c, uint32_t start_us);
+
+size_t imuLogWriteHeader(uint8_t* out, const ImuLogHeader* h);
+size_t imuLogReadHeader(const uint8_t* in, size_t len, ImuLogHeader* h); // 0 = not a log / unsupported
+
+// Encoders return the bytes written (caller reserves the IMU_LOG_MAX_* sizes).
+// imuLogEncodeBatch may add IMU_LOG_BATCH_KEY to the flags.
+size_t imuLogEncodeBatch(ImuLogCodec* c, uint8_t* out, const ImuLogBatch* b);
+size_t imuLogEncodeSample(ImuLogCodec* c, uint8_t* out, const int16_t raw[6]);
+size_t imuLogEncodeEvent(uint8_t* out, const ImuLogEvent* ev);
+
+// Decoders return the bytes consumed, 0 = truncated or corrupt.
+// imuLogDecodeRecord reads the tag: *tag tells which of batch / ev was filled.
+size_t imuLogDecodeRecord(ImuLogCodec* c, const uint8_t* in, size_t len, uint8_t* tag,
+                          ImuLogBatch* batch, ImuLogEvent* ev);
+size_t imuLogDecodeSample(ImuLogCodec* c, const uint8_t* in, size_t len, int16_t raw[6]);
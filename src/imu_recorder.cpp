@@ -0,0 +1,196 @@
+/*
+ * File: imu_recorder.cpp
+ * Description: Raw IMU Recorder Implementation
+ * Author: zzackk125
+ * License: MIT
+ */
+
+#include "imu_recorder.h"
+#include "board_config.h"
+#include <LittleFS.h>
+#include <atomic>
+
+enum RecState : uint8_t {
+    REC_IDLE = 0,
+    REC_STARTING,   // File open, header queued. IMU task logs the config next.
+    REC_ACTIVE,
+    REC_STOPPING,   // Loop asked to stop. IMU task seals its buffer.
+    REC_SEALED,     // Loop flushes what's left and closes the file.
+};
+
+static std::atomic<uint8_t> rec_state(REC_IDLE);
+static File rec_file;
+static bool fs_ready = false;
+
+// Double buffer: The producer fills buf[cur]; a full buffer is handed to the
+// loop by setting ready[] and released by clearing it again.
+static uint8_t rec_buf[2][IMU_REC_BUF_BYTES];
+static size_t rec_len[2] = {0, 0};
+static uint32_t rec_seq[2] = {0, 0};
+static std::atomic<uint8_t> rec_ready[2];
+static int cur = 0;
+static uint32_t next_seq = 0;
+
+// Producer state (IMU task only)
+static ImuLogCodec codec;
+static bool skip_batch = true;  // Until a batch is reserved
+static bool gap_pending = false;
+
+static IMURecorderStats rec_stats = {0};
+
+void initRecorder() {
+    fs_ready = LittleFS.begin(true); // Format on first use
+    Serial.printf("Recorder: LittleFS %s\n", fs_ready ? "mounted" : "unavailable");
+}
+
+bool startRecording() {
+    if (!fs_ready || rec_state.load() != REC_IDLE) return false;
+
+    rec_file = LittleFS.open(IMU_LOG_PATH, "w");
+    if (!rec_file) {
+        Serial.println("Recorder: Failed to open " IMU_LOG_PATH);
+        return false;
+    }
+
+    ImuLogHeader h = {0};
+    h.flags = (IMU_USE_FIFO ? IMU_LOG_FLAG_FIFO : 0) | (IMU_USE_FIXED_POINT ? IMU_LOG_FLAG_FIXED_POINT : 0);
+    h.sample_period_us = IMU_SAMPLE_PERIOD_US;
+    h.acc_lsb_per_g = 8192;   // ACC_RANGE_4G
+    h.gyr_lsb_per_dps = 512;  // GYR_RANGE_64DPS
+    h.start_us = micros();
+
+    // Producer is idle: safe to reset its state from here
+    imuLogCodecInit(&codec, h.start_us);
+    cur = 0;
+    rec_len[0] = imuLogWriteHeader(rec_buf[0], &h);
+    rec_len[1] = 0;
+    rec_ready[0].store(0);
+    rec_ready[1].store(0);
+    skip_batch = true;
+    gap_pending = false;
+    rec_stats = IMURecorderStats();
+    rec_stats.active = true;
+
+    rec_state.store(REC_STARTING);
+    Serial.println("Recorder: Started");
+    return true;
+}
+
+void stopRecording() {
+    uint8_t expected = REC_STARTING;
+    if (rec_state.compare_exchange_strong(expected, REC_SEALED)) {
+        // Producer never started: only the header is queued
+        rec_seq[cur] = next_seq++;
+        rec_ready[cur].store(1);
+        return;
+    }
+    expected = REC_ACTIVE;
+    rec_state.compare_exchange_strong(expected, REC_STOPPING);
+}
+
+bool isRecording() {
+    return rec_state.load() != REC_IDLE; // Includes the final flush after a stop
+}
+
+// --- Producer (IMU task) ---
+static void sealCurrent() {
+    if (rec_len[cur] == 0) return;
+    rec_seq[cur] = next_seq++;
+    rec_ready[cur].store(1);
+    cur ^= 1;
+}
+
+// True if the producer may write (handles a pending stop)
+static bool producerActive() {
+    uint8_t s = rec_state.load();
+    if (s == REC_STOPPING) {
+        sealCurrent();
+        rec_state.store(REC_SEALED);
+        return false;
+    }
+    return s == REC_ACTIVE;
+}
+
+static uint8_t* reserve(size_t bytes) {
+    if (rec_ready[cur].load()) return NULL; // Still waiting for the loop
+    if (rec_len[cur] + bytes > IMU_REC_BUF_BYTES) {
+        sealCurrent();
+        if (rec_ready[cur].load()) return NULL;
+    }
+    return &rec_buf[cur][rec_len[cur]];
+}
+
+bool recorderNeedsState() {
+    uint8_t expected = REC_STARTING;
+    return rec_state.compare_exchange_strong(expected, REC_ACTIVE);
+}
+
+void recorderBatch(uint32_t t_us, uint16_t n, uint8_t flags, uint32_t counter) {
+    skip_batch = true;
+    if (!producerActive()) return;
+
+    if (!reserve(IMU_LOG_MAX_BATCH_BYTES + (size_t)n * IMU_LOG_MAX_SAMPLE_BYTES)) {
+        rec_stats.dropped_batches++;
+        gap_pending = true;
+        return;
+    }
+
+    ImuLogBatch b = { t_us, n, flags, counter };
+    if (gap_pending) b.flags |= IMU_LOG_BATCH_GAP;
+    gap_pending = false;
+    rec_len[cur] += imuLogEncodeBatch(&codec, &rec_buf[cur][rec_len[cur]], &b);
+    rec_stats.batches++;
+    skip_batch = false;
+}
+
+void recorderSample(const int16_t raw[6]) {
+    if (skip_batch) return; // Space for the whole batch was reserved up front
+    rec_len[cur] += imuLogEncodeSample(&codec, &rec_buf[cur][rec_len[cur]], raw);
+    rec_stats.samples++;
+}
+
+void recorderEvent(const ImuLogEvent* ev) {
+    if (!producerActive()) return;
+    uint8_t* p = reserve(IMU_LOG_MAX_EVENT_BYTES);
+    if (!p) {
+        gap_pending = true;
+        return;
+    }
+    rec_len[cur] += imuLogEncodeEvent(p, ev);
+}
+
+// --- Consumer (Arduino loop) ---
+void serviceRecorder() {
+    uint8_t s = rec_state.load();
+    if (s == REC_IDLE) return;
+
+    // Oldest first
+    for (int pass = 0; pass < 2; pass++) {
+        int i = -1;
+        if (rec_ready[0].load() && rec_ready[1].load()) i = (rec_seq[0] < rec_seq[1]) ? 0 : 1;
+        else if (rec_ready[0].load()) i = 0;
+        else if (rec_ready[1].load()) i = 1;
+        if (i < 0) break;
+
+        uint32_t start = micros();
+        rec_file.write(rec_buf[i], rec_len[i]);
+        uint32_t us = micros() - start;
+        if (us > rec_stats.flush_max_us) rec_stats.flush_max_us = us;
+        rec_stats.bytes += rec_len[i];
+
+        rec_len[i] = 0;
+        rec_ready[i].store(0);
+    }
+
+    if (s == REC_SEALED && !rec_ready[0].load() && !rec_ready[1].load()) {
+        rec_file.close();
+        rec_stats.active = false;
+        rec_state.store(REC_IDLE);
+        Serial.printf("Recorder: Stopped (%u bytes, %u samples, %u batches dropped)\n",
+                      (unsigned)rec_stats.bytes, (unsigned)rec_stats.samples, (unsigned)rec_stats.dropped_batches);
+    }
+}
+
+void getRecorderStats(IMURecorderStats* out) {
+    if (out) *out = rec_stats;
+}
@@ -0,0 +1,40 @@
+/*
+ * File: imu_recorder.h
+ * Description: Raw IMU Recorder (imu_log.h format on LittleFS)
+ * Author: zzackk125
+ * License: MIT
+ *
+ * The IMU task encodes into one of two RAM buffers; the Arduino loop writes
+ * full buffers to flash. Flash stalls never reach the sampling path: if both
+ * buffers are busy, whole batches are dropped and the next one is flagged.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include "imu_log.h"
+
+#define IMU_LOG_PATH        "/imu.bin"
+#define IMU_REC_BUF_BYTES   4096  // x2. Holds a full 128 sample FIFO batch.
+
+struct IMURecorderStats {
+    bool active;
+    uint32_t bytes;            // Written to flash
+    uint32_t batches;
+    uint32_t samples;
+    uint32_t dropped_batches;  // Both buffers busy (flash too slow)
+    uint32_t flush_max_us;
+};
+
+void initRecorder();           // Mount LittleFS (setup)
+bool startRecording();         // Loop / web context. Truncates IMU_LOG_PATH.
+void stopRecording();
+bool isRecording();
+void serviceRecorder();        // Loop: write full buffers to flash
+void getRecorderStats(IMURecorderStats* out);
+
+// IMU task side (single producer)
+bool recorderNeedsState();     // True right after start: log the current config
+void recorderBatch(uint32_t t_us, uint16_t n, uint8_t flags, uint32_t counter);
+void recorderSample(const int16_t raw[6]);
+void recorderEvent(const ImuLogEvent* ev);
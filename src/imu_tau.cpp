@@ -0,0 +1,89 @@
+/*
+ * File: imu_tau.cpp
+ * Description: Continuous Filter Time Constant Scheduler Implementation
+ * Author: zzackk125
+ * License: MIT
+ */
+
+#include "imu_tau.h"
+#include "imu_fixed.h"
+#include <string.h>
+
+#define W_ONE       32768
+#define W_MIN       ((uint16_t)((int64_t)W_ONE * TAU_BASE_Q16 / TAU_MAX_Q16))
+#define W_TURN_MIN  ((uint16_t)((int64_t)W_ONE * TAU_BASE_Q16 / TAU_TURN_MAX_Q16))
+#define CURVE_SEGS  16
+
+// Smoothstep from 1.0 down to TAU_BASE/TAU_MAX (0.1) between two knees,
+// sampled at CURVE_SEGS + 1 points and interpolated linearly.
+// Yaw rate: 0..16 deg/s (1 deg/s steps), full trust below 3, none past 12.
+// Down to TAU_BASE/TAU_TURN_MAX (0.001): in a steady corner the centripetal
+// g tilts the accel target by its full angle (0.35g ~ 19 deg), so even a 10s
+// tau pulls roll several degrees off over a few seconds of cornering.
+static const uint16_t curve_yaw[CURVE_SEGS + 1] = {
+    32768, 32768, 32768, 32768, 31645, 28637, 24281, 19117, 13683,
+    8519, 4163, 1155, 32, 32, 32, 32, 32
+};
+#define CURVE_YAW_STEP   1000   // mdps
+
+// | |a| - 1g |: 0..160 mg (10 mg steps), knees at 20 and 150 mg
+static const uint16_t curve_mag[CURVE_SEGS + 1] = {
+    32768, 32768, 32768, 32271, 30889, 28781, 26110, 23036, 19720,
+    16324, 13009, 9935, 7264, 5156, 3773, 3277, 3277
+};
+#define CURVE_MAG_STEP   10     // mg
+
+// |a| std dev: 0..80 mg (5 mg steps), knees at 10 and 70 mg (road vibration)
+static const uint16_t curve_var[CURVE_SEGS + 1] = {
+    32768, 32768, 32768, 32188, 30583, 28160, 25122, 21675, 18022,
+    14370, 10923, 7885, 5461, 3857, 3277, 3277, 3277
+};
+#define CURVE_VAR_STEP   5      // mg
+
+static uint16_t curveLookup(const uint16_t* curve, uint32_t x, uint32_t step) {
+    uint32_t i = x / step;
+    if (i >= CURVE_SEGS) return curve[CURVE_SEGS];
+    uint32_t frac = x - i * step;
+    int32_t a = curve[i];
+    int32_t b = curve[i + 1];
+    return (uint16_t)(a + (b - a) * (int32_t)frac / (int32_t)step);
+}
+
+void tauSchedInit(TauScheduler* s) {
+    memset(s, 0, sizeof(*s));
+    s->w_yaw = s->w_mag = s->w_var = s->weight = W_ONE;
+    s->tau_q16 = TAU_BASE_Q16;
+}
+
+int32_t tauSchedUpdate(TauScheduler* s, const int16_t acc[3], int32_t gz_mdps, int32_t acc_lsb_per_g) {
+    // | |a| - 1g | in mg from |a|^2 (no sqrt): |a| - 1 ~= (|a|^2 - 1) / 2.
+    // Clamped at 2g^2 first so it stays in 32 bits; the curve saturates long before.
+    uint32_t lsb_sq = (uint32_t)(acc_lsb_per_g * acc_lsb_per_g);
+    uint32_t mag_sq = (uint32_t)((int32_t)acc[0] * acc[0]) + (uint32_t)((int32_t)acc[1] * acc[1]) +
+                      (uint32_t)((int32_t)acc[2] * acc[2]);
+    if (mag_sq > 2 * lsb_sq) mag_sq = 2 * lsb_sq;
+    int32_t dev_mg = ((int32_t)mag_sq - (int32_t)lsb_sq) / (int32_t)(lsb_sq / 500);
+
+    // Running mean / variance of the signed deviation (bumps, washboard)
+    s->dev_mean_q8 += (dev_mg * 256 - s->dev_mean_q8) >> TAU_VAR_SHIFT;
+    int32_t diff = dev_mg - (s->dev_mean_q8 >> 8);
+    int32_t var_sample_q8 = (diff * diff) << 8;
+    s->dev_var_q8 = (uint32_t)((int32_t)s->dev_var_q8 + ((var_sample_q8 - (int32_t)s->dev_var_q8) >> TAU_VAR_SHIFT));
+    uint32_t std_mg = isqrt32(s->dev_var_q8 >> 8);
+
+    uint32_t yaw = (uint32_t)(gz_mdps < 0 ? -gz_mdps : gz_mdps);
+    s->w_yaw = curveLookup(curve_yaw, yaw, CURVE_YAW_STEP);
+    s->w_mag = curveLookup(curve_mag, (uint32_t)(dev_mg < 0 ? -dev_mg : dev_mg), CURVE_MAG_STEP);
+    s->w_var = curveLookup(curve_var, std_mg, CURVE_VAR_STEP);
+
+    // Bumps and vibration bottom out at TAU_MAX, yaw on its own at TAU_TURN_MAX
+    uint32_t w = ((uint32_t)s->w_mag * s->w_var) >> 15;
+    if (w < W_MIN) w = W_MIN;
+    w = (w * s->w_yaw) >> 15;
+    if (w < W_TURN_MIN) w = W_TURN_MIN;
+    s->weight = (uint16_t)w;
+
+    // TAU_BASE_Q16 << 15 fits 32 bits for TAU_BASE < 2s (tau itself < 32768s)
+    s->tau_q16 = (int32_t)(((uint32_t)TAU_BASE_Q16 << 15) / w);
+    return s->tau_q16;
+}
@@ -0,0 +1,41 @@
+/*
+ * File: imu_tau.h
+ * Description: Continuous Filter Time Constant Scheduler (Gain Scheduling)
+ * Author: zzackk125
+ * License: MIT
+ *
+ * Replaces the two-step TAU_NORMAL / TAU_TURNING switch. Three precomputed
+ * curves map yaw rate, | |a| - 1g | and recent |a| variance to an accel
+ * trust weight in (0, 1]. tau = TAU_BASE / weight, so the accel correction
+ * fades out smoothly under cornering, bumps and vibration and a shorter
+ * base tau can be used when driving straight.
+ *
+ * Integer-only, raw sensor counts in, so the float and Q16 paths share it.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#define TAU_BASE_Q16        65536   // 1.0s when the accel is fully trusted (< 2s, see tauSchedUpdate)
+#define TAU_MAX_Q16         655360  // 10s floor on accel trust from bumps / vibration (old TAU_TURNING)
+#define TAU_TURN_MAX_Q16    65536000 // 1000s while yawing: the lateral g is not gravity, gyro only
+#define TAU_VAR_SHIFT       7       // |a| mean/variance EMA: 1/128 per sample (~0.14s at 896.8Hz)
+
+struct TauScheduler {
+    int32_t dev_mean_q8;   // EMA of |a| - 1g, 1/1000 g * 256
+    uint32_t dev_var_q8;   // EMA of its variance, (1/1000 g)^2 * 256
+
+    // Last result (Q15 weights, 32768 = 1.0) for diagnostics
+    uint16_t w_yaw;
+    uint16_t w_mag;
+    uint16_t w_var;
+    uint16_t weight;
+    int32_t tau_q16;       // Seconds, Q16.16
+};
+
+void tauSchedInit(TauScheduler* s);
+
+// One raw sample. gz_mdps is the bias corrected yaw rate in 1/1000 deg/s.
+// Returns tau (Q16 seconds) for this sample.
+int32_t tauSchedUpdate(TauScheduler* s, const int16_t acc[3], int32_t gz_mdps, int32_t acc_lsb_per_g);
@@ -0,0 +1,169 @@
+/*
+ * File: latency_probe.cpp
+ * Description: Motion-to-Photon Latency Probe Implementation
+ * Author: zzackk125
+ * License: MIT
+ */
+
+#include "latency_probe.h"
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <string.h>
+
+// Timestamps (micros()) of one UI update on its way to the glass
+struct LatRecord {
+    uint32_t sample_us;
+    uint32_t publish_us;
+    uint32_t read_us;
+    uint32_t ui_us;
+    uint32_t flush_us;
+};
+
+static portMUX_TYPE lat_mux = portMUX_INITIALIZER_UNLOCKED;
+
+static LatRecord pending;         // Newest UI update, waiting for a frame
+static bool have_pending = false;
+static LatRecord inflight;        // Taken by the frame being flushed
+static bool frame_open = false;
+static bool frame_measured = false;
+static bool last_queued = false;
+
+// Accumulated since latencyReset()
+static uint32_t frames = 0;
+static uint32_t superseded = 0;
+static uint64_t total_sum = 0;
+static uint32_t total_max = 0;
+static uint64_t stage_sum[LAT_STAGES];
+static uint32_t stage_max[LAT_STAGES];
+static uint32_t hist[LAT_BUCKETS];
+
+static const char* const names[LAT_STAGES] = { "fusion", "handoff", "ui", "render", "flush" };
+
+static inline uint32_t span(uint32_t from, uint32_t to) {
+    int32_t d = (int32_t)(to - from);
+    return d > 0 ? (uint32_t)d : 0;
+}
+
+void latencyUIUpdate(uint32_t sample_us, uint32_t publish_us, uint32_t read_us) {
+    uint32_t now = micros();
+    portENTER_CRITICAL_SAFE(&lat_mux);
+    if (have_pending) superseded++;
+    pending.sample_us = sample_us;
+    pending.publish_us = publish_us;
+    pending.read_us = read_us;
+    pending.ui_us = now;
+    have_pending = true;
+    portEXIT_CRITICAL_SAFE(&lat_mux);
+}
+
+void latencyFlush(bool last) {
+    uint32_t now = micros();
+    portENTER_CRITICAL_SAFE(&lat_mux);
+    if (!frame_open) {
+        // First chunk: this frame shows the newest UI update
+        frame_open = true;
+        last_queued = false;
+        frame_measured = have_pending;
+        if (have_pending) {
+            inflight = pending;
+            inflight.flush_us = now;
+            have_pending = false;
+        }
+    }
+    if (last) last_queued = true;
+    portEXIT_CRITICAL_SAFE(&lat_mux);
+}
+
+void latencyFrameDone(void) {
+    uint32_t now = micros();
+    portENTER_CRITICAL_SAFE(&lat_mux);
+    // LVGL waits for each flush before the next, so this is the last chunk's DMA
+    if (frame_open && last_queued) {
+        frame_open = false;
+        if (frame_measured) {
+            const LatRecord* r = &inflight;
+            uint32_t s[LAT_STAGES] = {
+                span(r->sample_us, r->publish_us),
+                span(r->publish_us, r->read_us),
+                span(r->read_us, r->ui_us),
+                span(r->ui_us, r->flush_us),
+                span(r->flush_us, now),
+            };
+            uint32_t total = span(r->sample_us, now);
+            for (int i = 0; i < LAT_STAGES; i++) {
+                stage_sum[i] += s[i];
+                if (s[i] > stage_max[i]) stage_max[i] = s[i];
+            }
+            uint32_t b = total / LAT_BUCKET_US;
+            hist[b < LAT_BUCKETS ? b : LAT_BUCKETS - 1]++;
+            total_sum += total;
+            if (total > total_max) total_max = total;
+            frames++;
+        }
+    }
+    portEXIT_CRITICAL_SAFE(&lat_mux);
+}
+
+// Upper edge of the bucket holding the p-th fraction, capped at the max
+static uint32_t percentile(const LatencyStats* st, uint32_t per_mille) {
+    if (!st->frames) return 0;
+    uint32_t rank = (uint32_t)(((uint64_t)st->frames * per_mille + 999) / 1000);
+    uint32_t seen = 0;
+    for (int i = 0; i < LAT_BUCKETS; i++) {
+        seen += st->hist[i];
+        if (seen >= rank) {
+            uint32_t top = (uint32_t)(i + 1) * LAT_BUCKET_US;
+            return (i == LAT_BUCKETS - 1 || top > st->total_max_us) ? st->total_max_us : top;
+        }
+    }
+    return st->total_max_us;
+}
+
+void getLatencyStats(LatencyStats* out) {
+    if (!out) return;
+    uint64_t sum, ssum[LAT_STAGES];
+    portENTER_CRITICAL_SAFE(&lat_mux);
+    out->frames = frames;
+    out->superseded = superseded;
+    out->total_max_us = total_max;
+    sum = total_sum;
+    memcpy(ssum, stage_sum, sizeof(ssum));
+    memcpy(out->stage_max_us, stage_max, sizeof(stage_max));
+    memcpy(out->hist, hist, sizeof(hist));
+    portEXIT_CRITICAL_SAFE(&lat_mux);
+
+    uint32_t n = out->frames ? out->frames : 1;
+    out->total_avg_us = (uint32_t)(sum / n);
+    for (int i = 0; i < LAT_STAGES; i++) out->stage_avg_us[i] = (uint32_t)(ssum[i] / n);
+    out->p50_us = percentile(out, 500);
+    out->p90_us = percentile(out, 900);
+    out->p99_us = percentile(out, 990);
+}
+
+void latencyReset(void) {
+    portENTER_CRITICAL_SAFE(&lat_mux);
+    frames = 0;
+    superseded = 0;
+    total_sum = 0;
+    total_max = 0;
+    memset(stage_sum, 0, sizeof(stage_sum));
+    memset(stage_max, 0, sizeof(stage_max));
+    memset(hist, 0, sizeof(hist));
+    portEXIT_CRITICAL_SAFE(&lat_mux);
+}
+
+const char* latencyStageName(LatStage s) {
+    return (s >= 0 && s < LAT_STAGES) ? names[s] : "?";
+}
+
+void printLatency(void) {
+    LatencyStats st;
+    getLatencyStats(&st);
+    Serial.printf("Latency: %u frames, %u superseded UI updates\n", (unsigned)st.frames, (unsigned)st.superseded);
+    Serial.printf("  total   avg %6.1f  p50 %6.1f  p90 %6.1f  p99 %6.1f  max %6.1f ms\n", st.total_avg_us / 1000.0f,
+                  st.p50_us / 1000.0f, st.p90_us / 1000.0f, st.p99_us / 1000.0f, st.total_max_us / 1000.0f);
+    for (int i = 0; i < LAT_STAGES; i++) {
+        Serial.printf("  %-7s avg %6.1f  max %6.1f ms\n", names[i], st.stage_avg_us[i] / 1000.0f,
+                      st.stage_max_us[i] / 1000.0f);
+    }
+}
@@ -0,0 +1,75 @@
+/*
+ * File: latency_probe.h
+ * Description: Motion-to-Photon Latency Probe (/latency and the "lat" serial command)
+ * Author: zzackk125
+ * License: MIT
+ *
+ * Follows the newest IMU sample through the display pipeline:
+ *
+ *   sample -> published by the IMU task            fusion
+ *          -> read by the UI job                   handoff
+ *          -> updateUI() done (widgets invalid)    ui
+ *          -> first flush of the next frame        render
+ *          -> DMA done for that frame's last chunk flush
+ *
+ * Each UI update replaces the one waiting for a frame (superseded: it never
+ * reached the glass). A frame with no UI update since the previous frame
+ * isn't counted. Sample timestamps are micros() at the FIFO drain, back
+ * dated per frame by IMU_SAMPLE_PERIOD_US, so the time the newest sample sat
+ * in the FIFO isn't included.
+ *
+ * Stats accumulate until latencyReset(). Callable from C (lvgl_port.c);
+ * latencyFrameDone() runs in the DMA done ISR.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LAT_BUCKET_US   1000   // Histogram resolution
+#define LAT_BUCKETS     128    // Last bucket holds everything >= 127ms
+
+typedef enum {
+    LAT_FUSION = 0,
+    LAT_HANDOFF,
+    LAT_UI,
+    LAT_RENDER,
+    LAT_FLUSH,
+    LAT_STAGES
+} LatStage;
+
+typedef struct {
+    uint32_t frames;             // Completed measurements
+    uint32_t superseded;         // UI updates replaced before a frame took them
+    uint32_t total_avg_us;
+    uint32_t total_max_us;
+    uint32_t p50_us;             // Upper bucket edges
+    uint32_t p90_us;
+    uint32_t p99_us;
+    uint32_t stage_avg_us[LAT_STAGES];
+    uint32_t stage_max_us[LAT_STAGES];
+    uint32_t hist[LAT_BUCKETS];  // End to end, LAT_BUCKET_US wide
+} LatencyStats;
+
+// UI job, after updateUI() (LVGL lock held)
+void latencyUIUpdate(uint32_t sample_us, uint32_t publish_us, uint32_t read_us);
+
+// Flush callback, per chunk; last = lv_display_flush_is_last()
+void latencyFlush(bool last);
+
+// DMA done interrupt
+void latencyFrameDone(void);
+
+void getLatencyStats(LatencyStats* out);
+void latencyReset(void);
+const char* latencyStageName(LatStage s);
+void printLatency(void);     // Serial summary
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,106 @@
+/*
+ * File: loop_sched.cpp
+ * Description: Deadline Scheduler for the Arduino Loop Implementation
+ * Author: zzackk125
+ * License: MIT
+ */
+
+#include "loop_sched.h"
+
+// Wrap-safe: a at or after b
+static bool reached(uint32_t a, uint32_t b) {
+    return (int32_t)(a - b) >= 0;
+}
+
+void schedResetStats(SchedLoop* s) {
+    for (int i = 0; i < s->count; i++) {
+        SchedJob* j = &s->jobs[i];
+        j->runs = j->overruns = j->deferred = 0;
+        j->late_max_us = j->exec_max_us = 0;
+        j->late_sum_us = j->exec_sum_us = 0;
+    }
+    s->passes = 0;
+    s->busy_us = 0;
+    s->start_us = s->clock_us();
+}
+
+void schedInit(SchedLoop* s, SchedJob* jobs, int count, SchedClockFn clock_us, uint32_t idle_slack_us) {
+    s->jobs = jobs;
+    s->count = count > SCHED_MAX_JOBS ? SCHED_MAX_JOBS : count;
+    s->clock_us = clock_us;
+    s->idle_slack_us = idle_slack_us;
+    schedResetStats(s);
+    for (int i = 0; i < s->count; i++) s->jobs[i].next_us = s->start_us;
+}
+
+// Room before the earliest non-idle deadline (0 if one is due)
+static uint32_t slack(const SchedLoop* s, uint32_t now) {
+    uint32_t best = UINT32_MAX;
+    for (int i = 0; i < s->count; i++) {
+        const SchedJob* j = &s->jobs[i];
+        if (j->flags & SCHED_IDLE) continue;
+        if (reached(now, j->next_us)) return 0;
+        uint32_t d = j->next_us - now;
+        if (d < best) best = d;
+    }
+    return best;
+}
+
+static void runJob(SchedLoop* s, SchedJob* j, uint32_t now) {
+    uint32_t deadline = j->next_us;
+    uint32_t late = now - deadline;
+
+    j->fn();
+    uint32_t exec = s->clock_us() - now;
+
+    // Stay on the period grid; skip deadlines that already passed
+    uint32_t missed = late / j->period_us;
+    j->overruns += missed;
+    j->next_us = deadline + (missed + 1) * j->period_us;
+
+    j->runs++;
+    j->late_sum_us += late;
+    if (late > j->late_max_us) j->late_max_us = late;
+    j->exec_sum_us += exec;
+    if (exec > j->exec_max_us) j->exec_max_us = exec;
+    s->busy_us += exec;
+}
+
+uint32_t schedRun(SchedLoop* s) {
+    uint32_t ran = 0;      // Bitmask: one run per job per pass
+    uint32_t waiting = 0;  // Idle jobs due but deferred this pass
+    s->passes++;
+
+    for (;;) {
+        uint32_t now = s->clock_us();
+        int pick = -1;
+        for (int i = 0; i < s->count; i++) {
+            SchedJob* j = &s->jobs[i];
+            if ((ran | waiting) & (1UL << i) || !reached(now, j->next_us)) continue;
+            if (pick < 0 || (int32_t)(j->next_us - s->jobs[pick].next_us) < 0) pick = i;
+        }
+        if (pick < 0) break;
+
+        SchedJob* j = &s->jobs[pick];
+        if ((j->flags & SCHED_IDLE) && now - j->next_us < j->period_us && slack(s, now) < s->idle_slack_us) {
+            j->deferred++;
+            waiting |= 1UL << pick;
+            continue;
+        }
+        runJob(s, j, now);
+        ran |= 1UL << pick;
+    }
+
+    // Sleep until the next deadline. Deferred idle jobs don't count: they
+    // get another look when the loop wakes for the next regular job.
+    uint32_t now = s->clock_us();
+    uint32_t wait = UINT32_MAX;
+    for (int i = 0; i < s->count; i++) {
+        if (waiting & (1UL << i)) continue;
+        const SchedJob* j = &s->jobs[i];
+        if (reached(now, j->next_us)) return 0;
+        uint32_t d = j->next_us - now;
+        if (d < wait) wait = d;
+    }
+    return wait;
+}
@@ -0,0 +1,67 @@
+/*
+ * File: loop_sched.h
+ * Description: Deadline Scheduler for the Arduino Loop - No Arduino dependencies
+ * Author: zzackk125
+ * License: MIT
+ *
+ * Each job declares a period. schedRun() runs the jobs whose deadline has
+ * passed, earliest deadline first, and returns how long the loop may sleep
+ * before the next one is due. Deadlines advance by whole periods, so rates
+ * don't drift with the time the jobs take. A job that starts a full period
+ * late drops the missed deadlines (counted as overruns) instead of running
+ * back to back to catch up.
+ *
+ * SCHED_IDLE jobs (flash writes) only start when no other job is due within
+ * the loop's idle slack, unless they are themselves a full period late.
+ *
+ * The clock is passed in so tools/sched_sim can run the same code on a
+ * virtual one.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#define SCHED_MAX_JOBS  32
+
+#define SCHED_IDLE      0x01  // Background: only runs in gaps between other jobs
+
+typedef void (*SchedFn)();
+typedef uint32_t (*SchedClockFn)();   // Microseconds, free running (wraps)
+
+struct SchedJob {
+    const char* name;
+    SchedFn fn;
+    uint32_t period_us;
+    uint8_t flags;
+
+    // Runtime (zeroed by schedInit)
+    uint32_t next_us;       // Deadline
+    uint32_t runs;
+    uint32_t overruns;      // Deadlines dropped (started >= 1 period late)
+    uint32_t deferred;      // SCHED_IDLE: passes skipped for lack of slack
+    uint32_t late_max_us;   // Start - deadline
+    uint64_t late_sum_us;
+    uint32_t exec_max_us;
+    uint64_t exec_sum_us;
+};
+
+struct SchedLoop {
+    SchedJob* jobs;
+    int count;
+    SchedClockFn clock_us;
+    uint32_t idle_slack_us;
+
+    uint32_t start_us;      // schedInit / last schedResetStats
+    uint32_t passes;        // schedRun calls (= loop wakeups)
+    uint64_t busy_us;       // Time spent inside jobs
+};
+
+// Deadlines start at now; jobs run in table order on the first pass.
+void schedInit(SchedLoop* s, SchedJob* jobs, int count, SchedClockFn clock_us, uint32_t idle_slack_us);
+
+// Run due jobs (each at most once). Returns microseconds until the next
+// deadline, 0 if something is already due again.
+uint32_t schedRun(SchedLoop* s);
+
+void schedResetStats(SchedLoop* s);
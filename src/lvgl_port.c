@@ -13,6 +13,11 @@
 #include "esp_err.h"
 #include "esp_timer.h"
 #include "board_config.h"
+#include "perf_counters.h"
+#include "latency_probe.h"
+#include "rgb565_swap.h"
+#include "circle_clip.h"
+#include <string.h>
 #include "driver/spi_master.h"
 #include "esp_lcd_panel_io.h"
 #include "esp_lcd_panel_ops.h"
@@ -21,16 +26,37 @@
 #define LCD_HOST    SPI2_HOST
 #define LCD_BIT_PER_PIXEL 16
 
+#if LCD_NATIVE_SWAP && !LV_VERSION_CHECK(9, 2, 0)
+#error "LCD_NATIVE_SWAP needs LVGL 9.2+ (RGB565_SWAPPED rendering), set it to 0"
+#endif
+// The rounder tells LVGL's chunk sizing probe (get_max_row()) from a real
+// invalidation by the render bracket alone: in 9.x the probe is only sent
+// between LV_EVENT_RENDER_START and LV_EVENT_RENDER_READY
+#if LCD_CIRCLE_CLIP && (!LV_VERSION_CHECK(9, 0, 0) || LVGL_VERSION_MAJOR > 9)
+#error "LCD_CIRCLE_CLIP is checked against LVGL 9.x's render events, set it to 0"
+#endif
+
 static const char *TAG = "lvgl_port";
 static SemaphoreHandle_t lvgl_mux = NULL;
 static esp_lcd_panel_io_handle_t amoled_panel_io_handle = NULL;
 static lv_display_t * disp_handle = NULL;
 static int current_rotation = 0; // 0, 90, 180, 270
+static uint32_t flush_start = 0;   // perfBegin() of the flush in flight
+#if LCD_CIRCLE_CLIP
+#define FLUSH_MAX_WINDOWS (LVGL_BUF_HEIGHT / LCD_CIRCLE_FLUSH_ROWS + 2)
+#define INV_MAX_BANDS     (LCD_V_RES / LCD_CIRCLE_BAND_ROWS + 2)
+static uint32_t flush_windows = 0; // Address windows of the flush still in DMA (+1 while queueing)
+static bool rendering = false;     // LV_EVENT_RENDER_START .. READY: rounding only (chunk probe, redraws)
+static bool inv_splitting = false; // Invalidating the extra bands of an area
+#endif
 
 // Forward Declarations
 static bool example_notify_lvgl_flush_ready(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_io_event_data_t *edata, void *user_ctx);
 static void example_lvgl_flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map);
 static void example_lvgl_rounder_cb(lv_event_t * e);
+#if LCD_CIRCLE_CLIP
+static void example_lvgl_render_cb(lv_event_t * e);
+#endif
 static void example_increase_lvgl_tick(void *arg);
 static void example_lvgl_port_task(void *arg);
 
@@ -107,9 +133,19 @@ void lvgl_port_init(void)
   // Create Display
   disp_handle = lv_display_create(LCD_H_RES, LCD_V_RES);
   lv_display_set_flush_cb(disp_handle, example_lvgl_flush_cb);
+#if LCD_NATIVE_SWAP
+  // Draw buffers hold panel byte order: flushes go straight to DMA
+  lv_display_set_color_format(disp_handle, LV_COLOR_FORMAT_RGB565_SWAPPED);
+#endif
   
   // Add Rounder Callback to ensure coordinates are even (required by SH8601)
   lv_display_add_event_cb(disp_handle, example_lvgl_rounder_cb, LV_EVENT_INVALIDATE_AREA, NULL);
+#if LCD_CIRCLE_CLIP
+  // Round panel: invalidated areas and flushes are trimmed to the visible disk
+  circleInit(LCD_H_RES, LCD_V_RES, LCD_CIRCLE_MARGIN_PX);
+  lv_display_add_event_cb(disp_handle, example_lvgl_render_cb, LV_EVENT_RENDER_START, NULL);
+  lv_display_add_event_cb(disp_handle, example_lvgl_render_cb, LV_EVENT_RENDER_READY, NULL);
+#endif
   
   lv_display_set_user_data(disp_handle, panel_handle);
 
@@ -136,16 +172,28 @@ void lvgl_port_init(void)
   xTaskCreate(example_lvgl_port_task, "LVGL", LVGL_TASK_STACK_SIZE, NULL, LVGL_TASK_PRIORITY, NULL);
 }
 
-static bool example_notify_lvgl_flush_ready(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_io_event_data_t *edata, void *user_ctx)
+static void flush_done(void)
 {
+  perfEnd(PERF_FLUSH_DMA, flush_start);
+  latencyFrameDone();
   if (disp_handle) {
       lv_display_flush_ready(disp_handle);
   }
+}
+
+static bool example_notify_lvgl_flush_ready(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_io_event_data_t *edata, void *user_ctx)
+{
+#if LCD_CIRCLE_CLIP
+  // One call per address window: the chunk is done after the last
+  if (__atomic_sub_fetch(&flush_windows, 1, __ATOMIC_ACQ_REL) != 0) return false;
+#endif
+  flush_done();
   return false;
 }
 
 static void example_lvgl_flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map)
 {
+  uint32_t perf = perfBegin();
   esp_lcd_panel_handle_t panel_handle = (esp_lcd_panel_handle_t) lv_display_get_user_data(disp);
   
   // Standard logic: No manual offsets here.
@@ -155,16 +203,47 @@ static void example_lvgl_flush_cb(lv_display_t *disp, const lv_area_t *area, uin
   const int offsety1 = area->y1;
   const int offsety2 = area->y2;
   
+  latencyFlush(lv_display_flush_is_last(disp));
+#if LCD_CIRCLE_CLIP
+  // Send only the visible disk: each window's rows are packed to the front
+  // of what's left of the buffer (never over data already queued for DMA)
+  CircleArea chunk = { offsetx1, offsety1, offsetx2, offsety2 };
+  CircleArea win[FLUSH_MAX_WINDOWS];
+  int n = circleSplit(&chunk, LCD_CIRCLE_FLUSH_ROWS, win, FLUSH_MAX_WINDOWS);
+  const int32_t stride = offsetx2 - offsetx1 + 1;
+  uint16_t *dst = (uint16_t *)px_map;
+
+  flush_start = perfBegin();
+  __atomic_store_n(&flush_windows, 1, __ATOMIC_RELEASE); // Held until every window is queued
+  for (int i = 0; i < n; i++) {
+      const int32_t w = win[i].x2 - win[i].x1 + 1;
+      const int32_t h = win[i].y2 - win[i].y1 + 1;
+      const uint16_t *src = (const uint16_t *)px_map + (win[i].y1 - offsety1) * stride + (win[i].x1 - offsetx1);
+      if (src != dst || w != stride) {
+          for (int32_t row = 0; row < h; row++) memmove(dst + row * w, src + row * stride, w * sizeof(uint16_t));
+      }
+#if !LCD_NATIVE_SWAP
+      rgb565_swap(dst, (uint32_t)(w * h));
+#endif
+      __atomic_add_fetch(&flush_windows, 1, __ATOMIC_ACQ_REL);
+      esp_lcd_panel_draw_bitmap(panel_handle, win[i].x1, win[i].y1, win[i].x2 + 1, win[i].y2 + 1, dst);
+      dst += w * h;
+  }
+  perfEnd(PERF_TX_COLOR, flush_start);
+  if (__atomic_sub_fetch(&flush_windows, 1, __ATOMIC_ACQ_REL) == 0) flush_done(); // All DMA done, or nothing visible
+#else
+#if !LCD_NATIVE_SWAP
   // Swap bytes for SH8601 (Little Endian -> Big Endian)
-  // px_map is uint8_t*, but represents uint16_t pixels.
-  // We need to swap every pair of bytes.
   uint32_t len = (area->x2 - area->x1 + 1) * (area->y2 - area->y1 + 1);
-  uint16_t *buf16 = (uint16_t *)px_map;
-  for(uint32_t i = 0; i < len; i++) {
-      buf16[i] = (buf16[i] << 8) | (buf16[i] >> 8);
-  }
+  rgb565_swap((uint16_t *)px_map, len);
+#endif
 
+  flush_start = perfBegin();
   esp_lcd_panel_draw_bitmap(panel_handle, offsetx1, offsety1, offsetx2 + 1, offsety2 + 1, px_map);
+  perfEnd(PERF_TX_COLOR, flush_start);
+#endif
+  if (lv_display_flush_is_last(disp)) perfFrame();
+  perfEnd(PERF_FLUSH_CB, perf);
 }
 
 static void example_lvgl_rounder_cb(lv_event_t * e)
@@ -182,8 +261,39 @@ static void example_lvgl_rounder_cb(lv_event_t * e)
     // round the end of coordinate up to the nearest 2N+1 number
     area->x2 = ((x2 >> 1) << 1) + 1;
     area->y2 = ((y2 >> 1) << 1) + 1;
+
+#if LCD_CIRCLE_CLIP
+    // Only areas invalidated outside rendering are split; LVGL also calls
+    // this while rendering to size its chunks (see the version check above)
+    if (rendering || inv_splitting) return;
+
+    // Render only the visible disk: keep the first band, invalidate the rest
+    CircleArea in = { area->x1, area->y1, area->x2, area->y2 };
+    CircleArea bands[INV_MAX_BANDS];
+    int n = circleSplit(&in, LCD_CIRCLE_BAND_ROWS, bands, INV_MAX_BANDS);
+    if (n == 0) {
+        // Corner only: park it on 2x2 pixels off the disk, which the flush drops
+        area->x1 = 0; area->y1 = 0; area->x2 = 1; area->y2 = 1;
+        return;
+    }
+    area->x1 = bands[0].x1; area->y1 = bands[0].y1;
+    area->x2 = bands[0].x2; area->y2 = bands[0].y2;
+    inv_splitting = true;
+    for (int i = 1; i < n; i++) {
+        lv_area_t b = { bands[i].x1, bands[i].y1, bands[i].x2, bands[i].y2 };
+        lv_inv_area(disp_handle, &b);
+    }
+    inv_splitting = false;
+#endif
 }
 
+#if LCD_CIRCLE_CLIP
+static void example_lvgl_render_cb(lv_event_t * e)
+{
+    rendering = (lv_event_get_code(e) == LV_EVENT_RENDER_START);
+}
+#endif
+
 static void example_increase_lvgl_tick(void *arg)
 {
   lv_tick_inc(LVGL_TICK_PERIOD_MS);
@@ -194,9 +304,13 @@ static void example_lvgl_port_task(void *arg)
   uint32_t task_delay_ms = LVGL_TASK_MAX_DELAY_MS;
   for(;;)
   {
+    uint32_t wait = perfBegin();
     if (xSemaphoreTake(lvgl_mux, portMAX_DELAY) == pdTRUE)
     {
+      perfEnd(PERF_LVGL_LOCK, wait);
+      uint32_t perf = perfBegin();
       task_delay_ms = lv_timer_handler();
+      perfEnd(PERF_LV_TIMER, perf);
       xSemaphoreGive(lvgl_mux);
     }
     if (task_delay_ms > LVGL_TASK_MAX_DELAY_MS) task_delay_ms = LVGL_TASK_MAX_DELAY_MS;
@@ -207,7 +321,9 @@ static void example_lvgl_port_task(void *arg)
 
 void lvgl_port_lock(int timeout_ms) {
     const TickType_t timeout_ticks = (timeout_ms == -1) ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+    uint32_t wait = perfBegin();
     xSemaphoreTake(lvgl_mux, timeout_ticks);
+    perfEnd(PERF_LVGL_LOCK, wait);
 }
 
 void lvgl_port_unlock(void) {
@@ -260,3 +376,25 @@ void lvgl_port_set_rotation(int degrees) {
 int lvgl_port_get_rotation(void) {
     return current_rotation;
 }
+
+void lvgl_port_set_refresh_period(uint32_t ms) {
+    if (!disp_handle) return;
+    lv_timer_t *refr = lv_display_get_refr_timer(disp_handle);
+    if (refr) lv_timer_set_period(refr, ms ? ms : LV_DEF_REFR_PERIOD);
+}
+
+// SH8601 QSPI command framing: write opcode in [31:24], command in [15:8]
+static void panel_write_cmd(uint8_t cmd, const uint8_t *param, size_t len) {
+  if (!amoled_panel_io_handle) return;
+  esp_lcd_panel_io_tx_param(amoled_panel_io_handle, (0x02 << 24) | ((uint32_t)cmd << 8), param, len);
+}
+
+void lvgl_port_set_brightness(uint8_t level) {
+  panel_write_cmd(0x51, &level, 1);
+}
+
+void lvgl_port_display_on(bool on) {
+  if (!disp_handle) return;
+  esp_lcd_panel_handle_t panel_handle = (esp_lcd_panel_handle_t) lv_display_get_user_data(disp_handle);
+  esp_lcd_panel_disp_on_off(panel_handle, on);
+}
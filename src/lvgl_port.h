@@ -8,6 +8,8 @@
 #pragma once
 
 #include "driver/i2c_master.h"
+#include <stdbool.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -19,6 +21,11 @@ void lvgl_port_unlock(void);
 void lvgl_port_set_rotation(int degrees);
 int lvgl_port_get_rotation(void);
 
+// Power management (caller holds the LVGL lock)
+void lvgl_port_set_refresh_period(uint32_t ms); // 0 = LV_DEF_REFR_PERIOD
+void lvgl_port_set_brightness(uint8_t level);   // 0-255
+void lvgl_port_display_on(bool on);
+
 #ifdef __cplusplus
 }
 #endif
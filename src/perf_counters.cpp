@@ -0,0 +1,145 @@
+/*
+ * File: perf_counters.cpp
+ * Description: Per-Subsystem CPU Cycle Counters Implementation
+ * Author: zzackk125
+ * License: MIT
+ */
+
+#include "perf_counters.h"
+#include <Arduino.h>
+#include <esp_cpu.h>
+#include <freertos/FreeRTOS.h>
+#include <string.h>
+
+struct PerfWindow {
+    uint16_t hist[PERF_COUNT][PERF_BUCKETS];
+    uint32_t count[PERF_COUNT];
+    uint32_t min[PERF_COUNT];
+    uint32_t max[PERF_COUNT];
+    uint64_t total[PERF_COUNT];
+    uint32_t frames;
+    uint32_t start_us;
+};
+
+// Writers fill windows[cur]; perfRollWindow() flips and summarises the other
+static PerfWindow windows[2];
+static volatile uint8_t cur = 0;
+static portMUX_TYPE perf_mux = portMUX_INITIALIZER_UNLOCKED;
+static PerfSnapshot snap = {0};
+
+static const char* const names[PERF_COUNT] = {
+    "imu_update", "ui_update", "lv_timer", "flush_cb", "tx_color", "flush_dma", "web", "lvgl_lock",
+};
+
+static inline int bucketOf(uint32_t v) {
+    if (v < 4) return (int)v;
+    int b = 31 - __builtin_clz(v);             // 2..31
+    return (b - 1) * 4 + (int)((v >> (b - 2)) & 3);
+}
+
+static uint32_t bucketTop(int idx) {
+    if (idx < 4) return (uint32_t)idx;
+    int b = idx / 4 + 1, sub = idx % 4;
+    return (uint32_t)((((uint64_t)(5 + sub)) << (b - 2)) - 1);
+}
+
+static void clearWindow(PerfWindow* w) {
+    memset(w, 0, sizeof(*w));
+    for (int i = 0; i < PERF_COUNT; i++) w->min[i] = UINT32_MAX;
+    w->start_us = micros();
+}
+
+uint32_t perfBegin(void) {
+    return esp_cpu_get_cycle_count();
+}
+
+void perfEnd(PerfId id, uint32_t start) {
+    uint32_t c = esp_cpu_get_cycle_count() - start;
+    int b = bucketOf(c);
+    portENTER_CRITICAL_SAFE(&perf_mux);
+    PerfWindow* w = &windows[cur];
+    if (w->hist[id][b] != UINT16_MAX) w->hist[id][b]++;
+    w->count[id]++;
+    w->total[id] += c;
+    if (c < w->min[id]) w->min[id] = c;
+    if (c > w->max[id]) w->max[id] = c;
+    portEXIT_CRITICAL_SAFE(&perf_mux);
+}
+
+void perfFrame(void) {
+    portENTER_CRITICAL_SAFE(&perf_mux);
+    windows[cur].frames++;
+    portEXIT_CRITICAL_SAFE(&perf_mux);
+}
+
+void perfInit(void) {
+    // Cost of a pair as the instrumented code pays it (filed, then discarded)
+    const int n = 64;
+    clearWindow(&windows[0]);
+    uint32_t start = perfBegin();
+    for (int i = 0; i < n; i++) perfEnd(PERF_IMU_UPDATE, perfBegin());
+    snap.overhead_cycles = (perfBegin() - start) / n;
+    snap.cpu_mhz = getCpuFrequencyMhz();
+
+    clearWindow(&windows[0]);
+    clearWindow(&windows[1]);
+}
+
+void perfRollWindow(void) {
+    uint32_t now = micros();
+    portENTER_CRITICAL(&perf_mux);
+    PerfWindow* w = &windows[cur];
+    cur ^= 1;
+    windows[cur].start_us = now; // Cleared at the end of the previous roll
+    portEXIT_CRITICAL(&perf_mux);
+
+    PerfSnapshot s = snap;
+    s.window_us = now - w->start_us;
+    s.frames = w->frames;
+    s.windows++;
+    for (int i = 0; i < PERF_COUNT; i++) {
+        PerfStat* st = &s.stat[i];
+        st->count = w->count[i];
+        st->total = w->total[i];
+        st->min = st->count ? w->min[i] : 0;
+        st->max = w->max[i];
+        st->avg = st->count ? (uint32_t)(w->total[i] / st->count) : 0;
+
+        // Smallest bucket holding the 99th percentile sample
+        uint32_t rank = st->count - st->count / 100, seen = 0;
+        st->p99 = 0;
+        for (int b = 0; b < PERF_BUCKETS && st->count; b++) {
+            seen += w->hist[i][b];
+            if (seen >= rank) {
+                st->p99 = bucketTop(b) < st->max ? bucketTop(b) : st->max;
+                break;
+            }
+        }
+    }
+    snap = s;
+    clearWindow(w); // Ready for the next flip
+}
+
+void getPerfSnapshot(PerfSnapshot* out) {
+    if (out) *out = snap;
+}
+
+const char* perfName(PerfId id) {
+    return (id < PERF_COUNT) ? names[id] : "?";
+}
+
+void printPerf(void) {
+    PerfSnapshot s;
+    getPerfSnapshot(&s);
+    float mhz = s.cpu_mhz ? (float)s.cpu_mhz : 1.0f;
+    float window_s = s.window_us / 1e6f;
+    Serial.printf("Perf: %.1f s window, %.1f fps, counter overhead %u cycles (%.2f us)\n", window_s,
+                  window_s > 0 ? s.frames / window_s : 0.0f, (unsigned)s.overhead_cycles, s.overhead_cycles / mhz);
+    Serial.printf("  %-10s %7s %9s %9s %9s %9s %6s\n", "us", "count", "min", "avg", "p99", "max", "cpu%");
+    for (int i = 0; i < PERF_COUNT; i++) {
+        const PerfStat* st = &s.stat[i];
+        float cpu = s.window_us ? (float)(st->total / mhz) * 100.0f / s.window_us : 0.0f;
+        Serial.printf("  %-10s %7u %9.1f %9.1f %9.1f %9.1f %6.2f\n", names[i], (unsigned)st->count, st->min / mhz,
+                      st->avg / mhz, st->p99 / mhz, st->max / mhz, cpu);
+    }
+}
@@ -0,0 +1,74 @@
+/*
+ * File: perf_counters.h
+ * Description: Per-Subsystem CPU Cycle Counters (/perf and the "perf" serial command)
+ * Author: zzackk125
+ * License: MIT
+ *
+ * perfBegin() reads the CPU cycle counter; perfEnd() files the span into a
+ * log2 histogram (4 buckets per octave) for the current window. Every
+ * PERF_WINDOW_MS the loop closes the window: min / avg / max / p99 and the
+ * CPU share are computed from it, and the other buffer starts filling.
+ * p99 is the upper edge of its bucket (at most ~25% high, never above max).
+ *
+ * The cost of a begin/end pair is measured at perfInit() and reported as
+ * overhead_cycles; spans include it once. Callable from C (lvgl_port.c),
+ * any task and ISRs.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PERF_WINDOW_MS  5000
+#define PERF_BUCKETS    124   // 0..3 exact, then 4 per octave up to 2^32
+
+typedef enum {
+    PERF_IMU_UPDATE = 0,   // IMU task: drain + fuse + health + publish
+    PERF_UI_UPDATE,        // updateUI()
+    PERF_LV_TIMER,         // lv_timer_handler() (render + flush setup)
+    PERF_FLUSH_CB,         // example_lvgl_flush_cb() (byte swap unless LCD_NATIVE_SWAP, tx_color)
+    PERF_TX_COLOR,         // esp_lcd_panel_draw_bitmap() calls (LCD_CIRCLE_CLIP: + packing, window waits)
+    PERF_FLUSH_DMA,        // Flush start -> DMA done interrupt
+    PERF_WEB,              // handleWebServer()
+    PERF_LVGL_LOCK,        // lvgl_port_lock() wait
+    PERF_COUNT
+} PerfId;
+
+typedef struct {
+    uint32_t count;
+    uint32_t min;          // Cycles
+    uint32_t avg;
+    uint32_t max;
+    uint32_t p99;
+    uint64_t total;        // Cycles in the window (CPU share)
+} PerfStat;
+
+typedef struct {
+    PerfStat stat[PERF_COUNT];
+    uint32_t frames;           // Completed LVGL frames (last flush of a refresh)
+    uint32_t window_us;        // Length of the reported window
+    uint32_t windows;          // Windows closed since boot
+    uint32_t overhead_cycles;  // One begin/end pair
+    uint32_t cpu_mhz;
+} PerfSnapshot;
+
+void perfInit(void);
+uint32_t perfBegin(void);
+void perfEnd(PerfId id, uint32_t start);
+void perfFrame(void);
+
+// Close the current window (loop job, every PERF_WINDOW_MS)
+void perfRollWindow(void);
+
+// Last closed window
+void getPerfSnapshot(PerfSnapshot* out);
+const char* perfName(PerfId id);
+void printPerf(void);      // Serial dump of the last window
+
+#ifdef __cplusplus
+}
+#endif
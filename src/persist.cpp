@@ -0,0 +1,279 @@
+/*
+ * File: persist.cpp
+ * Description: Background NVS Persistence Service Implementation
+ * Author: zzackk125
+ * License: MIT
+ */
+
+#include "persist.h"
+#include "board_config.h"
+#include <Arduino.h>
+#include <nvs.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+#include <string.h>
+#include <atomic>
+
+enum PersistType : uint8_t {
+    PT_I32 = 0,   // Preferences putInt
+    PT_U32,       // putUInt
+    PT_U8,        // putBool
+    PT_BLOB,      // putFloat, putBytes
+    PT_SYNC,      // Commit now; data = sequence number
+};
+
+struct PersistIntent {
+    uint32_t seq;         // Write order: a newer value for a key always wins
+    uint8_t ns;
+    uint8_t type;
+    uint8_t len;
+    char key[PERSIST_MAX_KEY + 1];
+    uint8_t data[PERSIST_MAX_BYTES];
+};
+
+static const char* const ns_names[PERSIST_NS_COUNT] = { "imu", "ui", "web" };
+static nvs_handle_t handles[PERSIST_NS_COUNT];
+static bool ns_open[PERSIST_NS_COUNT] = { false };
+
+static QueueHandle_t queue = NULL;
+static TaskHandle_t persist_task_handle = NULL;
+
+// Task side
+static PersistIntent pending[PERSIST_MAX_PENDING];
+static int pending_count = 0;
+static uint32_t first_pending_ms = 0;
+
+static std::atomic<uint32_t> sync_requested(0);
+static std::atomic<uint32_t> sync_done(0);
+
+// Writer side: intents that found the queue full, one slot per key (newest
+// value), absorbed by the task after the queue. Never blocks the writer: the
+// IMU and LVGL tasks write settings too.
+static PersistIntent overflow[PERSIST_OVERFLOW_SLOTS];
+static int overflow_count = 0;
+static std::atomic<uint32_t> next_seq(0);
+
+static portMUX_TYPE persist_mux = portMUX_INITIALIZER_UNLOCKED;  // overflow[], stats
+static PersistStats stats = {0};
+
+#define STAT_ADD(field, n) do { portENTER_CRITICAL(&persist_mux); stats.field += (n); portEXIT_CRITICAL(&persist_mux); } while (0)
+
+// Queue full: replace this key's overflow value, or take a free slot
+static void overflowPut(const PersistIntent* in) {
+    portENTER_CRITICAL(&persist_mux);
+    int i = 0;
+    while (i < overflow_count && !(overflow[i].ns == in->ns && strcmp(overflow[i].key, in->key) == 0)) i++;
+    if (i < overflow_count) {
+        if ((int32_t)(in->seq - overflow[i].seq) > 0) overflow[i] = *in;
+        stats.coalesced++;
+    } else if (overflow_count < PERSIST_OVERFLOW_SLOTS) {
+        overflow[overflow_count++] = *in;
+    } else {
+        stats.dropped++;
+    }
+    portEXIT_CRITICAL(&persist_mux);
+}
+
+// --- Writers (any task) ---
+static void enqueue(PersistNs ns, const char* key, uint8_t type, const void* data, size_t len) {
+    STAT_ADD(intents, 1);
+    size_t key_len = strlen(key);
+    if (!queue || ns >= PERSIST_NS_COUNT || len > PERSIST_MAX_BYTES || key_len > PERSIST_MAX_KEY) {
+        STAT_ADD(errors, 1);
+        return;
+    }
+    PersistIntent in;
+    in.seq = next_seq.fetch_add(1);
+    in.ns = ns;
+    in.type = type;
+    in.len = (uint8_t)len;
+    memcpy(in.key, key, key_len + 1);
+    memcpy(in.data, data, len);
+    if (xQueueSend(queue, &in, 0) != pdTRUE) overflowPut(&in);
+}
+
+void persistPutInt(PersistNs ns, const char* key, int32_t v) {
+    enqueue(ns, key, PT_I32, &v, sizeof(v));
+}
+
+void persistPutUInt(PersistNs ns, const char* key, uint32_t v) {
+    enqueue(ns, key, PT_U32, &v, sizeof(v));
+}
+
+void persistPutFloat(PersistNs ns, const char* key, float v) {
+    enqueue(ns, key, PT_BLOB, &v, sizeof(v));
+}
+
+void persistPutBool(PersistNs ns, const char* key, bool v) {
+    uint8_t b = v ? 1 : 0;
+    enqueue(ns, key, PT_U8, &b, sizeof(b));
+}
+
+void persistPutBytes(PersistNs ns, const char* key, const void* data, size_t len) {
+    enqueue(ns, key, PT_BLOB, data, len);
+}
+
+// --- Readers (init time) ---
+int32_t persistGetInt(PersistNs ns, const char* key, int32_t def) {
+    int32_t v;
+    return (ns_open[ns] && nvs_get_i32(handles[ns], key, &v) == ESP_OK) ? v : def;
+}
+
+uint32_t persistGetUInt(PersistNs ns, const char* key, uint32_t def) {
+    uint32_t v;
+    return (ns_open[ns] && nvs_get_u32(handles[ns], key, &v) == ESP_OK) ? v : def;
+}
+
+bool persistGetBool(PersistNs ns, const char* key, bool def) {
+    uint8_t v;
+    return (ns_open[ns] && nvs_get_u8(handles[ns], key, &v) == ESP_OK) ? v != 0 : def;
+}
+
+size_t persistGetBytes(PersistNs ns, const char* key, void* out, size_t len) {
+    size_t n = 0;
+    if (!ns_open[ns] || nvs_get_blob(handles[ns], key, NULL, &n) != ESP_OK || n != len) return 0;
+    return nvs_get_blob(handles[ns], key, out, &n) == ESP_OK ? n : 0;
+}
+
+float persistGetFloat(PersistNs ns, const char* key, float def) {
+    float v;
+    return persistGetBytes(ns, key, &v, sizeof(v)) ? v : def;
+}
+
+// --- Task ---
+static void commit() {
+    uint32_t start = micros();
+    bool dirty[PERSIST_NS_COUNT] = { false };
+    uint32_t written = 0, commits = 0, errors = 0;
+
+    for (int i = 0; i < pending_count; i++) {
+        const PersistIntent* in = &pending[i];
+        if (!ns_open[in->ns]) {
+            errors++;
+            continue;
+        }
+        nvs_handle_t h = handles[in->ns];
+        esp_err_t err;
+        switch (in->type) {
+            case PT_I32: { int32_t v; memcpy(&v, in->data, 4); err = nvs_set_i32(h, in->key, v); break; }
+            case PT_U32: { uint32_t v; memcpy(&v, in->data, 4); err = nvs_set_u32(h, in->key, v); break; }
+            case PT_U8:  err = nvs_set_u8(h, in->key, in->data[0]); break;
+            default:     err = nvs_set_blob(h, in->key, in->data, in->len); break;
+        }
+        if (err == ESP_OK) {
+            written++;
+            dirty[in->ns] = true;
+        } else {
+            errors++;
+        }
+    }
+
+    for (int ns = 0; ns < PERSIST_NS_COUNT; ns++) {
+        if (!dirty[ns]) continue;
+        if (nvs_commit(handles[ns]) == ESP_OK) commits++;
+        else errors++;
+    }
+
+    pending_count = 0;
+    uint32_t us = micros() - start;
+    portENTER_CRITICAL(&persist_mux);
+    stats.keys_written += written;
+    stats.commits += commits;
+    stats.errors += errors;
+    if (us > stats.commit_max_us) stats.commit_max_us = us;
+    portEXIT_CRITICAL(&persist_mux);
+}
+
+static void absorb(const PersistIntent* in) {
+    for (int i = 0; i < pending_count; i++) {
+        PersistIntent* p = &pending[i];
+        if (p->ns == in->ns && strcmp(p->key, in->key) == 0) {
+            if ((int32_t)(in->seq - p->seq) > 0) *p = *in; // Else older (from the queue after an overflow)
+            STAT_ADD(coalesced, 1);
+            return;
+        }
+    }
+    if (pending_count == PERSIST_MAX_PENDING) commit(); // Batch full: write it out early
+    if (pending_count == 0) first_pending_ms = millis();
+    pending[pending_count++] = *in;
+}
+
+void persistService(bool block) {
+    TickType_t wait = 0;
+    if (block) {
+        if (pending_count == 0) {
+            wait = portMAX_DELAY;
+        } else {
+            uint32_t age = millis() - first_pending_ms;
+            wait = age >= PERSIST_COMMIT_MS ? 0 : pdMS_TO_TICKS(PERSIST_COMMIT_MS - age);
+        }
+    }
+
+    // Block for the first intent, then take whatever else is queued
+    uint32_t sync_seq = 0;
+    PersistIntent in;
+    if (xQueueReceive(queue, &in, wait) == pdTRUE) {
+        do {
+            if (in.type == PT_SYNC) memcpy(&sync_seq, in.data, sizeof(sync_seq));
+            else absorb(&in);
+        } while (xQueueReceive(queue, &in, 0) == pdTRUE);
+
+        // Then what overflowed while the queue was full (a sync behind it commits it too)
+        static PersistIntent spill[PERSIST_OVERFLOW_SLOTS];    // Task side, off the 3K stack
+        portENTER_CRITICAL(&persist_mux);
+        int n = overflow_count;
+        memcpy(spill, overflow, n * sizeof(PersistIntent));
+        overflow_count = 0;
+        portEXIT_CRITICAL(&persist_mux);
+        for (int i = 0; i < n; i++) absorb(&spill[i]);
+    }
+
+    if (pending_count > 0 && (sync_seq || millis() - first_pending_ms >= PERSIST_COMMIT_MS)) commit();
+    if (sync_seq) sync_done.store(sync_seq);
+    portENTER_CRITICAL(&persist_mux);
+    stats.pending = pending_count;
+    portEXIT_CRITICAL(&persist_mux);
+}
+
+static void persist_task(void* arg) {
+    for (;;) persistService(true);
+}
+
+void initPersist() {
+    if (queue) return;
+    for (int ns = 0; ns < PERSIST_NS_COUNT; ns++) {
+        ns_open[ns] = nvs_open(ns_names[ns], NVS_READWRITE, &handles[ns]) == ESP_OK;
+        if (!ns_open[ns]) Serial.printf("Persist: Failed to open NVS namespace \"%s\"\n", ns_names[ns]);
+    }
+    queue = xQueueCreate(PERSIST_QUEUE_LEN, sizeof(PersistIntent));
+    xTaskCreate(persist_task, "Persist", PERSIST_TASK_STACK_SIZE, NULL, PERSIST_TASK_PRIORITY, &persist_task_handle);
+}
+
+bool persistSync(uint32_t timeout_ms) {
+    if (!queue) return false;
+    uint32_t seq = sync_requested.fetch_add(1) + 1;
+    PersistIntent in = {0};
+    in.type = PT_SYNC;
+    memcpy(in.data, &seq, sizeof(seq));
+    // Behind every intent already queued; wait for room rather than lose it
+    if (xQueueSend(queue, &in, pdMS_TO_TICKS(timeout_ms)) != pdTRUE) return false;
+
+    uint32_t start = millis();
+    while ((int32_t)(sync_done.load() - seq) < 0) {
+        if (!persist_task_handle) {
+            persistService(false); // No task (host tools): run it here
+            continue;
+        }
+        if (millis() - start >= timeout_ms) return false;
+        delay(5);
+    }
+    return true;
+}
+
+void getPersistStats(PersistStats* out) {
+    if (!out) return;
+    portENTER_CRITICAL(&persist_mux);
+    *out = stats;
+    portEXIT_CRITICAL(&persist_mux);
+}
@@ -0,0 +1,67 @@
+/*
+ * File: persist.h
+ * Description: Background NVS Persistence Service ("imu", "ui" and "web" namespaces)
+ * Author: zzackk125
+ * License: MIT
+ *
+ * Settings code never touches flash: persistPut*() queues a typed write
+ * intent and returns. The persistence task folds repeated writes to a key
+ * into one pending value and commits the batch (one nvs_commit() per
+ * namespace) PERSIST_COMMIT_MS after the first change, or straight away on
+ * persistSync(). Value types match Preferences, so existing settings load.
+ * When writers outrun the task and the queue fills, the newest value per key
+ * is kept aside (PERSIST_OVERFLOW_SLOTS) rather than dropped.
+ *
+ * Reads go straight to NVS and are meant for init time: a value still
+ * pending in the task isn't visible to them.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define PERSIST_MAX_KEY    15   // NVS key length limit
+#define PERSIST_MAX_BYTES  12   // persistPutBytes payload (warm start bias)
+
+enum PersistNs : uint8_t {
+    PERSIST_IMU = 0,
+    PERSIST_UI,
+    PERSIST_WEB,
+    PERSIST_NS_COUNT
+};
+
+struct PersistStats {
+    uint32_t intents;        // persistPut* calls
+    uint32_t coalesced;      // Replaced a value still pending
+    uint32_t dropped;        // Queue and overflow slots full (more keys than PERSIST_OVERFLOW_SLOTS)
+    uint32_t commits;        // nvs_commit() calls
+    uint32_t keys_written;
+    uint32_t errors;
+    uint32_t commit_max_us;  // Longest batch (all namespaces)
+    uint16_t pending;
+};
+
+void initPersist();          // Open the namespaces, start the task (setup, before settings load)
+
+void persistPutInt(PersistNs ns, const char* key, int32_t v);
+void persistPutUInt(PersistNs ns, const char* key, uint32_t v);
+void persistPutFloat(PersistNs ns, const char* key, float v);
+void persistPutBool(PersistNs ns, const char* key, bool v);
+void persistPutBytes(PersistNs ns, const char* key, const void* data, size_t len);
+
+int32_t persistGetInt(PersistNs ns, const char* key, int32_t def);
+uint32_t persistGetUInt(PersistNs ns, const char* key, uint32_t def);
+float persistGetFloat(PersistNs ns, const char* key, float def);
+bool persistGetBool(PersistNs ns, const char* key, bool def);
+size_t persistGetBytes(PersistNs ns, const char* key, void* out, size_t len); // 0 = missing / wrong size
+
+// Commit everything queued so far and wait for it (before a reboot).
+// False on timeout.
+bool persistSync(uint32_t timeout_ms);
+
+void getPersistStats(PersistStats* out);
+
+// One pass of the persistence task: absorb queued intents, commit when due.
+// block = wait for the next intent or deadline. Host tools call it directly.
+void persistService(bool block);
@@ -0,0 +1,135 @@
+/*
+ * File: power.cpp
+ * Description: Motion-Aware Power Management Implementation
+ * Author: zzackk125
+ * License: MIT
+ */
+
+#include "power.h"
+#include "power_policy.h"
+#include "board_config.h"
+#include "lvgl_port.h"
+#include "imu_driver.h"
+#include "imu_recorder.h"
+#include "web_server.h"
+#include <Arduino.h>
+#include <esp_sleep.h>
+#include <driver/gpio.h>
+#include <atomic>
+
+static PowerPolicy policy;
+static PowerStats stats = {0};
+static std::atomic<bool> activity(false);
+static bool ready = false;
+
+static void applyState(uint8_t state) {
+    bool full = (state == PWR_ACTIVE);
+    lvgl_port_lock(-1);
+    lvgl_port_set_refresh_period(full ? 0 : POWER_STILL_REFR_MS);
+    lvgl_port_set_brightness(state == PWR_DIM ? POWER_DIM_BRIGHTNESS : 255);
+    lvgl_port_unlock();
+    setIMUTaskPeriod(full ? IMU_TASK_PERIOD_MS : POWER_STILL_IMU_PERIOD_MS);
+}
+
+// Panel off, IMU parked on wake-on-motion, light sleep in POWER_SLEEP_POLL_MS
+// steps until motion or the BOOT button. Holding the LVGL lock keeps the
+// render task off the SPI bus for the whole time.
+static void sleepUntilWake() {
+    lvgl_port_lock(-1);
+    lvgl_port_set_brightness(0);
+    lvgl_port_display_on(false);
+
+    if (!parkIMU(POWER_WOM_MG, 100)) {
+        Serial.println("Power: IMU didn't park, staying awake");
+        lvgl_port_display_on(true);
+        lvgl_port_unlock();
+        pwrActivity(&policy, millis());
+        applyState(policy.state);
+        return;
+    }
+    Serial.println("Power: Light sleep (wake on motion)");
+    stats.sleeps++;
+
+    esp_sleep_enable_timer_wakeup((uint64_t)POWER_SLEEP_POLL_MS * 1000);
+#if IMU_INT_PIN >= 0
+    // WoM toggles INT2: wake straight away instead of at the next poll
+    gpio_wakeup_enable((gpio_num_t)IMU_INT_PIN, GPIO_INTR_HIGH_LEVEL);
+    esp_sleep_enable_gpio_wakeup();
+#endif
+    for (;;) {
+        Serial.flush();
+        esp_light_sleep_start();
+        stats.sleep_polls++;
+        if (pollIMUWakeOnMotion() || digitalRead(BOOT_BUTTON_PIN) == LOW || activity.load()) break;
+    }
+
+    uint32_t start = micros();
+    esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_TIMER);
+#if IMU_INT_PIN >= 0
+    esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_GPIO);
+    gpio_wakeup_disable((gpio_num_t)IMU_INT_PIN);
+    gpio_set_intr_type((gpio_num_t)IMU_INT_PIN, GPIO_INTR_POSEDGE); // Back to the FIFO watermark edge
+#endif
+    unparkIMU();
+    lvgl_port_display_on(true);
+    lvgl_port_unlock();
+    pwrWake(&policy, millis());
+    applyState(PWR_ACTIVE);
+
+    uint32_t us = micros() - start;
+    if (us > stats.resume_max_us) stats.resume_max_us = us;
+    Serial.printf("Power: Awake (%lu us to full rate)\n", (unsigned long)us);
+}
+
+void initPower() {
+    PowerConfig cfg = {
+        POWER_STILL_GYRO_DPS * 1000UL, POWER_STILL_ACC_MG,
+        POWER_STILL_MS, POWER_DIM_MS, POWER_SLEEP_MS,
+    };
+    pwrInit(&policy, &cfg, millis());
+    ready = true;
+}
+
+void servicePower() {
+#if POWER_ENABLE
+    if (!ready) return;
+    uint32_t now = millis();
+    IMUMotion m;
+    readIMUMotion(&m);
+
+    // AP mode and recording need the radio / samples; a faulted IMU can't wake us
+    IMUHealthStats hs;
+    getIMUHealthStats(&hs);
+    bool hold_awake = isAPMode() || isRecording() || hs.fault != IMU_FAULT_NONE;
+
+    bool changed = false;
+    if (activity.exchange(false)) changed = pwrActivity(&policy, now);
+    if (pwrUpdate(&policy, now, m.gyro_mdps, m.acc_mg, hold_awake)) changed = true;
+    if (!changed) return;
+
+    Serial.printf("Power: %s\n", pwrStateName(policy.state));
+    if (policy.state == PWR_SLEEP) sleepUntilWake();
+    else applyState(policy.state);
+#endif
+}
+
+void powerNoteActivity() {
+    activity.store(true);
+}
+
+uint32_t getPowerUIPeriodMs() {
+    return (policy.state == PWR_ACTIVE) ? LOOP_UI_PERIOD_MS : POWER_STILL_UI_PERIOD_MS;
+}
+
+void getPowerStats(PowerStats* out) {
+    if (!out) return;
+    stats.state = policy.state;
+    stats.transitions = policy.transitions;
+    stats.wakes = policy.wakes;
+    for (int i = 0; i < PWR_STATE_COUNT; i++) stats.time_ms[i] = policy.time_ms[i];
+    *out = stats;
+}
+
+const char* getPowerStateName() {
+    return pwrStateName(policy.state);
+}
@@ -0,0 +1,33 @@
+/*
+ * File: power.h
+ * Description: Motion-Aware Power Management (frame rate, dimming, light sleep)
+ * Author: zzackk125
+ * License: MIT
+ *
+ * Runs power_policy.h on the IMU's motion peaks and applies each state:
+ * slower LVGL refresh / UI job / IMU drain while still, a dimmed panel, and
+ * finally light sleep with the QMI8658 wake-on-motion armed. servicePower()
+ * sleeps in place (the loop stalls there) until motion or the BOOT button,
+ * checked every POWER_SLEEP_POLL_MS, then restores full rate.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+struct PowerStats {
+    uint8_t state;              // PowerState
+    uint32_t transitions;
+    uint32_t sleeps;            // Light sleep entries
+    uint32_t sleep_polls;       // Timer / GPIO wakeups while asleep
+    uint32_t wakes;
+    uint32_t resume_max_us;     // Wakeup -> full rate restored
+    uint32_t time_ms[4];        // Per PowerState
+};
+
+void initPower();
+void servicePower();            // Loop job, every POWER_POLL_MS
+void powerNoteActivity();       // User input (any task): back to full rate
+uint32_t getPowerUIPeriodMs();  // Loop UI job period for the current state
+void getPowerStats(PowerStats* out);
+const char* getPowerStateName();
@@ -0,0 +1,75 @@
+/*
+ * File: power_policy.cpp
+ * Description: Motion-Aware Power State Machine Implementation
+ * Author: zzackk125
+ * License: MIT
+ */
+
+#include "power_policy.h"
+#include <string.h>
+
+static void setState(PowerPolicy* p, uint8_t state, uint32_t now_ms) {
+    if (p->state == state) return;
+    p->state = state;
+    p->state_since_ms = now_ms;
+    p->transitions++;
+}
+
+// Time bookkeeping for the state we've been in since the last call
+static void account(PowerPolicy* p, uint32_t now_ms) {
+    p->time_ms[p->state] += now_ms - p->last_ms;
+    p->last_ms = now_ms;
+}
+
+void pwrInit(PowerPolicy* p, const PowerConfig* cfg, uint32_t now_ms) {
+    memset(p, 0, sizeof(*p));
+    p->cfg = *cfg;
+    p->state = PWR_ACTIVE;
+    p->idle_since_ms = now_ms;
+    p->state_since_ms = now_ms;
+    p->last_ms = now_ms;
+}
+
+bool pwrUpdate(PowerPolicy* p, uint32_t now_ms, uint32_t gyro_mdps, uint32_t acc_mg, bool hold_awake) {
+    account(p, now_ms);
+    if (p->state == PWR_SLEEP) return false; // IMU parked: only pwrWake() leaves
+
+    uint8_t prev = p->state;
+    if (gyro_mdps > p->cfg.still_gyro_mdps || acc_mg > p->cfg.still_acc_mg) {
+        p->idle_since_ms = now_ms;
+        setState(p, PWR_ACTIVE, now_ms);
+        return p->state != prev;
+    }
+
+    uint32_t idle = now_ms - p->idle_since_ms;
+    uint8_t target = PWR_ACTIVE;
+    if (p->cfg.still_ms && idle >= p->cfg.still_ms) target = PWR_STILL;
+    if (p->cfg.dim_ms && idle >= p->cfg.dim_ms) target = PWR_DIM;
+    if (p->cfg.sleep_ms && idle >= p->cfg.sleep_ms && !hold_awake) target = PWR_SLEEP;
+    setState(p, target, now_ms);
+    return p->state != prev;
+}
+
+bool pwrActivity(PowerPolicy* p, uint32_t now_ms) {
+    account(p, now_ms);
+    p->idle_since_ms = now_ms;
+    if (p->state == PWR_ACTIVE) return false;
+    if (p->state == PWR_SLEEP) p->wakes++;
+    setState(p, PWR_ACTIVE, now_ms);
+    return true;
+}
+
+void pwrWake(PowerPolicy* p, uint32_t now_ms) {
+    if (p->state != PWR_SLEEP) return;
+    pwrActivity(p, now_ms);
+}
+
+const char* pwrStateName(uint8_t state) {
+    switch (state) {
+        case PWR_ACTIVE: return "active";
+        case PWR_STILL:  return "still";
+        case PWR_DIM:    return "dim";
+        case PWR_SLEEP:  return "sleep";
+        default:         return "?";
+    }
+}
@@ -0,0 +1,68 @@
+/*
+ * File: power_policy.h
+ * Description: Motion-Aware Power State Machine - No Arduino dependencies
+ * Author: zzackk125
+ * License: MIT
+ *
+ * Fed the peak gyro rate and accel deviation from 1g seen since the last
+ * step. While both stay under the stillness thresholds the idle time grows:
+ *
+ *   ACTIVE  full rate
+ *   STILL   still for still_ms: slower UI refresh and IMU drain
+ *   DIM     still for dim_ms: panel dimmed as well
+ *   SLEEP   still for sleep_ms: panel off, light sleep, wake on motion
+ *
+ * Motion or user input goes straight back to ACTIVE. While asleep the IMU
+ * is parked, so only pwrWake() (wake-on-motion, button) leaves SLEEP.
+ * hold_awake (AP mode, recording) caps the state at DIM.
+ *
+ * The clock is passed in so tools/imu_replay --power can run it on
+ * recorded logs.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+enum PowerState : uint8_t {
+    PWR_ACTIVE = 0,
+    PWR_STILL,
+    PWR_DIM,
+    PWR_SLEEP,
+    PWR_STATE_COUNT
+};
+
+struct PowerConfig {
+    uint32_t still_gyro_mdps;  // Any axis above this is motion
+    uint32_t still_acc_mg;     // | |a| - 1g | above this is motion
+    uint32_t still_ms;         // Idle time before each state (0 = never)
+    uint32_t dim_ms;
+    uint32_t sleep_ms;
+};
+
+struct PowerPolicy {
+    PowerConfig cfg;
+    uint8_t state;
+    uint32_t idle_since_ms;    // Last motion or user input
+    uint32_t state_since_ms;
+    uint32_t last_ms;
+
+    // Stats
+    uint32_t transitions;
+    uint32_t wakes;            // SLEEP -> ACTIVE
+    uint32_t time_ms[PWR_STATE_COUNT];
+};
+
+void pwrInit(PowerPolicy* p, const PowerConfig* cfg, uint32_t now_ms);
+
+// One policy step with the motion peaks since the previous one.
+// Returns true when the state changed.
+bool pwrUpdate(PowerPolicy* p, uint32_t now_ms, uint32_t gyro_mdps, uint32_t acc_mg, bool hold_awake);
+
+// Touch / button / web: back to ACTIVE and restart the idle time. True on a change.
+bool pwrActivity(PowerPolicy* p, uint32_t now_ms);
+
+// Left light sleep (wake-on-motion or button)
+void pwrWake(PowerPolicy* p, uint32_t now_ms);
+
+const char* pwrStateName(uint8_t state);
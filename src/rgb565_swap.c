@@ -0,0 +1,43 @@
+/*
+ * File: rgb565_swap.c
+ * Description: RGB565 Byte Swap Kernel Implementation
+ * Author: zzackk125
+ * License: MIT
+ */
+
+#include "rgb565_swap.h"
+
+static inline uint32_t swap2(uint32_t w)
+{
+  return ((w & 0x00FF00FFu) << 8) | ((w >> 8) & 0x00FF00FFu);
+}
+
+void rgb565_swap(uint16_t *px, uint32_t count)
+{
+  // Head: LVGL draw buffers are word aligned, so normally nothing
+  if (((uintptr_t)px & 2) && count) {
+    *px = (uint16_t)((*px << 8) | (*px >> 8));
+    px++;
+    count--;
+  }
+
+  uint32_t *w = (uint32_t *)px;
+  uint32_t words = count / 2;
+  while (words >= 4) {
+    w[0] = swap2(w[0]);
+    w[1] = swap2(w[1]);
+    w[2] = swap2(w[2]);
+    w[3] = swap2(w[3]);
+    w += 4;
+    words -= 4;
+  }
+  while (words--) {
+    *w = swap2(*w);
+    w++;
+  }
+
+  if (count & 1) {
+    px = (uint16_t *)w;
+    *px = (uint16_t)((*px << 8) | (*px >> 8));
+  }
+}
@@ -0,0 +1,26 @@
+/*
+ * File: rgb565_swap.h
+ * Description: RGB565 Byte Swap Kernel (Panel Byte Order)
+ * Author: zzackk125
+ * License: MIT
+ *
+ * The SH8601 takes big-endian RGB565. With LCD_NATIVE_SWAP LVGL renders that
+ * order directly and nothing is swapped; otherwise the flush callback runs
+ * this over each chunk. Two pixels per 32-bit word: the C6 has no byte
+ * reverse instruction, so it's two masks and two shifts per word.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// In place. Any alignment and count (word loop on the aligned middle).
+void rgb565_swap(uint16_t *px, uint32_t count);
+
+#ifdef __cplusplus
+}
+#endif
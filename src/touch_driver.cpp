@@ -7,6 +7,8 @@
 
 #include "touch_driver.h"
 #include "board_config.h"
+#include "i2c_bus.h"
+#include "power.h"
 
 static void touch_read_cb(lv_indev_t * indev, lv_indev_data_t * data);
 static int touch_rotation = 0;
@@ -23,20 +25,15 @@ void initTouch() {
 }
 
 static void touch_read_cb(lv_indev_t * indev, lv_indev_data_t * data) {
-    uint8_t cmd = 0x02;
-    uint8_t buf[5] = {0};
+    static lv_indev_state_t last_state = LV_INDEV_STATE_RELEASED;
+    static lv_point_t last_point = {0, 0};
+    uint8_t buf[5] = {0}; // Status, X High, X Low, Y High, Y Low
 
-    Wire.beginTransmission(DISP_TOUCH_ADDR);
-    Wire.write(cmd);
-    Wire.endTransmission();
-
-    Wire.requestFrom(DISP_TOUCH_ADDR, 5);
-    if (Wire.available() == 5) {
-        buf[0] = Wire.read(); // Status
-        buf[1] = Wire.read(); // X High
-        buf[2] = Wire.read(); // X Low
-        buf[3] = Wire.read(); // Y High
-        buf[4] = Wire.read(); // Y Low
+    // Shared bus: if the IMU holds it, report the previous state and poll next time
+    if (!i2cReadRegs(I2C_DEV_TOUCH, DISP_TOUCH_ADDR, 0x02, buf, sizeof(buf))) {
+        data->point = last_point;
+        data->state = last_state;
+        return;
     }
 
     if (buf[0]) { // Touch detected
@@ -61,7 +58,10 @@ static void touch_read_cb(lv_indev_t * indev, lv_indev_data_t * data) {
             data->point.y = tp_y;
         }
         data->state = LV_INDEV_STATE_PRESSED;
+        powerNoteActivity(); // Dimmed panel: first touch brings it back
     } else {
         data->state = LV_INDEV_STATE_RELEASED;
     }
+    last_point = data->point;
+    last_state = data->state;
 }
@@ -0,0 +1,207 @@
+/*
+ * File: truck_cache.cpp
+ * Description: LRU Cache of Rotated / Scaled Truck Images Implementation
+ * Author: zzackk125
+ * License: MIT
+ */
+
+#include "truck_cache.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int32_t quantize(int32_t rotation, uint16_t step) {
+    int32_t half = step / 2;
+    return (rotation >= 0 ? rotation + half : rotation - half) / step;
+}
+
+static const uint8_t* srcPixel(const lv_image_dsc_t* src, int x, int y) {
+    uint32_t stride = src->header.stride ? src->header.stride : src->header.w * 4;
+    return src->data + (size_t)y * stride + (size_t)x * 4;
+}
+
+bool truckCacheInit(TruckCache* tc, const lv_image_dsc_t* src, int pivot_x, int pivot_y, uint16_t scale,
+                    uint16_t step, int slots) {
+    memset(tc, 0, sizeof(*tc));
+    tc->src = src;
+    tc->pivot_x = pivot_x;
+    tc->pivot_y = pivot_y;
+    tc->scale = scale ? scale : 256;
+    tc->step = step ? step : 1;
+    for (int i = 0; i < TRUCK_CACHE_MAX_SLOTS; i++) tc->entry[i].key = TRUCK_CACHE_EMPTY;
+    if (!src || src->header.cf != LV_COLOR_FORMAT_ARGB8888) return false;
+
+    // Content bounds, and the farthest content corner from the pivot's centre
+    tc->cx1 = src->header.w;
+    tc->cy1 = src->header.h;
+    tc->cx2 = tc->cy2 = -1;
+    float r2 = 0;
+    for (int y = 0; y < (int)src->header.h; y++) {
+        for (int x = 0; x < (int)src->header.w; x++) {
+            if (srcPixel(src, x, y)[3] == 0) continue;
+            if (x < tc->cx1) tc->cx1 = x;
+            if (x > tc->cx2) tc->cx2 = x;
+            if (y < tc->cy1) tc->cy1 = y;
+            if (y > tc->cy2) tc->cy2 = y;
+            float dx = fabsf(x - pivot_x) + 0.5f, dy = fabsf(y - pivot_y) + 0.5f;
+            if (dx * dx + dy * dy > r2) r2 = dx * dx + dy * dy;
+        }
+    }
+    if (tc->cx2 < 0) return false;
+
+    // Even, and one pixel of bilinear spread each side
+    tc->side = 2 * (uint16_t)ceilf(sqrtf(r2) * tc->scale / 256.0f + 1);
+
+    if (slots > TRUCK_CACHE_MAX_SLOTS) slots = TRUCK_CACHE_MAX_SLOTS;
+    size_t slot_bytes = (size_t)tc->side * tc->side * 3;
+    while (tc->slots < slots) {
+        uint8_t* buf = (uint8_t*)malloc(slot_bytes);
+        if (!buf) break;
+        tc->entry[tc->slots++].buf = buf;
+    }
+    tc->stats.slots = tc->slots;
+    tc->stats.bytes = tc->slots * slot_bytes;
+    return tc->slots > 0;
+}
+
+void truckCacheFree(TruckCache* tc) {
+    for (int i = 0; i < tc->slots; i++) {
+        free(tc->entry[i].buf);
+        tc->entry[i].buf = NULL;
+        tc->entry[i].key = TRUCK_CACHE_EMPTY;
+    }
+    tc->slots = 0;
+    tc->stats.slots = 0;
+    tc->stats.bytes = 0;
+}
+
+// Inverse-map every pixel of the rotated content's bounding box into the
+// source and sample it bilinearly (16.16 fixed point, colour weighted by alpha)
+static void render(TruckCache* tc, TruckCacheEntry* e, int32_t key) {
+    const lv_image_dsc_t* src = tc->src;
+    float rad = (float)key * tc->step * (float)M_PI / 1800.0f;
+    float c = cosf(rad), s = sinf(rad), k = tc->scale / 256.0f;
+
+    // Content rectangle's corners, turned about the pivot
+    float ex[2] = { tc->cx1 - 0.5f - tc->pivot_x, tc->cx2 + 0.5f - tc->pivot_x };
+    float ey[2] = { tc->cy1 - 0.5f - tc->pivot_y, tc->cy2 + 0.5f - tc->pivot_y };
+    float x1 = 1e9f, y1 = 1e9f, x2 = -1e9f, y2 = -1e9f;
+    for (int i = 0; i < 4; i++) {
+        float dx = ex[i & 1], dy = ey[i >> 1];
+        float x = k * (dx * c - dy * s), y = k * (dx * s + dy * c);
+        x1 = fminf(x1, x); x2 = fmaxf(x2, x);
+        y1 = fminf(y1, y); y2 = fmaxf(y2, y);
+    }
+    int half = tc->side / 2;
+    int ix1 = (int)floorf(x1), iy1 = (int)floorf(y1), ix2 = (int)ceilf(x2), iy2 = (int)ceilf(y2);
+    if (ix1 < -half) ix1 = -half;
+    if (iy1 < -half) iy1 = -half;
+    if (ix2 > half - 1) ix2 = half - 1;
+    if (iy2 > half - 1) iy2 = half - 1;
+    int w = ix2 - ix1 + 1, h = iy2 - iy1 + 1;
+
+    // Source step per destination pixel
+    int32_t ux = (int32_t)lroundf(c / k * 65536), vx = (int32_t)lroundf(-s / k * 65536);
+    int32_t uy = (int32_t)lroundf(s / k * 65536), vy = (int32_t)lroundf(c / k * 65536);
+    const int sw = src->header.w, sh = src->header.h;
+
+    uint8_t tr = (tc->tint >> 16) & 0xFF, tg = (tc->tint >> 8) & 0xFF, tb = tc->tint & 0xFF;
+    uint32_t topa = tc->tint_opa;
+
+    uint16_t* rgb = (uint16_t*)e->buf;
+    uint8_t* alpha = e->buf + (size_t)w * h * 2;
+    for (int y = 0; y < h; y++) {
+        int32_t u = (tc->pivot_x << 16) + ix1 * ux + (iy1 + y) * uy;
+        int32_t v = (tc->pivot_y << 16) + ix1 * vx + (iy1 + y) * vy;
+        for (int x = 0; x < w; x++, u += ux, v += vx) {
+            int xi = u >> 16, yi = v >> 16;
+            uint32_t fx = (u >> 8) & 0xFF, fy = (v >> 8) & 0xFF;
+            uint32_t a_acc = 0, r_acc = 0, g_acc = 0, b_acc = 0;
+            for (int t = 0; t < 4; t++) {
+                int sx = xi + (t & 1), sy = yi + (t >> 1);
+                if (sx < 0 || sy < 0 || sx >= sw || sy >= sh) continue;
+                const uint8_t* p = srcPixel(src, sx, sy);
+                if (p[3] == 0) continue;
+                uint32_t wa = ((t & 1) ? fx : 256 - fx) * ((t >> 1) ? fy : 256 - fy) * p[3];
+                a_acc += wa;
+                b_acc += (wa >> 8) * p[0];
+                g_acc += (wa >> 8) * p[1];
+                r_acc += (wa >> 8) * p[2];
+            }
+            size_t i = (size_t)y * w + x;
+            alpha[i] = (uint8_t)((a_acc + 32768) >> 16);
+            if (a_acc < 256) {
+                rgb[i] = 0;
+                continue;
+            }
+            uint32_t n = a_acc >> 8;
+            uint32_t r = r_acc / n, g = g_acc / n, b = b_acc / n;
+            if (topa) {
+                r = (tr * topa + r * (255 - topa)) / 255;
+                g = (tg * topa + g * (255 - topa)) / 255;
+                b = (tb * topa + b * (255 - topa)) / 255;
+            }
+            rgb[i] = (uint16_t)(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3));
+        }
+    }
+
+    // LVGL may hold a decoded copy of the slot's previous rendering
+    lv_image_cache_drop(&e->dsc);
+    memset(&e->dsc, 0, sizeof(e->dsc));
+    e->dsc.header.magic = LV_IMAGE_HEADER_MAGIC;
+    e->dsc.header.cf = LV_COLOR_FORMAT_RGB565A8;
+    e->dsc.header.w = w;
+    e->dsc.header.h = h;
+    e->dsc.header.stride = w * 2;
+    e->dsc.data_size = (uint32_t)w * h * 3;
+    e->dsc.data = e->buf;
+    e->ox = ix1;
+    e->oy = iy1;
+    e->key = key;
+}
+
+const TruckCacheEntry* truckCacheGet(TruckCache* tc, int32_t rotation) {
+    if (!tc->slots) return NULL;
+    int32_t key = quantize(rotation, tc->step);
+    tc->tick++;
+
+    TruckCacheEntry* lru = &tc->entry[0];
+    for (int i = 0; i < tc->slots; i++) {
+        TruckCacheEntry* e = &tc->entry[i];
+        if (e->key == key) {
+            e->last_use = tc->tick;
+            tc->stats.hits++;
+            return e;
+        }
+        // Unused slots first, then the least recently used
+        if (lru->key != TRUCK_CACHE_EMPTY &&
+            (e->key == TRUCK_CACHE_EMPTY || (int32_t)(e->last_use - lru->last_use) < 0)) {
+            lru = e;
+        }
+    }
+
+    if (lru->key != TRUCK_CACHE_EMPTY) tc->stats.evictions++;
+    tc->stats.misses++;
+    render(tc, lru, key);
+    lru->gen = tc->stats.misses;
+    lru->last_use = tc->tick;
+    return lru;
+}
+
+void truckCacheFlush(TruckCache* tc) {
+    for (int i = 0; i < tc->slots; i++) tc->entry[i].key = TRUCK_CACHE_EMPTY;
+}
+
+void truckCacheSetTint(TruckCache* tc, uint32_t rgb, uint8_t opa) {
+    rgb &= 0xFFFFFF;
+    if (opa == 0) rgb = 0;
+    if (rgb == tc->tint && opa == tc->tint_opa) return;
+    tc->tint = rgb;
+    tc->tint_opa = opa;
+    truckCacheFlush(tc);
+    tc->stats.flushes++;
+}
+
+void getTruckCacheStats(const TruckCache* tc, TruckCacheStats* out) {
+    if (out) *out = tc->stats;
+}
@@ -0,0 +1,77 @@
+/*
+ * File: truck_cache.h
+ * Description: LRU Cache of Rotated / Scaled Truck Images - No Arduino dependencies
+ * Author: zzackk125
+ * License: MIT
+ *
+ * Holds a few renderings of one ARGB8888 image, rotated (and scaled) about
+ * its pivot, keyed by the rotation rounded to TRUCK_CACHE_STEP. updateUI()
+ * shows the returned RGB565A8 image untransformed, so a truck held at one
+ * angle, or rocking across a step boundary, is blended as a plain bitmap
+ * instead of being transformed by LVGL on every redraw.
+ *
+ * The slots are allocated once in truckCacheInit(): memory stays at
+ * slots x side x side x 3 bytes, where side covers the image's content at
+ * any angle. A miss renders into the least recently used slot. The theme
+ * tint is baked into the renderings; changing it empties the cache.
+ * tools/truck_cache_sim tests and benchmarks it on the host.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <lvgl.h>
+
+#define TRUCK_CACHE_MAX_SLOTS 8
+#define TRUCK_CACHE_EMPTY     INT32_MIN
+
+struct TruckCacheEntry {
+    lv_image_dsc_t dsc;    // RGB565A8, header.w/h = the rendering's bounding box
+    int16_t ox, oy;        // Top left of dsc relative to the pivot, on screen
+    int32_t key;           // Rotation / step, TRUCK_CACHE_EMPTY = unused
+    uint32_t gen;          // stats.misses when rendered: changes whenever the pixels do
+    uint32_t last_use;
+    uint8_t* buf;          // side x side x 3 bytes
+};
+
+struct TruckCacheStats {
+    uint32_t hits;
+    uint32_t misses;       // Renderings (each one replaced a slot's content)
+    uint32_t evictions;    // Misses that dropped a live rendering
+    uint32_t flushes;      // Tint changes
+    uint32_t bytes;        // Slot memory
+    uint8_t slots;
+};
+
+struct TruckCache {
+    const lv_image_dsc_t* src; // ARGB8888
+    int16_t pivot_x, pivot_y;  // Source pixel the image turns about
+    uint16_t scale;            // 256 = 1x
+    uint16_t step;             // Key quantum, 0.1 deg
+    uint16_t side;             // Slot width and height
+    int16_t cx1, cy1, cx2, cy2; // Source pixels with alpha > 0
+
+    uint32_t tint;             // 0xRRGGBB
+    uint8_t tint_opa;          // 0 = native colours
+
+    uint8_t slots;
+    uint32_t tick;
+    TruckCacheEntry entry[TRUCK_CACHE_MAX_SLOTS];
+    TruckCacheStats stats;
+};
+
+// False if no slot could be allocated (the caller keeps transforming src).
+// slots is clamped to TRUCK_CACHE_MAX_SLOTS and reduced until it fits in the heap.
+bool truckCacheInit(TruckCache* tc, const lv_image_dsc_t* src, int pivot_x, int pivot_y, uint16_t scale,
+                    uint16_t step, int slots);
+void truckCacheFree(TruckCache* tc);
+
+// The rendering for rotation (0.1 deg, clockwise, as lv_image_set_rotation()).
+// Valid until the next truckCacheGet() / truckCacheSetTint() on this cache.
+const TruckCacheEntry* truckCacheGet(TruckCache* tc, int32_t rotation);
+
+// Recolor baked into the renderings (image_recolor / image_recolor_opa); empties the cache on change
+void truckCacheSetTint(TruckCache* tc, uint32_t rgb, uint8_t opa);
+
+void truckCacheFlush(TruckCache* tc);
+void getTruckCacheStats(const TruckCache* tc, TruckCacheStats* out);
@@ -10,9 +10,10 @@
 #include "assets.h"
 #include <stdio.h>
 #include "imu_driver.h" // For calibration access if needed, or we pass callback
-#include <Preferences.h>
+#include "persist.h"
 #include "lvgl_port.h" // For hardware rotation
 #include "touch_driver.h" // For touch rotation
+#include "truck_cache.h"
 
 LV_FONT_DECLARE(lv_font_montserrat_28);
 LV_FONT_DECLARE(lv_font_montserrat_48);
@@ -38,6 +39,14 @@ static lv_obj_t * lbl_critical_dynamic; // Single Object
 // Types: 0=Pitch, 1=Roll, 2=Both
 static lv_obj_t * overlay_status; // New stable container for status
 static lv_obj_t * lbl_status_dynamic; // Single Object
+static lv_obj_t * lbl_imu_fault; // IMU health watchdog: angles are stale
+static bool imu_degraded = false;
+
+// Truck renderings (truck_cache.h); no slots = LVGL transforms the source image
+static TruckCache roll_cache;
+static TruckCache pitch_cache;
+static uint32_t roll_shown_gen = 0;
+static uint32_t pitch_shown_gen = 0;
 
 // Max Angle Markers
 static lv_obj_t * dot_roll_left;
@@ -57,7 +66,6 @@ static float session_roll_left = 0;
 static float session_roll_right = 0;
 static float session_pitch_fwd = 0;
 static float session_pitch_back = 0;
-static Preferences ui_prefs;
 
 // Settings
 static int ui_rotation = 0;
@@ -76,6 +84,7 @@ static lv_color_t theme_colors[] = {
     lv_color_hex(0x9C27B0),
     lv_color_hex(0xFFEB3B)
 };
+#define POINTER_COLOR lv_color_hex(0xFF3D00) // Native pointer colour (COLOR_POINTER in generate_assets.py)
 
 void applyUIColor(int idx); // Forward decl
 
@@ -245,6 +254,45 @@ static lv_obj_t* create_marker_dot(lv_obj_t* parent) {
     return dot;
 }
 
+// Place a pointer whose pivot sits at (px, py), rotated by rotation_deg.
+// Within the gauge range it shows a pre-rotated atlas frame (img_pointer_atlas.h)
+// so LVGL only blends it; past that it falls back to transforming img_pointer.
+static void set_pointer(lv_obj_t* ptr, int range, int centre, float rotation_deg, int px, int py) {
+    int k = (int)lroundf((rotation_deg - centre) / POINTER_ATLAS_STEP);
+    if (k >= -POINTER_ATLAS_HALF && k <= POINTER_ATLAS_HALF) {
+        const lv_image_dsc_t* frame = &img_pointer_atlas[range * POINTER_ATLAS_RANGE + k + POINTER_ATLAS_HALF];
+        if (lv_image_get_src(ptr) != frame) {
+            lv_image_set_src(ptr, frame);
+            lv_image_set_rotation(ptr, 0);
+        }
+        lv_obj_set_pos(ptr, px - POINTER_ATLAS_FRAME / 2, py - POINTER_ATLAS_FRAME / 2);
+        return;
+    }
+    if (lv_image_get_src(ptr) != &img_pointer) {
+        lv_image_set_src(ptr, &img_pointer);
+        lv_image_set_pivot(ptr, 10, 15);
+    }
+    lv_obj_set_pos(ptr, px - 10, py - 15);
+    lv_image_set_rotation(ptr, (int32_t)(rotation_deg * 10));
+}
+
+// Show a truck rotated by rotation (0.1 deg). (x, y) is where the untransformed
+// image sits; its pivot is (pvx, pvy) from there on screen.
+static void set_truck(lv_obj_t* img, TruckCache* tc, uint32_t* shown_gen, int32_t rotation, int x, int y,
+                      int pvx, int pvy) {
+    const TruckCacheEntry* e = truckCacheGet(tc, rotation);
+    if (!e) {
+        lv_obj_set_pos(img, x, y);
+        lv_image_set_rotation(img, rotation);
+        return;
+    }
+    if (e->gen != *shown_gen) {
+        lv_image_set_src(img, &e->dsc);
+        *shown_gen = e->gen;
+    }
+    lv_obj_set_pos(img, x + pvx + e->ox, y + pvy + e->oy);
+}
+
 void initUI() {
     lv_obj_t * scr = lv_scr_act();
     lv_obj_set_style_bg_color(scr, lv_color_hex(0x000000), LV_PART_MAIN);
@@ -253,32 +301,31 @@ void initUI() {
 
     // Load Max Values & Settings
     // Load Max Values & Settings
-    ui_prefs.begin("ui", false);
-    all_time_roll_left = ui_prefs.getFloat("m_rl", 0);
+    all_time_roll_left = persistGetFloat(PERSIST_UI, "m_rl", 0);
     // Compatibility: If keys exist (old version), they load into All Time.
-    all_time_roll_left = ui_prefs.getFloat("m_rl", 0); 
+    all_time_roll_left = persistGetFloat(PERSIST_UI, "m_rl", 0); 
     // Fix: Redundant line removed.
     
-    all_time_roll_left = ui_prefs.getFloat("m_rl", 0);
-    all_time_roll_right = ui_prefs.getFloat("m_rr", 0); // Corrected key (was implicit in logic)
-    all_time_pitch_fwd = ui_prefs.getFloat("m_pf", 0);
-    all_time_pitch_back = ui_prefs.getFloat("m_pb", 0);
+    all_time_roll_left = persistGetFloat(PERSIST_UI, "m_rl", 0);
+    all_time_roll_right = persistGetFloat(PERSIST_UI, "m_rr", 0); // Corrected key (was implicit in logic)
+    all_time_pitch_fwd = persistGetFloat(PERSIST_UI, "m_pf", 0);
+    all_time_pitch_back = persistGetFloat(PERSIST_UI, "m_pb", 0);
     
     // Note: session max starts at 0.
 
     // Load Rotation
-    ui_rotation = ui_prefs.getInt("rot", 0);
+    ui_rotation = persistGetInt(PERSIST_UI, "rot", 0);
     if (ui_rotation % 90 != 0) ui_rotation = 0; // Sanitize
 
     // Load Critical Angles
-    critical_roll = ui_prefs.getInt("crit_r", 50);
-    critical_pitch = ui_prefs.getInt("crit_p", 50);
+    critical_roll = persistGetInt(PERSIST_UI, "crit_r", 50);
+    critical_pitch = persistGetInt(PERSIST_UI, "crit_p", 50);
     
     // Load Color
-    ui_color_idx = ui_prefs.getInt("color", 0);
+    ui_color_idx = persistGetInt(PERSIST_UI, "color", 0);
     
     // Load Pixel Shift (Default 1/True)
-    pixel_shift_enabled = ui_prefs.getBool("p_shift", true);
+    pixel_shift_enabled = persistGetBool(PERSIST_UI, "p_shift", true);
     
     // Start Pixel Shift Timer (Every 60s)
     pixel_shift_timer = lv_timer_create(pixel_shift_cb, 60000, NULL);
@@ -319,9 +366,16 @@ void initUI() {
     truck_pitch_img = lv_image_create(scr);
     lv_image_set_src(truck_pitch_img, &img_truck_side);
     // Position set in updateUI
-    lv_obj_set_style_transform_scale(truck_pitch_img, 320, 0); // 1.25x Scale
     lv_image_set_pivot(truck_pitch_img, 32, 32);
 
+    // Rotated (and for pitch 1.25x scaled) renderings, reused while the angle holds
+    truckCacheInit(&roll_cache, &img_truck_rear, 32, 32, 256, TRUCK_CACHE_STEP, TRUCK_CACHE_SLOTS);
+    if (!truckCacheInit(&pitch_cache, &img_truck_side, 32, 32, 320, TRUCK_CACHE_STEP, TRUCK_CACHE_SLOTS)) {
+        lv_obj_set_style_transform_scale(truck_pitch_img, 320, 0); // 1.25x Scale
+    }
+    Serial.printf("UI: Truck cache %u + %u slots, %u KB\n", roll_cache.slots, pitch_cache.slots,
+                  (unsigned)((roll_cache.stats.bytes + pitch_cache.stats.bytes) / 1024));
+
     // 4. Max Angle Markers (Behind pointers, but on top of BG)
     dot_roll_left = create_marker_dot(scr);
     dot_roll_right = create_marker_dot(scr);
@@ -329,15 +383,18 @@ void initUI() {
     dot_pitch_back = create_marker_dot(scr);
 
     // 5. Pointers
+    // Alpha-only atlas frames: image_recolor gives them their colour
     pointer_roll = lv_image_create(scr);
-    lv_image_set_src(pointer_roll, &img_pointer);
+    lv_image_set_src(pointer_roll, &img_pointer_atlas[POINTER_ATLAS_HALF]);
     lv_obj_add_flag(pointer_roll, LV_OBJ_FLAG_IGNORE_LAYOUT); 
-    lv_image_set_pivot(pointer_roll, 10, 15); 
+    lv_obj_set_style_image_recolor(pointer_roll, POINTER_COLOR, 0);
+    lv_obj_set_style_image_recolor_opa(pointer_roll, LV_OPA_COVER, 0);
 
     pointer_pitch = lv_image_create(scr);
-    lv_image_set_src(pointer_pitch, &img_pointer);
+    lv_image_set_src(pointer_pitch, &img_pointer_atlas[POINTER_ATLAS_RANGE + POINTER_ATLAS_HALF]);
     lv_obj_add_flag(pointer_pitch, LV_OBJ_FLAG_IGNORE_LAYOUT);
-    lv_image_set_pivot(pointer_pitch, 10, 15);
+    lv_obj_set_style_image_recolor(pointer_pitch, POINTER_COLOR, 0);
+    lv_obj_set_style_image_recolor_opa(pointer_pitch, LV_OPA_COVER, 0);
 
 
     // 6. Labels
@@ -407,6 +464,19 @@ void initUI() {
     lv_obj_set_style_text_align(lbl_status_dynamic, LV_TEXT_ALIGN_CENTER, 0);
     lv_obj_add_flag(lbl_status_dynamic, LV_OBJ_FLAG_HIDDEN);
 
+    // IMU Fault Label (Hidden by default). Covers the frozen values in the middle.
+    lbl_imu_fault = lv_label_create(lv_layer_top());
+    lv_label_set_text(lbl_imu_fault, "SENSOR FAULT");
+    lv_obj_set_style_bg_color(lbl_imu_fault, lv_color_hex(0x222222), 0);
+    lv_obj_set_style_bg_opa(lbl_imu_fault, 240, 0);
+    lv_obj_set_style_pad_all(lbl_imu_fault, 10, 0);
+    lv_obj_set_style_radius(lbl_imu_fault, 10, 0);
+    lv_obj_set_style_text_font(lbl_imu_fault, &lv_font_montserrat_28, 0);
+    lv_obj_set_style_text_color(lbl_imu_fault, lv_color_hex(0xFF6D00), 0);
+    lv_obj_set_style_text_align(lbl_imu_fault, LV_TEXT_ALIGN_CENTER, 0);
+    lv_obj_align(lbl_imu_fault, LV_ALIGN_CENTER, 0, 0);
+    lv_obj_add_flag(lbl_imu_fault, LV_OBJ_FLAG_HIDDEN);
+
     // 6. Warning Alert Overlay (Red Border)
     overlay_alert = lv_obj_create(scr);
     lv_obj_set_size(overlay_alert, 466, 466);
@@ -520,12 +590,12 @@ void updateUI(float roll, float pitch) {
         if (effective_pitch < session_pitch_fwd) { session_pitch_fwd = effective_pitch; }
     }
 
-    // Save to NVS
+    // Save to NVS (Queued: the persistence task does the flash write)
     if (dirty && !is_calibrating && lv_tick_elaps(last_save_time) > 5000) {
-        ui_prefs.putFloat("m_rl", all_time_roll_left);
-        ui_prefs.putFloat("m_rr", all_time_roll_right);
-        ui_prefs.putFloat("m_pf", all_time_pitch_fwd);
-        ui_prefs.putFloat("m_pb", all_time_pitch_back);
+        persistPutFloat(PERSIST_UI, "m_rl", all_time_roll_left);
+        persistPutFloat(PERSIST_UI, "m_rr", all_time_roll_right);
+        persistPutFloat(PERSIST_UI, "m_pf", all_time_pitch_fwd);
+        persistPutFloat(PERSIST_UI, "m_pb", all_time_pitch_back);
         dirty = false;
         last_save_time = lv_tick_get();
     }
@@ -557,12 +627,6 @@ void updateUI(float roll, float pitch) {
     // Roll Truck (201, 121) -> 201 = 233-32, 121 = 233-112
     // Pitch Truck (201, 301) -> 201 = 233-32, 301 = 233+68
     
-    // Roll Truck
-    lv_obj_set_pos(truck_roll_img, cx - 32, cy - 112);
-    
-    // Pitch Truck
-    lv_obj_set_pos(truck_pitch_img, cx - 32, cy + 68);
-    
     // Labels are aligned with LV_ALIGN_CENTER, so they handle themselves automatically.
     
     // Label Roll Val: (-75, -25) relative to (233, 233) -> (158, 208)
@@ -584,8 +648,13 @@ void updateUI(float roll, float pitch) {
     
     // --- DYNAMIC ELEMENTS (Update every frame) ---
     // Truck Rotations (0 Base)
-    lv_image_set_rotation(truck_roll_img, (int32_t)(-effective_roll * 10));
-    lv_image_set_rotation(truck_pitch_img, (int32_t)(-effective_pitch * 10));
+    // Roll Truck at (cx - 32, cy - 112), turning about its centre
+    set_truck(truck_roll_img, &roll_cache, &roll_shown_gen, (int32_t)(-effective_roll * 10),
+              cx - 32, cy - 112, 32, 32);
+    // Pitch Truck at (cx - 32, cy + 68), scaled 1.25x from that corner (as the
+    // transform_scale style does), so its pivot is at 1.25 x (32, 32)
+    set_truck(truck_pitch_img, &pitch_cache, &pitch_shown_gen, (int32_t)(-effective_pitch * 10),
+              cx - 32, cy + 68, 40, 40);
 
     float radius = 195.0;
     
@@ -594,15 +663,13 @@ void updateUI(float roll, float pitch) {
     float rad_roll = (180.0 - effective_roll) * 3.14159 / 180.0;
     int px_roll = cx + (int)(radius * cos(rad_roll));
     int py_roll = cy + (int)(radius * sin(rad_roll));
-    lv_obj_set_pos(pointer_roll, px_roll - 10, py_roll - 15); 
-    lv_image_set_rotation(pointer_roll, (int32_t)((270 - effective_roll) * 10));
+    set_pointer(pointer_roll, 0, POINTER_ATLAS_CENTRE_0, 270 - effective_roll, px_roll, py_roll);
 
     // Pitch Pointer (Base 0 Rotation)
     float rad_pitch = (0.0 - effective_pitch) * 3.14159 / 180.0;
     int px_pitch = cx + (int)(radius * cos(rad_pitch));
     int py_pitch = cy + (int)(radius * sin(rad_pitch));
-    lv_obj_set_pos(pointer_pitch, px_pitch - 10, py_pitch - 15); 
-    lv_image_set_rotation(pointer_pitch, (int32_t)((90 - effective_pitch) * 10));
+    set_pointer(pointer_pitch, 1, POINTER_ATLAS_CENTRE_1, 90 - effective_pitch, px_pitch, py_pitch);
 
     // --- Update Max Markers (USE SESSION MAX) ---
     float disp_rl = (session_roll_left < -45.0) ? -45.0 : session_roll_left;
@@ -807,6 +874,18 @@ void updateUI(float roll, float pitch) {
     }
 }
 
+// Degraded IMU: flag it and fade the pointers so a frozen reading isn't trusted
+void setIMUDegraded(bool degraded) {
+    if (degraded == imu_degraded || !lbl_imu_fault) return;
+    imu_degraded = degraded;
+
+    lv_opa_t opa = degraded ? LV_OPA_40 : LV_OPA_COVER;
+    lv_obj_set_style_image_opa(pointer_roll, opa, 0);
+    lv_obj_set_style_image_opa(pointer_pitch, opa, 0);
+    if (degraded) lv_obj_clear_flag(lbl_imu_fault, LV_OBJ_FLAG_HIDDEN);
+    else lv_obj_add_flag(lbl_imu_fault, LV_OBJ_FLAG_HIDDEN);
+}
+
 bool isCalibrating() {
     return is_calibrating;
 }
@@ -826,7 +905,7 @@ void setUIRotation(int degrees) {
     if (degrees % 90 != 0) return; // Only 0, 90, 180, 270
     
     ui_rotation = degrees;
-    ui_prefs.putInt("rot", ui_rotation);
+    persistPutInt(PERSIST_UI, "rot", ui_rotation);
     
     // Apply to Hardware
     lvgl_port_set_rotation(ui_rotation);
@@ -850,8 +929,8 @@ void setCriticalValues(int roll, int pitch) {
     if (critical_pitch < 10) critical_pitch = 10;
     if (critical_pitch > 90) critical_pitch = 90;
 
-    ui_prefs.putInt("crit_r", critical_roll);
-    ui_prefs.putInt("crit_p", critical_pitch);
+    persistPutInt(PERSIST_UI, "crit_r", critical_roll);
+    persistPutInt(PERSIST_UI, "crit_p", critical_pitch);
 }
 
 int getCriticalRoll() { return critical_roll; }
@@ -859,7 +938,7 @@ int getCriticalPitch() { return critical_pitch; }
 
 void setPixelShift(bool enabled) {
     pixel_shift_enabled = enabled;
-    ui_prefs.putBool("p_shift", enabled);
+    persistPutBool(PERSIST_UI, "p_shift", enabled);
     
     // Reset immediately if disabled
     if (!enabled) {
@@ -904,7 +983,7 @@ void getSessionMax(float* r_left, float* r_right, float* p_fwd, float* p_back) {
 void setUIColor(int color_idx) {
     if (color_idx < 0 || color_idx > 5) return;
     ui_color_idx = color_idx;
-    ui_prefs.putInt("color", ui_color_idx);
+    persistPutInt(PERSIST_UI, "color", ui_color_idx);
     applyUIColor(ui_color_idx);
 }
 
@@ -924,21 +1003,33 @@ void applyUIColor(int idx) {
     // If default assets ARE Orange, then no tint needed.
     // Assuming default is NATIVE.
     
+    // Cached truck renderings carry the tint themselves
+    uint32_t tint = lv_color_to_u32(color);
+    truckCacheSetTint(&roll_cache, tint, idx == 0 ? LV_OPA_TRANSP : LV_OPA_COVER);
+    truckCacheSetTint(&pitch_cache, tint, idx == 0 ? LV_OPA_TRANSP : LV_OPA_COVER);
+
     if (idx == 0) {
         // Clear Recolor
         lv_obj_set_style_image_recolor_opa(truck_roll_img, LV_OPA_TRANSP, 0);
         lv_obj_set_style_image_recolor_opa(truck_pitch_img, LV_OPA_TRANSP, 0);
-        lv_obj_set_style_image_recolor_opa(pointer_roll, LV_OPA_TRANSP, 0);
-        lv_obj_set_style_image_recolor_opa(pointer_pitch, LV_OPA_TRANSP, 0);
+        // The pointers stay tinted: the atlas frames carry no colour of their own
+        lv_obj_set_style_image_recolor(pointer_roll, POINTER_COLOR, 0);
+        lv_obj_set_style_image_recolor_opa(pointer_roll, LV_OPA_COVER, 0);
+        lv_obj_set_style_image_recolor(pointer_pitch, POINTER_COLOR, 0);
+        lv_obj_set_style_image_recolor_opa(pointer_pitch, LV_OPA_COVER, 0);
     } else {
         // Apply Recolor
-        lv_obj_set_style_image_recolor(truck_roll_img, color, 0);
-        lv_obj_set_style_image_recolor_opa(truck_roll_img, LV_OPA_COVER, 0); // Warning: Might lose details? Use MIX/COVER properly?
-        // PNG transparency is preserved. But full solid color might be flat.
-        // Let's try it.
+        if (!roll_cache.slots) {
+            lv_obj_set_style_image_recolor(truck_roll_img, color, 0);
+            lv_obj_set_style_image_recolor_opa(truck_roll_img, LV_OPA_COVER, 0); // Warning: Might lose details? Use MIX/COVER properly?
+            // PNG transparency is preserved. But full solid color might be flat.
+            // Let's try it.
+        }
         
-        lv_obj_set_style_image_recolor(truck_pitch_img, color, 0);
-        lv_obj_set_style_image_recolor_opa(truck_pitch_img, LV_OPA_COVER, 0);
+        if (!pitch_cache.slots) {
+            lv_obj_set_style_image_recolor(truck_pitch_img, color, 0);
+            lv_obj_set_style_image_recolor_opa(truck_pitch_img, LV_OPA_COVER, 0);
+        }
         
         lv_obj_set_style_image_recolor(pointer_roll, color, 0);
         lv_obj_set_style_image_recolor_opa(pointer_roll, LV_OPA_COVER, 0);
@@ -948,18 +1039,24 @@ void applyUIColor(int idx) {
     }
 }
 
+void getUITruckCacheStats(TruckCacheStats* roll, TruckCacheStats* pitch) {
+    getTruckCacheStats(&roll_cache, roll);
+    getTruckCacheStats(&pitch_cache, pitch);
+}
+
 void resetSettings() {
     // Reset NVS to defaults
-    ui_prefs.putInt("crit_r", 50);
-    ui_prefs.putInt("crit_p", 50);
-    ui_prefs.putInt("color", 0); // Orange
+    persistPutInt(PERSIST_UI, "crit_r", 50);
+    persistPutInt(PERSIST_UI, "crit_p", 50);
+    persistPutInt(PERSIST_UI, "color", 0); // Orange
     
     // Reset Max
-    ui_prefs.putFloat("m_rl", 0);
-    ui_prefs.putFloat("m_rr", 0);
-    ui_prefs.putFloat("m_pf", 0);
-    ui_prefs.putFloat("m_pb", 0);
+    persistPutFloat(PERSIST_UI, "m_rl", 0);
+    persistPutFloat(PERSIST_UI, "m_rr", 0);
+    persistPutFloat(PERSIST_UI, "m_pf", 0);
+    persistPutFloat(PERSIST_UI, "m_pb", 0);
     
+    persistSync(1000); // Commit before the restart
     Serial.println("Settings Reset. Rebooting..."); 
     delay(100);
     ESP.restart(); 
@@ -8,9 +8,11 @@
 #pragma once
 
 #include <lvgl.h>
+#include "truck_cache.h"
 
 void initUI();
 void updateUI(float roll, float pitch);
+void setIMUDegraded(bool degraded); // Health watchdog flag (IMUAttitude::degraded)
 bool isCalibrating();
 bool consumeCalibrationTrigger(); // One-shot accessor
 void showToast(const char* text, uint32_t duration_ms = 2000);
@@ -31,4 +33,5 @@ void resetSettings();
 void resetAllTimeStats();
 void getAllTimeMax(float* r_left, float* r_right, float* p_fwd, float* p_back);
 void getSessionMax(float* r_left, float* r_right, float* p_fwd, float* p_back);
+void getUITruckCacheStats(TruckCacheStats* roll, TruckCacheStats* pitch);
 
@@ -10,9 +10,15 @@
 #include <WebServer.h>
 #include <Update.h>
 #include "imu_driver.h" // For zeroIMU
-#include <Preferences.h> // For WiFi Timeout Logic
+#include "persist.h" // For WiFi Timeout Logic
 #include "ui.h" // For hideToast, triggerCalibrationUI, getters
 #include "imu_driver.h" // For zeroIMU, smoothing getters
+#include "imu_recorder.h"
+#include "boot_timeline.h"
+#include "power.h"
+#include "perf_counters.h"
+#include "latency_probe.h"
+#include <LittleFS.h>
 
 WebServer server(80);
 bool ap_mode_active = false;
@@ -22,7 +28,6 @@ uint32_t connection_start_time = 0;
 bool client_connected_flag = false;
 
 // Config
-static Preferences web_prefs;
 static int wifi_timeout_sec = 45; // Default 45s
 
 // --- HTML Content ---
@@ -169,6 +174,14 @@ const char index_html[] PROGMEM = R"rawliteral(
           <span class="card-title">System Status</span>
           <div class="stat-row"><span>Uptime</span><span id="st_uptime" class="stat-val">-</span></div>
           <div class="stat-row"><span>Clients</span><span id="st_clients" class="stat-val">-</span></div>
+          <div class="stat-row"><span>Live Roll / Pitch</span><span id="st_live" class="stat-val">-</span></div>
+          <div class="stat-row"><span>IMU Recording</span><span id="st_rec" class="stat-val">-</span></div>
+          <div class="stat-row"><span>IMU Health</span><span id="st_imu_health" class="stat-val">-</span></div>
+          <div class="stat-row"><span>IMU Samples Lost</span><span id="st_imu_drop" class="stat-val">-</span></div>
+          <div class="stat-row"><span>NVS Writes</span><span id="st_nvs" class="stat-val">-</span></div>
+          <div class="stat-row"><span>Power</span><span id="st_pwr" class="stat-val">-</span></div>
+          <div class="stat-row"><span>Motion to Display</span><span id="st_lat" class="stat-val">-</span></div>
+          <div class="stat-row"><span>Truck Image Cache</span><span id="st_tc" class="stat-val">-</span></div>
       </div>
       
       <div class="card">
@@ -245,13 +258,11 @@ const char index_html[] PROGMEM = R"rawliteral(
   <div id="system" class="container">
       <div class="card">
           <span class="card-title">Calculation Mode</span>
-          <div class="row">
-              <label>Use Sensor Fusion</label>
-              <label class="switch">
-                  <input type="checkbox" id="cmode" onchange="saveMode(this.checked)">
-                  <span class="slider"></span>
-              </label>
-          </div>
+          <select id="cmode" onchange="saveMode(this.value)">
+              <option value="0">Sensor Fusion</option>
+              <option value="2">Quaternion Fusion</option>
+              <option value="1">EMA (Accel Only)</option>
+          </select>
           <div id="mode_desc" style="font-size:12px; color:#aaa; margin-top:5px; font-style:italic;">
               Fusion (Default): Best for driving. Resists bumps.
           </div>
@@ -285,6 +296,15 @@ const char index_html[] PROGMEM = R"rawliteral(
           <button id="flash_btn" class="filled" style="display:none; margin-top:5px;" onclick="startFlash()">Flash Firmware</button>
       </div>
 
+      <div class="card">
+          <span class="card-title">IMU Recording</span>
+          <div class="grid-2">
+            <button class="small" onclick="doAction('rec_start')">Start</button>
+            <button class="small" onclick="doAction('rec_stop')">Stop</button>
+          </div>
+          <button class="small" style="margin-top:10px;" onclick="location.href='/imu_log'">Download Log</button>
+      </div>
+
       <div class="card">
           <span class="card-title">Admin</span>
           <button class="danger" onclick="doAction('reboot')">Reboot Device</button>
@@ -339,9 +359,8 @@ const char index_html[] PROGMEM = R"rawliteral(
             document.getElementById('smooth').value = d.smooth;
             document.getElementById('smooth_val').innerText = d.smooth + '%';
             // Mode
-            var isFusion = (d.mode == 0);
-            document.getElementById('cmode').checked = isFusion;
-            updateModeUI(isFusion);
+            document.getElementById('cmode').value = d.mode;
+            updateModeUI(d.mode);
             // System
             document.getElementById('pshift').checked = (d.pshift == 1);
             document.getElementById('wto').value = d.wto;
@@ -352,6 +371,14 @@ const char index_html[] PROGMEM = R"rawliteral(
         fetch('/get_stats').then(r=>r.json()).then(d => {
             document.getElementById('st_uptime').innerText = formatTime(d.uptime);
             document.getElementById('st_clients').innerText = d.clients;
+            document.getElementById('st_live').innerText = d.roll + "° / " + d.pitch + "°";
+            document.getElementById('st_imu_health').innerText = d.imu_health + (d.imu_reinit ? " (" + d.imu_reinit + " re-inits)" : "");
+            document.getElementById('st_imu_drop').innerText = d.imu_drop + (d.imu_gaps ? " (" + d.imu_gaps + " gaps)" : "");
+            document.getElementById('st_nvs').innerText = d.nvs_commits + " commits, " + d.nvs_keys + " keys (" + d.nvs_coalesced + " coalesced)";
+            document.getElementById('st_pwr').innerText = d.pwr + ", " + d.pwr_sleeps + " sleeps";
+            document.getElementById('st_lat').innerText = d.lat_n ? d.lat_p50 + " ms (p99 " + d.lat_p99 + " ms)" : "-";
+            document.getElementById('st_tc').innerText = d.tc_kb ? Math.round(100 * d.tc_hits / Math.max(1, d.tc_hits + d.tc_misses)) + "% hits, " + d.tc_kb + " KB" : "Off";
+            document.getElementById('st_rec').innerText = (d.rec ? "On, " : "Off, ") + d.rec_kb + " KB" + (d.rec_drop ? " (" + d.rec_drop + " dropped)" : "");
             document.getElementById('st_s_roll').innerText = d.s_rl + "° / " + d.s_rr + "°";
             document.getElementById('st_s_pitch').innerText = d.s_pf + "° / " + d.s_pb + "°";
             document.getElementById('st_at_roll').innerText = d.at_rl + "° / " + d.at_rr + "°";
@@ -417,21 +444,23 @@ const char index_html[] PROGMEM = R"rawliteral(
         fetch('/set_smoothing?val='+v, {method:'POST'});
     }
     
-    function updateModeUI(checked) {
-        var val = checked ? 0 : 1;
+    function updateModeUI(val) {
+        val = parseInt(val);
         var desc = document.getElementById('mode_desc');
         if(val === 0) {
             desc.innerHTML = "Fusion (Default): Best for driving. Resists bumps.";
             desc.style.color = "#aaa";
+        } else if(val === 2) {
+            desc.innerHTML = "Quaternion: Full 3D fusion. Most accurate when roll and pitch are both steep.";
+            desc.style.color = "#aaa";
         } else {
             desc.innerHTML = "EMA Mode: Accel only. Good for static leveling, but lags heavily when moving.";
             desc.style.color = "#FF9800";
         }
     }
 
-    function saveMode(checked) {
-        updateModeUI(checked);
-        var val = checked ? 0 : 1;
+    function saveMode(val) {
+        updateModeUI(val);
         fetch('/set_mode?val='+val, {method:'POST'});
     }
     function setPixelShift() {
@@ -596,6 +625,104 @@ void handleResetSettings() {
     server.send(200, "text/plain", "OK");
 }
 
+void handleRecStart() {
+    if (startRecording()) server.send(200, "text/plain", "OK");
+    else server.send(409, "text/plain", "Recorder busy or no filesystem");
+}
+
+void handleRecStop() {
+    stopRecording();
+    server.send(200, "text/plain", "OK");
+}
+
+void handleDownloadLog() {
+    if (isRecording()) {
+        server.send(409, "text/plain", "Stop recording first");
+        return;
+    }
+    File f = LittleFS.open(IMU_LOG_PATH, "r");
+    if (!f) {
+        server.send(404, "text/plain", "No log");
+        return;
+    }
+    server.sendHeader("Content-Disposition", "attachment; filename=imu.bin");
+    server.streamFile(f, "application/octet-stream");
+    f.close();
+}
+
+void handleGetPerf() {
+    // Cycle counters, last PERF_WINDOW_MS window (times in us, cpu in %)
+    PerfSnapshot s;
+    getPerfSnapshot(&s);
+    float mhz = s.cpu_mhz ? (float)s.cpu_mhz : 1.0f;
+    float window_s = s.window_us / 1e6f;
+    String json = "{";
+    json += "\"window_ms\":" + String(s.window_us / 1000) + ",";
+    json += "\"fps\":" + String(window_s > 0 ? s.frames / window_s : 0.0f, 1) + ",";
+    json += "\"overhead_us\":" + String(s.overhead_cycles / mhz, 2) + ",";
+    json += "\"cpu_mhz\":" + String(s.cpu_mhz) + ",";
+    json += "\"counters\":{";
+    for (int i = 0; i < PERF_COUNT; i++) {
+        const PerfStat* st = &s.stat[i];
+        float cpu = s.window_us ? (float)(st->total / mhz) * 100.0f / s.window_us : 0.0f;
+        if (i) json += ",";
+        json += "\"" + String(perfName((PerfId)i)) + "\":{";
+        json += "\"count\":" + String(st->count) + ",";
+        json += "\"min\":" + String(st->min / mhz, 1) + ",";
+        json += "\"avg\":" + String(st->avg / mhz, 1) + ",";
+        json += "\"p99\":" + String(st->p99 / mhz, 1) + ",";
+        json += "\"max\":" + String(st->max / mhz, 1) + ",";
+        json += "\"cpu\":" + String(cpu, 2) + "}";
+    }
+    json += "}}";
+    server.send(200, "application/json", json);
+}
+
+void handleGetLatency() {
+    // Motion-to-photon latency since the last reset (ms). ?reset=1 clears it after this report.
+    LatencyStats ls;
+    getLatencyStats(&ls);
+    String json = "{";
+    json += "\"frames\":" + String(ls.frames) + ",";
+    json += "\"superseded\":" + String(ls.superseded) + ",";
+    json += "\"avg\":" + String(ls.total_avg_us / 1000.0f, 2) + ",";
+    json += "\"p50\":" + String(ls.p50_us / 1000.0f, 2) + ",";
+    json += "\"p90\":" + String(ls.p90_us / 1000.0f, 2) + ",";
+    json += "\"p99\":" + String(ls.p99_us / 1000.0f, 2) + ",";
+    json += "\"max\":" + String(ls.total_max_us / 1000.0f, 2) + ",";
+    json += "\"stages\":{";
+    for (int i = 0; i < LAT_STAGES; i++) {
+        if (i) json += ",";
+        json += "\"" + String(latencyStageName((LatStage)i)) + "\":{";
+        json += "\"avg\":" + String(ls.stage_avg_us[i] / 1000.0f, 2) + ",";
+        json += "\"max\":" + String(ls.stage_max_us[i] / 1000.0f, 2) + "}";
+    }
+    // Histogram up to the last non-empty bucket
+    int last = LAT_BUCKETS - 1;
+    while (last > 0 && !ls.hist[last]) last--;
+    json += "},\"bucket_ms\":" + String(LAT_BUCKET_US / 1000.0f, 1) + ",\"hist\":[";
+    for (int i = 0; i <= last; i++) {
+        if (i) json += ",";
+        json += String(ls.hist[i]);
+    }
+    json += "]}";
+    server.send(200, "application/json", json);
+    if (server.hasArg("reset")) latencyReset();
+}
+
+void handleGetBoot() {
+    // Boot timeline: [{"phase":"setup","ms":12.3}, ...]
+    BootPhase phases[BOOT_TIMELINE_MAX];
+    int n = getBootTimeline(phases, BOOT_TIMELINE_MAX);
+    String json = "[";
+    for (int i = 0; i < n; i++) {
+        if (i) json += ",";
+        json += "{\"phase\":\"" + String(phases[i].name) + "\",\"ms\":" + String(phases[i].t_us / 1000.0f, 1) + "}";
+    }
+    json += "]";
+    server.send(200, "application/json", json);
+}
+
 void handleResetStats() {
     resetAllTimeStats();
     server.send(200, "text/plain", "OK");
@@ -611,6 +738,12 @@ void handleGetStats() {
     // We'll skip RSSI for now or just show station count.
     json += "\"clients\":" + String(WiFi.softAPgetStationNum()) + ",";
     
+    // Live Angle (Lock-free snapshot from the IMU task)
+    IMUAttitude att = {0};
+    readIMUAttitude(&att);
+    json += "\"roll\":" + String(att.roll, 1) + ",";
+    json += "\"pitch\":" + String(att.pitch, 1) + ",";
+    
     // Max Angles (All Time)
     float atl, atr, apf, apb;
     getAllTimeMax(&atl, &atr, &apf, &apb);
@@ -625,7 +758,53 @@ void handleGetStats() {
     json += "\"s_rl\":" + String((int)abs(sl)) + ",";
     json += "\"s_rr\":" + String((int)abs(sr)) + ",";
     json += "\"s_pf\":" + String((int)abs(sf)) + ",";
-    json += "\"s_pb\":" + String((int)abs(sb));
+    json += "\"s_pb\":" + String((int)abs(sb)) + ",";
+
+    // Sensor health
+    IMUHealthStats hs;
+    getIMUHealthStats(&hs);
+    json += "\"imu_health\":\"" + String(getIMUFaultName(hs.fault)) + "\",";
+    json += "\"imu_reinit\":" + String(hs.reinits) + ",";
+
+    // Sensor time base
+    IMUTimeStats ts;
+    getIMUTimeStats(&ts);
+    json += "\"imu_drop\":" + String(ts.dropped_samples) + ",";
+    json += "\"imu_gaps\":" + String(ts.gaps) + ",";
+
+    // Persistence
+    PersistStats ps;
+    getPersistStats(&ps);
+    json += "\"nvs_commits\":" + String(ps.commits) + ",";
+    json += "\"nvs_keys\":" + String(ps.keys_written) + ",";
+    json += "\"nvs_coalesced\":" + String(ps.coalesced) + ",";
+
+    // Power
+    PowerStats pw;
+    getPowerStats(&pw);
+    json += "\"pwr\":\"" + String(getPowerStateName()) + "\",";
+    json += "\"pwr_sleeps\":" + String(pw.sleeps) + ",";
+
+    // Motion-to-photon latency
+    LatencyStats ls;
+    getLatencyStats(&ls);
+    json += "\"lat_n\":" + String(ls.frames) + ",";
+    json += "\"lat_p50\":" + String(ls.p50_us / 1000.0f, 1) + ",";
+    json += "\"lat_p99\":" + String(ls.p99_us / 1000.0f, 1) + ",";
+
+    // Truck image cache (both trucks)
+    TruckCacheStats tr, tp;
+    getUITruckCacheStats(&tr, &tp);
+    json += "\"tc_hits\":" + String(tr.hits + tp.hits) + ",";
+    json += "\"tc_misses\":" + String(tr.misses + tp.misses) + ",";
+    json += "\"tc_kb\":" + String((tr.bytes + tp.bytes) / 1024) + ",";
+
+    // Recorder
+    IMURecorderStats rec;
+    getRecorderStats(&rec);
+    json += "\"rec\":" + String(rec.active ? 1 : 0) + ",";
+    json += "\"rec_kb\":" + String(rec.bytes / 1024) + ",";
+    json += "\"rec_drop\":" + String(rec.dropped_batches);
     
     json += "}";
     server.send(200, "application/json", json);
@@ -671,8 +850,15 @@ void startAPMode() {
     server.on("/reset_settings", HTTP_POST, handleResetSettings);
     server.on("/reset_stats", HTTP_POST, handleResetStats);
     server.on("/get_stats", handleGetStats);
+    server.on("/boot", handleGetBoot);
+    server.on("/perf", handleGetPerf);
+    server.on("/latency", handleGetLatency);
+    server.on("/rec_start", HTTP_POST, handleRecStart);
+    server.on("/rec_stop", HTTP_POST, handleRecStop);
+    server.on("/imu_log", handleDownloadLog);
     server.on("/reboot", HTTP_POST, [](){
         server.send(200, "text/plain", "Rebooting...");
+        persistSync(1000); // Pending settings
         delay(100);
         ESP.restart();
     });
@@ -685,6 +871,7 @@ void startAPMode() {
     // OTA Update Handler
     server.on("/update", HTTP_POST, []() {
       server.send(200, "text/plain", (Update.hasError()) ? "FAIL" : "OK");
+      persistSync(1000);
       delay(500);
       ESP.restart();
     }, []() {
@@ -715,9 +902,6 @@ void startAPMode() {
     client_connected_flag = false;
     should_disconnect = false;
     
-    // Load Timeout
-    web_prefs.begin("web", false);
-    wifi_timeout_sec = web_prefs.getInt("to", 45);
     Serial.printf("AP Started. Timeout: %ds\n", wifi_timeout_sec);
 }
 
@@ -738,7 +922,9 @@ void stopAPMode() {
 }
 
 void initWebServer() {
-    // Standby
+    // Standby. Timeout loaded once: setWiFiTimeout() keeps it current, and a
+    // change still pending in the persistence task isn't in NVS yet
+    wifi_timeout_sec = persistGetInt(PERSIST_WEB, "to", 45);
 }
 
 void createWebServer() {
@@ -804,7 +990,7 @@ bool isAPMode() {
 void setWiFiTimeout(int seconds) {
     if (seconds < 0) seconds = 0; // 0 = Always On
     wifi_timeout_sec = seconds;
-    web_prefs.putInt("to", wifi_timeout_sec);
+    persistPutInt(PERSIST_WEB, "to", wifi_timeout_sec);
 }
 
 int getWiFiTimeout() {
@@ -0,0 +1,150 @@
+/*
+ * File: sim.cpp
+ * Description: Host Driver for the Button Decoder (Scripted Edges)
+ * Author: zzackk125
+ * License: MIT
+ *
+ * Feeds src/button_engine.cpp a scripted edge sequence on a virtual
+ * millisecond clock, waking it exactly like the device's button task does
+ * (on each edge, and at btnNextTimeout()). Prints the events and checks
+ * them against the script's expect lines.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "button_engine.h"
+#include "board_config.h"
+
+struct Edge {
+    uint32_t t;
+    bool pressed;
+};
+
+struct Expect {
+    uint32_t t;
+    uint8_t type;
+    int line;
+};
+
+static std::vector<Edge> edges;
+static std::vector<Expect> expects;
+static uint32_t end_ms = 0;
+
+static uint8_t eventType(const char* name) {
+    for (uint8_t t = BTN_EV_CLICK; t <= BTN_EV_LONG; t++) {
+        if (!strcmp(name, btnEventName(t))) return t;
+    }
+    return 0;
+}
+
+// <t_ms> press|release [bounce n] / <t_ms> expect click|double|long / <t_ms> end
+static bool loadScript(const char* path) {
+    FILE* f = fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "Can't open %s\n", path);
+        return false;
+    }
+    char line[256];
+    int ln = 0;
+    while (fgets(line, sizeof(line), f)) {
+        ln++;
+        char* hash = strchr(line, '#');
+        if (hash) *hash = 0;
+
+        unsigned t, n = 0;
+        char cmd[16] = "", arg[16] = "";
+        int got = sscanf(line, "%u %15s %15s %u", &t, cmd, arg, &n);
+        if (got <= 0) continue;
+
+        if (got >= 2 && (!strcmp(cmd, "press") || !strcmp(cmd, "release"))) {
+            // Bounce: n spikes back to the old level, 1ms apart, before it sticks
+            bool level = !strcmp(cmd, "press");
+            if (got == 4 && strcmp(arg, "bounce")) got = 0;
+            for (unsigned i = 0; i < 2 * n; i++) edges.push_back({ t + i, (i % 2) ? !level : level });
+            edges.push_back({ t + 2 * n, level });
+        } else if (got == 3 && !strcmp(cmd, "expect") && eventType(arg)) {
+            expects.push_back({ t, eventType(arg), ln });
+        } else if (got == 2 && !strcmp(cmd, "end")) {
+            end_ms = t;
+        } else {
+            got = 0;
+        }
+        if (got <= 0) {
+            fprintf(stderr, "%s:%d: can't parse: %s", path, ln, line);
+            fclose(f);
+            return false;
+        }
+    }
+    fclose(f);
+
+    for (size_t i = 1; i < edges.size(); i++) {
+        if (edges[i].t <= edges[i - 1].t) {
+            fprintf(stderr, "%s: edges out of order at %u ms\n", path, (unsigned)edges[i].t);
+            return false;
+        }
+    }
+    if (!end_ms && !edges.empty()) end_ms = edges.back().t + 5000;
+    return true;
+}
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        fprintf(stderr, "usage: button_sim script.txt\n");
+        return 2;
+    }
+    if (!loadScript(argv[1])) return 2;
+
+    ButtonTiming timing = { BUTTON_DEBOUNCE_MS, BUTTON_CLICK_MAX_MS, BUTTON_DOUBLE_GAP_MS, BUTTON_LONG_MS };
+    ButtonEngine b;
+    btnInit(&b, &timing, false);
+
+    printf("debounce %ums, click < %ums, double gap %ums, long %ums\n", timing.debounce_ms,
+           timing.click_max_ms, timing.double_gap_ms, timing.long_ms);
+    printf("%8s  %-6s %9s %8s\n", "t_ms", "event", "press_ms", "held_ms");
+
+    std::vector<Expect> seen;
+    size_t next_edge = 0;
+    uint32_t now = 0, wakeups = 0;
+    for (;;) {
+        uint32_t timeout = btnNextTimeout(&b, now);
+        uint32_t t_timer = timeout == BTN_NO_TIMEOUT ? UINT32_MAX : now + timeout;
+        uint32_t t_edge = next_edge < edges.size() ? edges[next_edge].t : UINT32_MAX;
+        if (t_edge > end_ms && t_timer > end_ms) break;
+
+        if (t_edge <= t_timer) {
+            now = t_edge;
+            btnEdge(&b, now, edges[next_edge++].pressed);
+        } else {
+            now = t_timer;
+        }
+        btnUpdate(&b, now);
+        wakeups++;
+
+        ButtonEvent ev;
+        while (btnPop(&b, &ev)) {
+            printf("%8u  %-6s %9u %8u\n", (unsigned)now, btnEventName(ev.type), (unsigned)ev.press_ms,
+                   (unsigned)ev.held_ms);
+            seen.push_back({ now, ev.type, 0 });
+        }
+    }
+    printf("%u edges, %u glitches, %u wakeups\n", (unsigned)b.edges, (unsigned)b.glitches, (unsigned)wakeups);
+
+    if (expects.empty()) return 0;
+    int bad = 0;
+    for (size_t i = 0; i < expects.size() || i < seen.size(); i++) {
+        if (i < expects.size() && i < seen.size() && expects[i].t == seen[i].t && expects[i].type == seen[i].type) continue;
+        if (i < expects.size()) {
+            printf("MISMATCH line %d: expected %s at %u", expects[i].line, btnEventName(expects[i].type), (unsigned)expects[i].t);
+        } else {
+            printf("MISMATCH: unexpected");
+        }
+        if (i < seen.size()) printf(", got %s at %u\n", btnEventName(seen[i].type), (unsigned)seen[i].t);
+        else printf(", got nothing\n");
+        bad++;
+    }
+    if (bad) printf("FAIL (%d mismatches)\n", bad);
+    else printf("OK (%u events as expected)\n", (unsigned)expects.size());
+    return bad ? 1 : 0;
+}
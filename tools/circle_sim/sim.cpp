@@ -0,0 +1,192 @@
+/*
+ * File: sim.cpp
+ * Description: Host Count of Pixels Rendered and Bytes Sent on the Round Panel
+ * Author: zzackk125
+ * License: MIT
+ *
+ * Replays the invalidated areas of typical frames through the same steps
+ * lvgl_port.c takes: the rounder, circleSplit() into LCD_CIRCLE_BAND_ROWS
+ * bands, LVGL's partial mode chunking (LVGL_BUF_HEIGHT full rows per draw
+ * buffer) and circleSplit() of each chunk into address windows. Prints the
+ * pixels rendered, bytes sent and windows per frame with LCD_CIRCLE_CLIP
+ * off and on. Random areas then check that no visible pixel is ever lost.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include "circle_clip.h"
+#include "board_config.h"
+
+struct Count {
+    uint64_t rendered;   // Pixels LVGL draws
+    uint64_t sent;       // Bytes over QSPI (pixel data)
+    uint64_t wasted;     // Of those, bytes outside the disk
+    uint32_t windows;    // draw_bitmap() address windows
+    uint32_t waits;      // Windows that wait for the previous DMA (no render overlap)
+};
+
+static bool visible(int32_t x, int32_t y) {
+    float r = LCD_H_RES / 2.0f + LCD_CIRCLE_MARGIN_PX;
+    float dx = x + 0.5f - LCD_H_RES / 2.0f, dy = y + 0.5f - LCD_V_RES / 2.0f;
+    return dx * dx + dy * dy <= r * r;
+}
+
+static uint64_t wastedBytes(const CircleArea& a) {
+    uint64_t n = 0;
+    for (int32_t y = a.y1; y <= a.y2; y++)
+        for (int32_t x = a.x1; x <= a.x2; x++) n += !visible(x, y);
+    return n * 2;
+}
+
+static int32_t areaSize(const CircleArea& a) {
+    return (a.x2 - a.x1 + 1) * (a.y2 - a.y1 + 1);
+}
+
+// example_lvgl_rounder_cb(): even start, odd end
+static CircleArea roundArea(CircleArea a) {
+    a.x1 &= ~1; a.y1 &= ~1;
+    a.x2 |= 1;  a.y2 |= 1;
+    if (a.x1 < 0) a.x1 = 0;
+    if (a.y1 < 0) a.y1 = 0;
+    if (a.x2 > LCD_H_RES - 1) a.x2 = LCD_H_RES - 1;
+    if (a.y2 > LCD_V_RES - 1) a.y2 = LCD_V_RES - 1;
+    return a;
+}
+
+// One area through LVGL partial mode and the flush callback
+static void renderArea(const CircleArea& a, bool clip, Count* c) {
+    int32_t w = a.x2 - a.x1 + 1;
+    int32_t max_row = ((LCD_H_RES * LVGL_BUF_HEIGHT) / w) & ~1;
+    for (int32_t y = a.y1; y <= a.y2; y += max_row) {
+        CircleArea chunk = { a.x1, y, a.x2, y + max_row - 1 < a.y2 ? y + max_row - 1 : a.y2 };
+        c->rendered += areaSize(chunk);
+        if (!clip) {
+            c->sent += areaSize(chunk) * 2;
+            c->wasted += wastedBytes(chunk);
+            c->windows++;
+            continue;
+        }
+        CircleArea g[LVGL_BUF_HEIGHT / 2 + 1];
+        int n = circleSplit(&chunk, LCD_CIRCLE_FLUSH_ROWS, g, LVGL_BUF_HEIGHT / 2 + 1);
+        for (int i = 0; i < n; i++) {
+            c->sent += areaSize(g[i]) * 2;
+            c->wasted += wastedBytes(g[i]);
+        }
+        c->windows += n;
+        c->waits += n ? n - 1 : 0;
+    }
+}
+
+static void renderFrame(const std::vector<CircleArea>& areas, bool clip, Count* c) {
+    for (CircleArea a : areas) {
+        a = roundArea(a);
+        if (!clip) {
+            renderArea(a, false, c);
+            continue;
+        }
+        CircleArea bands[LCD_V_RES / LCD_CIRCLE_BAND_ROWS + 2];
+        int n = circleSplit(&a, LCD_CIRCLE_BAND_ROWS, bands, LCD_V_RES / LCD_CIRCLE_BAND_ROWS + 2);
+        if (n == 0) {
+            CircleArea parked = { 0, 0, 1, 1 }; // Corner only: 4 pixels, never sent
+            renderArea(parked, true, c);
+        }
+        for (int i = 0; i < n; i++) renderArea(bands[i], true, c);
+    }
+}
+
+// --- Frames (areas from ui.cpp geometry, LVGL coordinates) ---
+static CircleArea box(float cx, float cy, float half_w, float half_h) {
+    return { (int32_t)floorf(cx - half_w), (int32_t)floorf(cy - half_h), (int32_t)ceilf(cx + half_w), (int32_t)ceilf(cy + half_h) };
+}
+
+// Pointer sprite (20x30, rotated) on the r = 195 arc: old and new position
+static void pointer(std::vector<CircleArea>* v, float base_deg, float from, float to) {
+    for (float a : { from, to }) {
+        float rad = (base_deg - a) * 3.14159f / 180.0f;
+        v->push_back(box(233 + 195 * cosf(rad), 233 + 195 * sinf(rad), 18, 18));
+    }
+}
+
+static std::vector<CircleArea> gaugeFrame(float roll, float pitch) {
+    std::vector<CircleArea> v;
+    pointer(&v, 180, roll - 1, roll);
+    pointer(&v, 0, pitch - 1, pitch);
+    v.push_back(box(233, 121, 46, 46));     // Rear truck, rotated
+    v.push_back(box(233, 333, 57, 57));     // Side truck, 1.25x, rotated
+    v.push_back(box(158, 208, 40, 20));     // Roll value
+    v.push_back(box(308, 208, 40, 20));     // Pitch value
+    return v;
+}
+
+struct Frame {
+    const char* name;
+    std::vector<CircleArea> areas;
+};
+
+int main() {
+    circleInit(LCD_H_RES, LCD_V_RES, LCD_CIRCLE_MARGIN_PX);
+
+    uint64_t disk = 0;
+    for (int32_t y = 0; y < LCD_V_RES; y++)
+        for (int32_t x = 0; x < LCD_H_RES; x++) disk += visible(x, y);
+    printf("%dx%d panel, disk %llu px (%.1f%%), bands %d rows, flush windows %d rows, buffer %d rows\n\n",
+           LCD_H_RES, LCD_V_RES, (unsigned long long)disk, 100.0 * disk / (LCD_H_RES * LCD_V_RES),
+           LCD_CIRCLE_BAND_ROWS, LCD_CIRCLE_FLUSH_ROWS, LVGL_BUF_HEIGHT);
+
+    std::vector<Frame> frames = {
+        { "full screen (overlay, page)", { { 0, 0, LCD_H_RES - 1, LCD_V_RES - 1 } } },
+        { "gauge, level", gaugeFrame(0, 0) },
+        { "gauge, 40 deg roll/pitch", gaugeFrame(40, 40) },
+        { "toast (centre label)", { box(233, 233, 110, 30) } },
+        { "corner only", { { 0, 0, 39, 39 } } },
+    };
+
+    printf("  %-28s %-6s %10s %10s %9s %8s %6s\n", "frame", "clip", "rendered", "sent KB", "waste KB", "windows", "waits");
+    for (const Frame& f : frames) {
+        Count off = {}, on = {};
+        renderFrame(f.areas, false, &off);
+        renderFrame(f.areas, true, &on);
+        const Count* cs[2] = { &off, &on };
+        for (int k = 0; k < 2; k++) {
+            const Count* c = cs[k];
+            printf("  %-28s %-6s %10llu %10.1f %9.1f %8u %6u\n", k ? "" : f.name, k ? "on" : "off",
+                   (unsigned long long)c->rendered, c->sent / 1024.0, c->wasted / 1024.0, c->windows, c->waits);
+        }
+    }
+
+    // Every visible pixel of random areas must land in exactly one output band
+    srand(1);
+    int failures = 0;
+    for (int t = 0; t < 20000 && failures < 5; t++) {
+        int32_t x1 = rand() % LCD_H_RES, y1 = rand() % LCD_V_RES;
+        CircleArea a = roundArea({ x1, y1, x1 + rand() % (LCD_H_RES - x1), y1 + rand() % (LCD_V_RES - y1) });
+        int32_t rows = 2 * (1 + rand() % 32);
+        CircleArea out[LCD_V_RES / 2 + 1];
+        int n = circleSplit(&a, rows, out, LCD_V_RES / 2 + 1);
+        for (int i = 0; i < n; i++) {
+            const CircleArea& b = out[i];
+            if (b.x1 < a.x1 || b.x2 > a.x2 || b.y1 < a.y1 || b.y2 > a.y2 || (b.x1 & 1) || !(b.x2 & 1) ||
+                (b.y1 & 1) || !(b.y2 & 1) || (i && b.y1 <= out[i - 1].y2)) {
+                printf("FAIL: band %d (%d,%d)-(%d,%d) of (%d,%d)-(%d,%d)\n", i, b.x1, b.y1, b.x2, b.y2, a.x1, a.y1, a.x2, a.y2);
+                failures++;
+            }
+        }
+        for (int32_t y = a.y1; y <= a.y2; y++) {
+            for (int32_t x = a.x1; x <= a.x2; x++) {
+                if (!visible(x, y)) continue;
+                int hits = 0;
+                for (int i = 0; i < n; i++) hits += (x >= out[i].x1 && x <= out[i].x2 && y >= out[i].y1 && y <= out[i].y2);
+                if (hits != 1) {
+                    if (failures < 5) printf("FAIL: visible (%d,%d) in %d bands\n", x, y, hits);
+                    failures++;
+                    y = a.y2;
+                    break;
+                }
+            }
+        }
+    }
+    printf("\n%s\n", failures ? "FAIL" : "OK (20000 random areas, no visible pixel lost)");
+    return failures ? 1 : 0;
+}
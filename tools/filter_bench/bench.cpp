@@ -0,0 +1,529 @@
+/*
+ * File: bench.cpp
+ * Description: Host Accuracy Checks and Benchmarks of the Filter Kernels
+ * Author: zzackk125
+ * License: MIT
+ *
+ *   filter_bench [section...]
+ *
+ * Sections:
+ *
+ *   math      fast_math kernels against double libm over every float of
+ *             their reduced range: the error bounds fast_math.h states,
+ *             and ns per call next to libm
+ *   fixed     The Q16.16 path (IMU_USE_FIXED_POINT) against the float
+ *             path, kernel by kernel and as the whole complementary filter
+ *             chain on the same sample stream, with cycles per sample
+ *   mahony    mahonyUpdate() against a known attitude trajectory: roll /
+ *             pitch error vs truth, |q| drift, ns per update
+ *
+ * Every section checks its bounds and the exit status is non-zero if any
+ * fails. Host timings only compare paths; they do not predict ESP32-C6
+ * cycles (no FPU there, so float is soft-float).
+ */
+
+#include <chrono>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "board_config.h"
+#include "imu_fusion.h"
+#include "fast_math.h"
+#include "imu_fixed.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#endif
+
+typedef std::chrono::steady_clock Clock;
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    printf("  %-58s %s\n", what, ok ? "ok" : "FAIL");
+    if (!ok) failures++;
+}
+
+static double nsSince(Clock::time_point t0) {
+    return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t0).count();
+}
+
+// Defeats dead-code elimination of timed loops
+static volatile float sink;
+
+static const double DT = IMU_SAMPLE_PERIOD_US / 1e6;
+static const double D2R = M_PI / 180.0;
+
+// --- Reference trajectory ---
+// Roll, pitch and yaw (ZYX, degrees) as smooth functions of time, with the
+// body rates and gravity vector they imply (same conventions as the driver:
+// roll = atan2(ay, az), pitch = atan2(-ax, sqrt(ay^2 + az^2)))
+struct Motion {
+    double roll, pitch;         // Truth, degrees
+    double gx, gy, gz;          // Body rates, deg/s
+    double ax, ay, az;          // Gravity, g
+};
+
+static Motion motionAt(double t) {
+    const double w1 = 2 * M_PI * 0.11, w2 = 2 * M_PI * 0.07, w3 = 2 * M_PI * 0.013;
+    double r = 25 * sin(w1 * t), rd = 25 * w1 * cos(w1 * t);
+    double p = 15 * sin(w2 * t + 1), pd = 15 * w2 * cos(w2 * t + 1);
+    double yd = 40 * sin(w3 * t); // Yaw rate: turns both ways
+
+    double cr = cos(r * D2R), sr = sin(r * D2R), cp = cos(p * D2R), sp = sin(p * D2R);
+    Motion m;
+    m.roll = r;
+    m.pitch = p;
+    m.gx = rd - yd * sp;
+    m.gy = pd * cr + yd * cp * sr;
+    m.gz = -pd * sr + yd * cp * cr;
+    m.ax = -sp;
+    m.ay = sr * cp;
+    m.az = cr * cp;
+    return m;
+}
+
+// Gaussian-ish sensor noise (sum of uniforms), deterministic
+static uint32_t rng = 12345;
+
+static double noise(double sigma) {
+    double s = 0;
+    for (int i = 0; i < 4; i++) {
+        rng = rng * 1664525u + 1013904223u;
+        s += (rng >> 8) / 16777216.0 - 0.5;
+    }
+    return s * sigma * 1.732; // 4 uniforms: variance 1/3
+}
+
+static double wrap180(double a) {
+    while (a > 180) a -= 360;
+    while (a < -180) a += 360;
+    return a;
+}
+
+// --- fast_math ---
+// Bounds as stated in fast_math.h
+#define INVSQRT_MAX_REL  6.51e-4
+#define SQRT_MAX_REL     8.1e-7
+#define ATAN2_MAX_DEG    1.2e-4
+
+static float nextFloat(float x) {
+    return nextafterf(x, INFINITY);
+}
+
+// Relative error of f against g over every float in [lo, hi)
+static double maxRelError(float (*f)(float), double (*g)(double), float lo, float hi, long* count) {
+    double worst = 0;
+    long n = 0;
+    for (float x = lo; x < hi; x = nextFloat(x), n++) {
+        double ref = g(x);
+        double e = fabs((f(x) - ref) / ref);
+        if (e > worst) worst = e;
+    }
+    *count = n;
+    return worst;
+}
+
+static double refInvSqrt(double x) { return 1.0 / sqrt(x); }
+static double refSqrt(double x) { return sqrt(x); }
+static float fastAtanDeg(float z) { return fastAtan2Deg(z, 1.0f); }
+
+static float libmInvSqrt(float x) { return 1.0f / sqrtf(x); }
+static float libmAtan2Deg(float y, float x) { return atan2f(y, x) * 57.2957795f; }
+static float libmAtan2DegDouble(float y, float x) { return (float)(atan2((double)y, (double)x) * (180.0 / M_PI)); }
+static float libmSqrtDouble(float x) { return (float)sqrt((double)x); }
+
+// ns per call over a block of inputs
+static double time1(float (*f)(float), const std::vector<float>& in, int reps) {
+    float acc = 0;
+    Clock::time_point t0 = Clock::now();
+    for (int r = 0; r < reps; r++) {
+        for (float x : in) acc += f(x);
+    }
+    double ns = nsSince(t0) / ((double)reps * in.size());
+    sink = acc;
+    return ns;
+}
+
+static double time2(float (*f)(float, float), const std::vector<float>& in, int reps) {
+    float acc = 0;
+    Clock::time_point t0 = Clock::now();
+    for (int r = 0; r < reps; r++) {
+        for (size_t i = 0; i + 1 < in.size(); i += 2) acc += f(in[i], in[i + 1]);
+    }
+    double ns = nsSince(t0) / ((double)reps * (in.size() / 2));
+    sink = acc;
+    return ns;
+}
+
+static void benchMath() {
+    printf("math: fast_math against double libm\n\n");
+    printf("  %-34s %12s %12s %12s\n", "max error", "measured", "bound", "inputs");
+
+    // The inverse square root's error repeats every two octaves
+    long n;
+    double inv = maxRelError(fastInvSqrt, refInvSqrt, 1.0f, 4.0f, &n);
+    printf("  %-34s %12.3e %12.3e %12ld\n", "fastInvSqrt (relative, [1,4))", inv, INVSQRT_MAX_REL, n);
+    double sq = maxRelError(fastSqrt, refSqrt, 1.0f, 4.0f, &n);
+    printf("  %-34s %12.3e %12.3e %12ld\n", "fastSqrt (relative, [1,4))", sq, SQRT_MAX_REL, n);
+
+    // atan: every float z in [2^-12, 1] as atan2(z, 1) covers the polynomial's
+    // range; below that atan(z) = z to well under the bound
+    double at = 0;
+    n = 0;
+    for (float z = 1.0f / 4096; z <= 1.0f; z = nextFloat(z), n++) {
+        double e = fabs(fastAtanDeg(z) - atan((double)z) * (180.0 / M_PI));
+        if (e > at) at = e;
+    }
+    // Then the quadrant / octant folding, from random points all round
+    double fold = 0;
+    for (int i = 0; i < 2000000; i++) {
+        float y = (float)noise(1.0), x = (float)noise(1.0);
+        double e = fabs(wrap180(fastAtan2Deg(y, x) - atan2((double)y, (double)x) * (180.0 / M_PI)));
+        if (e > fold) fold = e;
+    }
+    printf("  %-34s %12.3e %12.3e %12ld\n", "fastAtan2Deg (deg, z in [2^-12,1])", at, ATAN2_MAX_DEG, n);
+    printf("  %-34s %12.3e %12.3e %12d\n", "fastAtan2Deg (deg, all quadrants)", fold, ATAN2_MAX_DEG, 2000000);
+    printf("  %-34s %12.3e %12s\n", "fastAtan2Deg(0, 0)", (double)fastAtan2Deg(0, 0), "0");
+    printf("\n");
+
+    check(inv <= INVSQRT_MAX_REL, "fastInvSqrt within its stated bound");
+    check(sq <= SQRT_MAX_REL, "fastSqrt within its stated bound");
+    check(at <= ATAN2_MAX_DEG && fold <= ATAN2_MAX_DEG, "fastAtan2Deg within its stated bound");
+    check(fastSqrt(0) == 0 && fastSqrt(-1) == 0 && fastAtan2Deg(0, 0) == 0, "edge cases (0, negative) return 0");
+
+    // Throughput: tilt-path shaped inputs (|a| ~ 1g squared, components of g)
+    std::vector<float> pos(8192), pair(8192);
+    for (size_t i = 0; i < pos.size(); i++) pos[i] = (float)(0.8 + 0.4 * (i % 977) / 977.0);
+    for (size_t i = 0; i < pair.size(); i++) pair[i] = (float)noise(1.0);
+    const int reps = 500;
+    struct Row {
+        const char* name;
+        double ns;
+    };
+    const Row rows[] = {
+        { "fastInvSqrt", time1(fastInvSqrt, pos, reps) },
+        { "1.0f / sqrtf", time1(libmInvSqrt, pos, reps) },
+        { "fastSqrt", time1(fastSqrt, pos, reps) },
+        { "sqrtf", time1(sqrtf, pos, reps) },
+        { "sqrt (double)", time1(libmSqrtDouble, pos, reps) },
+        { "fastAtan2Deg", time2(fastAtan2Deg, pair, reps) },
+        { "atan2f * RAD_TO_DEG", time2(libmAtan2Deg, pair, reps) },
+        { "atan2 (double) * RAD_TO_DEG", time2(libmAtan2DegDouble, pair, reps) },
+    };
+    printf("\n  %-34s %8s\n", "host throughput", "ns/call");
+    for (const Row& r : rows) printf("  %-34s %8.2f\n", r.name, r.ns);
+}
+
+// --- Fixed point vs float ---
+// Same scales as imu_driver.cpp (ACC_RANGE_4G, GYR_RANGE_64DPS)
+#define ACC_LSB_PER_G    8192.0
+#define GYR_LSB_PER_DPS  512.0
+#define GYRO_COUNTS_TO_Q16 128
+
+// Bounds: the tilt kernel alone, and the whole chain. With tau at 10s the
+// filter remembers ~9000 samples of rounding, so both paths wander ~1e-3 deg
+// from exact arithmetic; fixed must stay as close to it as float does.
+#define TILT_MAX_DEG     5e-4
+#define CHAIN_MAX_DEG    0.005
+#define CHAIN_EXACT_DEG  0.0025
+
+static int16_t toCounts(double v, double lsb, double sigma) {
+    double c = v * lsb + noise(sigma);
+    if (c > 32767) c = 32767;
+    if (c < -32768) c = -32768;
+    return (int16_t)lrint(c);
+}
+
+// The float path's mode 0 step (fuseSample() in imu_driver.cpp)
+struct FloatChain {
+    float roll, pitch;
+
+    void step(const int16_t* raw, float dt, float tau) {
+        float ax = raw[0] / 8192.0f, ay = raw[1] / 8192.0f, az = raw[2] / 8192.0f;
+        float gx = raw[3] / 512.0f, gy = raw[4] / 512.0f;
+        float rawRoll = fastAtan2Deg(ay, az);
+        float rawPitch = fastAtan2Deg(-ax, fastSqrt(ay * ay + az * az));
+        float alpha = tau / (tau + dt);
+        roll = alpha * (roll + gx * dt) + (1.0f - alpha) * rawRoll;
+        pitch = alpha * (pitch + gy * dt) + (1.0f - alpha) * rawPitch;
+    }
+};
+
+// The same step in double with exact trig: what both approximate
+struct DoubleChain {
+    double roll, pitch;
+
+    void step(const int16_t* raw, double dt, double tau) {
+        double rawRoll = atan2((double)raw[1], (double)raw[2]) * (180.0 / M_PI);
+        double rawPitch = atan2(-(double)raw[0], sqrt((double)raw[1] * raw[1] + (double)raw[2] * raw[2])) * (180.0 / M_PI);
+        double alpha = tau / (tau + dt);
+        roll = alpha * (roll + raw[3] / GYR_LSB_PER_DPS * dt) + (1.0 - alpha) * rawRoll;
+        pitch = alpha * (pitch + raw[4] / GYR_LSB_PER_DPS * dt) + (1.0 - alpha) * rawPitch;
+    }
+};
+
+// fuseSampleFixed() mode 0
+struct FixedChain {
+    q16_t roll, pitch;
+
+    void step(const int16_t* raw, uint32_t dt_us, q16_t tau) {
+        q16_t rawRoll, rawPitch;
+        fixedTilt(raw[0], raw[1], raw[2], &rawRoll, &rawPitch);
+        q16_t gx = (q16_t)raw[3] * GYRO_COUNTS_TO_Q16, gy = (q16_t)raw[4] * GYRO_COUNTS_TO_Q16;
+        roll = fixedComplementary(roll, gx, rawRoll, tau, dt_us);
+        pitch = fixedComplementary(pitch, gy, rawPitch, tau, dt_us);
+    }
+};
+
+static uint64_t cycles() {
+#ifdef HAVE_TSC
+    return __rdtsc();
+#else
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+#endif
+}
+
+static void benchFixed() {
+    printf("fixed: Q16.16 path against the float path\n\n");
+
+    // Kernels on raw counts
+    double at = 0;
+    for (int i = 0; i < 2000000; i++) {
+        int32_t y = (int32_t)lrint(noise(9000)), x = (int32_t)lrint(noise(9000));
+        if (!x && !y) continue;
+        double e = fabs(wrap180(Q16_TO_FLOAT(q16Atan2Deg(y, x)) - atan2((double)y, (double)x) * (180.0 / M_PI)));
+        if (e > at) at = e;
+    }
+    double tilt_fixed = 0, tilt_float = 0;
+    for (int i = 0; i < 2000000; i++) {
+        // Accel vectors around 1g in any direction the mount sees (|tilt| < 90)
+        int16_t ax = (int16_t)lrint(noise(4000)), ay = (int16_t)lrint(noise(4000));
+        int16_t az = (int16_t)(4000 + lrint(fabs(noise(4000))));
+        double roll = atan2((double)ay, (double)az) * (180.0 / M_PI);
+        double pitch = atan2(-(double)ax, sqrt((double)ay * ay + (double)az * az)) * (180.0 / M_PI);
+        q16_t qr, qp;
+        fixedTilt(ax, ay, az, &qr, &qp);
+        double e = fmax(fabs(Q16_TO_FLOAT(qr) - roll), fabs(Q16_TO_FLOAT(qp) - pitch));
+        if (e > tilt_fixed) tilt_fixed = e;
+        float fx = ax / 8192.0f, fy = ay / 8192.0f, fz = az / 8192.0f;
+        e = fmax(fabs(fastAtan2Deg(fy, fz) - roll), fabs(fastAtan2Deg(-fx, fastSqrt(fy * fy + fz * fz)) - pitch));
+        if (e > tilt_float) tilt_float = e;
+    }
+    printf("  %-34s %12s\n", "max error vs double (deg)", "");
+    printf("  %-34s %12.3e\n", "q16Atan2Deg", at);
+    printf("  %-34s %12.3e\n", "fixedTilt", tilt_fixed);
+    printf("  %-34s %12.3e\n", "float tilt (fastAtan2Deg/fastSqrt)", tilt_float);
+
+    // The whole chain on one stream of sensor counts: the reference
+    // trajectory with noise, tau switching between 1s and the 10s floor
+    const long samples = (long)(120.0 / DT);
+    std::vector<int16_t> raw(samples * 6);
+    for (long i = 0; i < samples; i++) {
+        Motion m = motionAt(i * DT);
+        int16_t* r = &raw[i * 6];
+        r[0] = toCounts(m.ax, ACC_LSB_PER_G, 16);
+        r[1] = toCounts(m.ay, ACC_LSB_PER_G, 16);
+        r[2] = toCounts(m.az, ACC_LSB_PER_G, 16);
+        r[3] = toCounts(m.gx, GYR_LSB_PER_DPS, 10);
+        r[4] = toCounts(m.gy, GYR_LSB_PER_DPS, 10);
+        r[5] = toCounts(m.gz, GYR_LSB_PER_DPS, 10);
+    }
+    auto tauAt = [](long i) -> q16_t { return ((long)(i * DT) / 10) % 2 ? 10 * Q16_ONE : Q16_ONE; };
+
+    Motion m0 = motionAt(0);
+    double r0 = m0.roll, p0 = m0.pitch;
+    FloatChain fl = { (float)r0, (float)p0 };
+    FixedChain fx = { Q16_FROM_FLOAT((float)r0), Q16_FROM_FLOAT((float)p0) };
+    DoubleChain db = { r0, p0 };
+    struct Diff {
+        double sum, max;
+        void add(double d) {
+            sum += d;
+            if (d > max) max = d;
+        }
+    } flfx = {0, 0}, fldb = {0, 0}, fxdb = {0, 0};
+    for (long i = 0; i < samples; i++) {
+        q16_t tau = tauAt(i);
+        fl.step(&raw[i * 6], (float)DT, Q16_TO_FLOAT(tau));
+        fx.step(&raw[i * 6], IMU_SAMPLE_PERIOD_US, tau);
+        db.step(&raw[i * 6], DT, Q16_TO_FLOAT(tau));
+        double fxr = Q16_TO_FLOAT(fx.roll), fxp = Q16_TO_FLOAT(fx.pitch);
+        flfx.add(fmax(fabs(fl.roll - fxr), fabs(fl.pitch - fxp)));
+        fldb.add(fmax(fabs(fl.roll - db.roll), fabs(fl.pitch - db.pitch)));
+        fxdb.add(fmax(fabs(fxr - db.roll), fabs(fxp - db.pitch)));
+    }
+    printf("\n  %-34s %12s %12s\n", "chain, 120s (deg)", "avg", "max");
+    printf("  %-34s %12.2e %12.2e\n", "|float - fixed|", flfx.sum / samples, flfx.max);
+    printf("  %-34s %12.2e %12.2e\n", "|float - double|", fldb.sum / samples, fldb.max);
+    printf("  %-34s %12.2e %12.2e\n", "|fixed - double|", fxdb.sum / samples, fxdb.max);
+    printf("\n");
+
+    check(at <= 1.2e-4, "q16Atan2Deg within its stated 1.2e-4 deg");
+    check(tilt_fixed <= TILT_MAX_DEG, "fixedTilt within 5e-4 deg of double");
+    check(flfx.max <= CHAIN_MAX_DEG, "fixed chain within 0.005 deg of float over 120s");
+    check(fxdb.max <= CHAIN_EXACT_DEG && fxdb.max <= fldb.max, "fixed chain as close to exact as float");
+
+    // Cost per sample of each chain over the stored stream
+    const long n = 8192;
+    const int reps = 50;
+    uint64_t c0 = cycles();
+    Clock::time_point t0 = Clock::now();
+    for (int r = 0; r < reps; r++) {
+        for (long i = 0; i < n; i++) fl.step(&raw[i * 6], (float)DT, 1.0f);
+    }
+    double fl_cyc = (double)(cycles() - c0) / (reps * n), fl_ns = nsSince(t0) / (reps * n);
+    c0 = cycles();
+    t0 = Clock::now();
+    for (int r = 0; r < reps; r++) {
+        for (long i = 0; i < n; i++) fx.step(&raw[i * 6], IMU_SAMPLE_PERIOD_US, Q16_ONE);
+    }
+    double fx_cyc = (double)(cycles() - c0) / (reps * n), fx_ns = nsSince(t0) / (reps * n);
+    sink = fl.roll + Q16_TO_FLOAT(fx.roll);
+#ifdef HAVE_TSC
+    const char* unit = "TSC cycles";
+#else
+    const char* unit = "ns (no TSC)";
+#endif
+    printf("\n  %-34s %12s %12s\n", "host cost per sample", unit, "ns");
+    printf("  %-34s %12.1f %12.1f\n", "float chain", fl_cyc, fl_ns);
+    printf("  %-34s %12.1f %12.1f\n", "fixed chain", fx_cyc, fx_ns);
+}
+
+// --- Mahony ---
+struct MahonyRun {
+    double roll_err_max, pitch_err_max;
+    double roll_err_rms, pitch_err_rms;
+    double norm_err_max;        // | |q| - 1 |
+};
+
+// 120s of the trajectory at the sensor rate; errors after `settle` seconds
+static MahonyRun runMahony(float kp, double gyro_sigma, double acc_sigma, double gyro_bias, double settle) {
+    MahonyFilter f;
+    mahonyInit(&f, 0.0f);
+    Motion m0 = motionAt(0);
+    mahonySeed(&f, (float)m0.ax, (float)m0.ay, (float)m0.az);
+
+    MahonyRun run = {0};
+    double rs = 0, ps = 0;
+    long n = 0;
+    const long samples = (long)(120.0 / DT);
+    for (long i = 1; i <= samples; i++) {
+        // Rates at the middle of the step, gravity at its end
+        Motion mid = motionAt((i - 0.5) * DT);
+        Motion m = motionAt(i * DT);
+        mahonyUpdate(&f, (float)(mid.gx + gyro_bias + noise(gyro_sigma)), (float)(mid.gy - gyro_bias + noise(gyro_sigma)),
+                     (float)(mid.gz + noise(gyro_sigma)), (float)(m.ax + noise(acc_sigma)),
+                     (float)(m.ay + noise(acc_sigma)), (float)(m.az + noise(acc_sigma)), kp, (float)DT);
+
+        double norm = sqrt((double)f.q0 * f.q0 + (double)f.q1 * f.q1 + (double)f.q2 * f.q2 + (double)f.q3 * f.q3);
+        if (fabs(norm - 1) > run.norm_err_max) run.norm_err_max = fabs(norm - 1);
+        if (i * DT < settle) continue;
+
+        float roll, pitch;
+        mahonyGetRollPitch(&f, &roll, &pitch);
+        double re = fabs(wrap180(roll - m.roll)), pe = fabs(pitch - m.pitch);
+        if (re > run.roll_err_max) run.roll_err_max = re;
+        if (pe > run.pitch_err_max) run.pitch_err_max = pe;
+        rs += re * re;
+        ps += pe * pe;
+        n++;
+    }
+    run.roll_err_rms = sqrt(rs / n);
+    run.pitch_err_rms = sqrt(ps / n);
+    return run;
+}
+
+static void printRun(const char* name, const MahonyRun& r) {
+    printf("  %-34s %7.4f %7.4f %7.4f %7.4f %10.2e\n", name, r.roll_err_rms, r.roll_err_max, r.pitch_err_rms,
+           r.pitch_err_max, r.norm_err_max);
+}
+
+static void benchMahony() {
+    printf("mahony: 120s of +/-25 deg roll, +/-15 deg pitch, +/-40 dps yaw at %u us per sample\n\n",
+           IMU_SAMPLE_PERIOD_US);
+    printf("  %-34s %7s %7s %7s %7s %10s\n", "deg error vs truth", "roll", "max", "pitch", "max", "||q|-1|");
+
+    // Gyro only, exact rates: integration and normalisation error alone
+    MahonyRun gyro = runMahony(0.0f, 0, 0, 0, 0);
+    printRun("gyro only (kp 0, no noise)", gyro);
+
+    // Driver settings: tau 1s (TAU_BASE), ki 0, sensor noise and the
+    // residual bias the online estimator leaves (~0.05 dps)
+    MahonyRun noisy = runMahony(1.0f, 0.05, 0.003, 0.05, 5);
+    printRun("kp 1/s, noise + 0.05 dps bias", noisy);
+
+    // Turning (tau 10s floor): mostly gyro, slower to pull the bias out
+    MahonyRun slow = runMahony(0.1f, 0.05, 0.003, 0.05, 30);
+    printRun("kp 0.1/s, noise + 0.05 dps bias", slow);
+    printf("\n");
+
+    check(gyro.norm_err_max < 1e-5, "|q| held at 1 (normalisation)");
+    check(gyro.roll_err_max < 0.01 && gyro.pitch_err_max < 0.01, "gyro-only integration within 0.01 deg over 120s");
+    check(noisy.roll_err_max < 0.25 && noisy.pitch_err_max < 0.25, "kp 1/s within 0.25 deg of truth");
+    check(slow.roll_err_max < 1.0 && slow.pitch_err_max < 1.0, "kp 0.1/s within 1 deg of truth");
+    check(noisy.norm_err_max < 1e-5 && slow.norm_err_max < 1e-5, "|q| held at 1 with accel correction");
+
+    // Cost: a fixed block of precomputed inputs, replayed
+    const int N = 4096;
+    std::vector<float> in(N * 6);
+    for (int i = 0; i < N; i++) {
+        Motion m = motionAt(i * DT);
+        float v[6] = { (float)m.gx, (float)m.gy, (float)m.gz, (float)m.ax, (float)m.ay, (float)m.az };
+        memcpy(&in[i * 6], v, sizeof(v));
+    }
+    MahonyFilter f;
+    mahonyInit(&f, 0.0f);
+    mahonySeed(&f, in[3], in[4], in[5]);
+    const int reps = 200;
+    Clock::time_point t0 = Clock::now();
+    for (int r = 0; r < reps; r++) {
+        for (int i = 0; i < N; i++) {
+            const float* v = &in[i * 6];
+            mahonyUpdate(&f, v[0], v[1], v[2], v[3], v[4], v[5], 1.0f, (float)DT);
+        }
+    }
+    double upd = nsSince(t0) / ((double)reps * N);
+
+    float acc = 0;
+    t0 = Clock::now();
+    for (int r = 0; r < reps * N; r++) {
+        float roll, pitch;
+        f.q1 += 1e-9f; // Keep the call in the loop
+        mahonyGetRollPitch(&f, &roll, &pitch);
+        acc += roll + pitch;
+    }
+    double get = nsSince(t0) / ((double)reps * N);
+    sink = acc;
+    printf("\n  %-34s %8.1f ns\n", "mahonyUpdate()", upd);
+    printf("  %-34s %8.1f ns\n", "mahonyGetRollPitch()", get);
+    printf("  %-34s %8.2f %%\n", "per sample share of one CPU",
+           (upd + get) / (IMU_SAMPLE_PERIOD_US * 1000.0) * 100);
+}
+
+struct Section {
+    const char* name;
+    void (*fn)();
+};
+
+static const Section sections[] = {
+    { "math", benchMath },
+    { "fixed", benchFixed },
+    { "mahony", benchMahony },
+};
+
+int main(int argc, char** argv) {
+    bool first = true;
+    for (const Section& s : sections) {
+        bool selected = argc < 2;
+        for (int i = 1; i < argc; i++) selected |= !strcmp(argv[i], s.name);
+        if (!selected) continue;
+        if (!first) printf("\n");
+        first = false;
+        s.fn();
+    }
+    printf("\n%s\n", failures ? "FAIL" : "OK");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,568 @@
+/*
+ * File: sim.cpp
+ * Description: Host Simulation of the Shared I2C Bus Manager
+ * Author: zzackk125
+ * License: MIT
+ *
+ *   i2c_sim [scenario...]
+ *
+ * Runs src/i2c_bus.cpp under imu_replay's cooperative FreeRTOS scheduler
+ * (host_task.cpp) on a virtual clock. Wire is a mock bus that charges every
+ * transfer by a latency model (bus clock, driver overhead per phase, slave
+ * clock stretching) and flags transfers that overlap on the wire. The IMU
+ * drain, LVGL's touch poll and the loop's expander writes run as tasks at
+ * their firmware priorities. Each scenario runs in its own process (the bus
+ * manager's state is static); the exit status is non-zero if a check fails.
+ */
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "board_config.h"
+#include "i2c_bus.h"
+#include "host_task.h"
+
+// --- Host environment ---
+static uint64_t now_us = 0;
+uint32_t micros() { return (uint32_t)now_us; }
+uint32_t millis() { return (uint32_t)(now_us / 1000); }
+uint64_t hostMicros64() { return now_us; }
+void hostSetMicros(uint32_t us) { now_us += (int32_t)(us - (uint32_t)now_us); }
+HostSerial Serial;
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    if (!ok) {
+        printf("    FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+static uint32_t rng = 7;
+
+static uint32_t randUs(uint32_t lo, uint32_t hi) {
+    rng = rng * 1103515245u + 12345u;
+    return lo + (rng >> 8) % (hi - lo + 1);
+}
+
+// --- Mock bus ---
+// Each phase (the write, and the read after a repeated start) costs a fixed
+// driver overhead plus 9 clocks per byte including the address, plus start
+// and stop; the slave may stretch the clock once per transaction. The task
+// blocks meanwhile, as on the ESP32 driver's completion interrupt.
+#define IMU_ADDR 0x6B   // QMI8658_L_SLAVE_ADDRESS
+
+struct BusModel {
+    uint32_t overhead_us;
+    uint32_t stretch_us[I2C_DEV_COUNT];
+    bool nack[I2C_DEV_COUNT];
+};
+static BusModel model = { 25, { 0, 0, 0 }, { false, false, false } };
+
+struct Transfer {
+    int dev;
+    uint64_t start_us, end_us;
+};
+static std::vector<Transfer> transfers;
+static int on_wire = 0;           // Transfers begun and not finished
+static uint32_t collisions = 0;   // Begun while another was on the wire (corrupt on the device)
+
+TwoWire Wire;
+
+static int devOf(uint8_t addr) {
+    if (addr == IMU_ADDR) return I2C_DEV_IMU;
+    if (addr == DISP_TOUCH_ADDR) return I2C_DEV_TOUCH;
+    if (addr == IO_EXPANDER_ADDR) return I2C_DEV_EXPANDER;
+    return -1;
+}
+
+static uint32_t phaseUs(size_t bytes) {
+    return model.overhead_us + (uint32_t)(((uint64_t)bytes * 9 + 2) * 1000000 / Wire.clock_hz);
+}
+
+// Per call: when the client asked and when its first transfer started
+struct Call {
+    int dev;
+    uint64_t req_us, first_us, done_us;
+    bool started, ok;
+};
+static std::vector<Call> calls;
+static Call* active[I2C_DEV_COUNT] = { NULL, NULL, NULL };
+static uint64_t xfer_start = 0;
+
+static void endTransfer(int dev) {
+    on_wire--;
+    transfers.push_back({ dev, xfer_start, hostMicros64() });
+}
+
+void TwoWire::beginTransmission(uint8_t a) {
+    addr = a;
+    tx_len = 0;
+    int dev = devOf(a);
+    if (on_wire) collisions++;
+    on_wire++;
+    xfer_start = hostMicros64();
+    if (dev >= 0 && active[dev] && !active[dev]->started) {
+        active[dev]->started = true;
+        active[dev]->first_us = xfer_start;
+    }
+}
+
+size_t TwoWire::write(uint8_t b) {
+    if (tx_len < sizeof(tx)) tx[tx_len++] = b;
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t* data, size_t len) {
+    for (size_t i = 0; i < len; i++) write(data[i]);
+    return len;
+}
+
+uint8_t TwoWire::endTransmission(bool stop) {
+    int dev = devOf(addr);
+    hostTaskWaitUs(phaseUs(1 + tx_len) + (dev >= 0 ? model.stretch_us[dev] : 0));
+    bool ok = dev >= 0 && !model.nack[dev];
+    if (stop || !ok) endTransfer(dev);
+    return ok ? 0 : 2;
+}
+
+size_t TwoWire::requestFrom(uint8_t a, size_t len, bool) {
+    int dev = devOf(a);
+    hostTaskWaitUs(phaseUs(1 + len));
+    endTransfer(dev);
+    rx_len = len < sizeof(rx) ? len : sizeof(rx);
+    memset(rx, 0, rx_len);
+    rx_pos = 0;
+    return rx_len;
+}
+
+// --- Clients ---
+// managed = false: straight to Wire, as before the bus manager
+static bool managed = true;
+
+static const uint8_t dev_addr[I2C_DEV_COUNT] = { IMU_ADDR, DISP_TOUCH_ADDR, IO_EXPANDER_ADDR };
+
+// One register transaction: read read_len bytes, or write one (read_len 0)
+static Call transact(I2CDevice dev, uint8_t reg, size_t read_len, uint32_t timeout_ms = I2C_TIMEOUT_DEVICE) {
+    Call c = { dev, hostMicros64(), 0, 0, false, false };
+    active[dev] = &c;
+    uint8_t buf[128] = { 0 };
+    if (managed) {
+        c.ok = read_len ? i2cReadRegs(dev, dev_addr[dev], reg, buf, read_len, timeout_ms)
+                        : i2cWriteReg(dev, dev_addr[dev], reg, buf, 1, timeout_ms);
+    } else {
+        Wire.beginTransmission(dev_addr[dev]);
+        Wire.write(reg);
+        if (read_len) {
+            c.ok = Wire.endTransmission(false) == 0 && Wire.requestFrom(dev_addr[dev], read_len) == read_len;
+        } else {
+            Wire.write(buf, 1);
+            c.ok = Wire.endTransmission() == 0;
+        }
+    }
+    if (active[dev] == &c) active[dev] = NULL;   // Not a later call of the same device still waiting
+    c.done_us = hostMicros64();
+    calls.push_back(c);
+    return c;
+}
+
+// drainFIFO()'s transactions for a watermark batch (9 frames at 10ms)
+static uint32_t imu_drains = 0, imu_drain_max_us = 0;
+
+static void imuDrain() {
+    uint64_t t0 = hostMicros64();
+    transact(I2C_DEV_IMU, 0x16, 1);          // FIFO_STATUS
+    transact(I2C_DEV_IMU, 0x0A, 0);          // CTRL9 REQ_FIFO
+    transact(I2C_DEV_IMU, 0x2D, 1);          // STATUSINT CmdDone
+    transact(I2C_DEV_IMU, 0x0A, 0);          // CTRL9 ACK
+    transact(I2C_DEV_IMU, 0x15, 2);          // FIFO_SMPL_CNT
+    transact(I2C_DEV_IMU, 0x17, 9 * 12);     // FIFO_DATA
+    transact(I2C_DEV_IMU, 0x14, 0);          // FIFO_CTRL
+    transact(I2C_DEV_IMU, 0x30, 3);          // Sample counter
+    uint32_t us = (uint32_t)(hostMicros64() - t0);
+    if (us > imu_drain_max_us) imu_drain_max_us = us;
+    imu_drains++;
+}
+
+static void imuTask(void*) {
+    TickType_t wake = xTaskGetTickCount();
+    for (;;) {
+        imuDrain();
+        vTaskDelayUntil(&wake, pdMS_TO_TICKS(IMU_TASK_PERIOD_MS));
+    }
+}
+
+// Periods of the touch poll and the expander writes (random within the range)
+static uint32_t touch_min_us, touch_max_us, exp_min_us, exp_max_us;
+
+static void touchTask(void*) {
+    for (;;) {
+        transact(I2C_DEV_TOUCH, 0x02, 5);    // touch_read_cb
+        hostTaskWaitUs(randUs(touch_min_us, touch_max_us));
+    }
+}
+
+static void expanderTask(void*) {
+    for (;;) {
+        transact(I2C_DEV_EXPANDER, IO_EXPANDER_OUTPUT_REG, 0);
+        hostTaskWaitUs(randUs(exp_min_us, exp_max_us));
+    }
+}
+
+// --- Results ---
+struct DevResult {
+    uint32_t calls, failed;
+    uint32_t wait_max_us, wait_avg_us;   // Request to first transfer
+    uint32_t hold_max_us;                // First transfer to done
+};
+
+struct LoadResult {
+    uint32_t clock_hz;
+    bool managed;
+    DevResult dev[I2C_DEV_COUNT];
+    uint32_t collisions;
+    uint32_t inversions;     // Lower device started while a higher one was waiting
+    uint32_t drain_max_us, drains;
+    I2CBusStats bus;
+};
+
+static uint32_t priorityInversions() {
+    uint32_t n = 0;
+    for (const Call& lo : calls) {
+        if (!lo.started) continue;
+        for (const Call& hi : calls) {
+            if (hi.dev >= lo.dev || !hi.started) continue;
+            if (hi.req_us < lo.first_us && hi.first_us > lo.first_us) n++;
+        }
+    }
+    return n;
+}
+
+static void summarize(LoadResult* r) {
+    memset(r->dev, 0, sizeof(r->dev));
+    uint64_t wait_sum[I2C_DEV_COUNT] = { 0, 0, 0 };
+    for (const Call& c : calls) {
+        DevResult& d = r->dev[c.dev];
+        d.calls++;
+        if (!c.ok) d.failed++;
+        uint32_t wait = (uint32_t)((c.started ? c.first_us : c.done_us) - c.req_us);
+        wait_sum[c.dev] += wait;
+        if (wait > d.wait_max_us) d.wait_max_us = wait;
+        if (c.started && c.done_us - c.first_us > d.hold_max_us) d.hold_max_us = (uint32_t)(c.done_us - c.first_us);
+    }
+    for (int d = 0; d < I2C_DEV_COUNT; d++) {
+        if (r->dev[d].calls) r->dev[d].wait_avg_us = (uint32_t)(wait_sum[d] / r->dev[d].calls);
+    }
+    r->collisions = collisions;
+    r->inversions = priorityInversions();
+    r->drain_max_us = imu_drain_max_us;
+    r->drains = imu_drains;
+    getI2CBusStats(&r->bus);
+}
+
+// Each run gets a fresh bus manager: in a child, result back over a pipe
+static LoadResult measure(LoadResult (*run)(uint32_t, bool), uint32_t clock_hz, bool mgd) {
+    LoadResult r;
+    memset(&r, 0, sizeof(r));
+    int fd[2];
+    if (pipe(fd)) return r;
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fd[0]);
+        r = run(clock_hz, mgd);
+        if (write(fd[1], &r, sizeof(r)) != sizeof(r)) _exit(1);
+        _exit(0);
+    }
+    close(fd[1]);
+    if (read(fd[0], &r, sizeof(r)) != sizeof(r)) memset(&r, 0, sizeof(r));
+    close(fd[0]);
+    waitpid(pid, NULL, 0);
+    return r;
+}
+
+// --- Scenarios ---
+// priority: the IMU drains every IMU_TASK_PERIOD_MS while touch is polled
+// every 0.5-2ms and the expander written every 1-3ms (far above the firmware
+// rates, to keep the bus contended). Before (no manager: everyone drives
+// Wire) and after, at 100kHz and in fast mode.
+#define LOAD_RUN_US 2000000
+
+static LoadResult loadRun(uint32_t clock_hz, bool mgd) {
+    hostTasksInit();
+    managed = mgd;
+    i2cBusInit();
+    Wire.setClock(clock_hz);
+    touch_min_us = 500;
+    touch_max_us = 2000;
+    exp_min_us = 1000;
+    exp_max_us = 3000;
+    xTaskCreate(imuTask, "IMU", 0, NULL, IMU_TASK_PRIORITY, NULL);
+    xTaskCreate(touchTask, "LVGL", 0, NULL, LVGL_TASK_PRIORITY, NULL);
+    xTaskCreate(expanderTask, "loop", 0, NULL, 1, NULL);
+    hostTasksRunUntil(LOAD_RUN_US);
+    LoadResult r;
+    r.clock_hz = clock_hz;
+    r.managed = mgd;
+    summarize(&r);
+    return r;
+}
+
+static void printLoad(const char* label, const LoadResult& r) {
+    printf("    %-22s %5u/%5u %5u/%5u %5u/%5u %6u %6u %6u %5u\n", label, (unsigned)r.dev[0].wait_avg_us,
+           (unsigned)r.dev[0].wait_max_us, (unsigned)r.dev[1].wait_avg_us, (unsigned)r.dev[1].wait_max_us,
+           (unsigned)r.dev[2].wait_avg_us, (unsigned)r.dev[2].wait_max_us, (unsigned)r.drain_max_us,
+           (unsigned)r.collisions, (unsigned)r.inversions, (unsigned)r.bus.max_queue_depth);
+}
+
+static void priority() {
+    LoadResult before = measure(loadRun, I2C_BUS_CLOCK_HZ, false);
+    LoadResult slow = measure(loadRun, 100000, true);
+    LoadResult after = measure(loadRun, I2C_BUS_CLOCK_HZ, true);
+
+    printf("    %-22s %11s %11s %11s %6s %6s %6s %5s\n", "wait avg/max us", "IMU", "touch", "expander", "drain",
+           "collide", "invert", "depth");
+    printLoad("no manager (before)", before);
+    printLoad("manager, 100 kHz", slow);
+    printLoad("manager, fast mode", after);
+    const LoadResult& r = after;
+    uint32_t lower_hold = r.dev[1].hold_max_us > r.dev[2].hold_max_us ? r.dev[1].hold_max_us : r.dev[2].hold_max_us;
+    printf("    fast mode: %u IMU drains, %u touch and %u expander transactions (%u / %u timed out, %u / %u "
+           "backed off)\n", (unsigned)r.drains, (unsigned)r.dev[1].calls, (unsigned)r.dev[2].calls,
+           (unsigned)r.bus.devices[1].timeouts, (unsigned)r.bus.devices[2].timeouts,
+           (unsigned)r.bus.devices[1].deferred, (unsigned)r.bus.devices[2].deferred);
+    printf("    IMU worst wait %u us, longest lower priority transaction %u us\n", (unsigned)r.dev[0].wait_max_us,
+           (unsigned)lower_hold);
+
+    check(before.collisions > 0, "the mock sees overlapping transfers without the manager");
+    check(r.collisions == 0, "no overlapping transfers with the manager");
+    check(r.inversions == 0, "no device started while a higher priority one was waiting");
+    check(r.dev[0].wait_max_us <= lower_hold, "IMU waits for at most one transaction in flight");
+    check(r.dev[0].failed == 0 && r.bus.devices[0].timeouts == 0, "no IMU transaction failed");
+    check(r.drain_max_us < IMU_TASK_PERIOD_MS * 1000 / 2, "IMU drain within half its period");
+    check(r.dev[1].calls > r.drains && r.dev[2].calls > r.drains, "touch and expander still got the bus");
+    check(r.bus.queue_depth <= 3 && r.bus.max_queue_depth >= 2, "queue depth tracked");
+    check(after.drain_max_us < slow.drain_max_us, "fast mode shortens the drain");
+}
+
+// Scripted requests: each task asks once at its time and records the call
+struct Op {
+    I2CDevice dev;
+    uint32_t at_us;
+    size_t read_len;
+    Call call;
+    uint32_t timeout_ms = I2C_TIMEOUT_DEVICE;
+};
+
+static void opTask(void* arg) {
+    Op* op = (Op*)arg;
+    if (op->at_us > hostMicros64()) hostTaskWaitUs((uint32_t)(op->at_us - hostMicros64()));
+    op->call = transact(op->dev, 0x00, op->read_len, op->timeout_ms);
+}
+
+static const int dev_prio[I2C_DEV_COUNT] = { IMU_TASK_PRIORITY, LVGL_TASK_PRIORITY, 1 };
+
+static void startOp(Op* op) {
+    xTaskCreate(opTask, "op", 0, op, dev_prio[op->dev], NULL);
+}
+
+// backoff: the expander's slave stretches the clock while the IMU queues and
+// then touch asks. Touch sees the IMU waiting and backs off a tick at a time
+// (vTaskDelay(1)) until the IMU is done; with a longer stretch its 2ms
+// timeout runs out first and the IMU, with 5ms, still gets the bus.
+static void backoff() {
+    hostTasksInit();
+    i2cBusInit();
+    I2CBusStats s0, s1, s2;
+
+    // Stretch 1.5ms: deferred, then granted
+    model.stretch_us[I2C_DEV_EXPANDER] = 1500;
+    Op e1 = { I2C_DEV_EXPANDER, 0, 0, {} }, i1 = { I2C_DEV_IMU, 200, 3, {} }, t1 = { I2C_DEV_TOUCH, 400, 5, {} };
+    startOp(&e1);
+    startOp(&i1);
+    startOp(&t1);
+    getI2CBusStats(&s0);
+    hostTasksRunUntil(10000);
+    getI2CBusStats(&s1);
+    printf("    stretch 1500 us: expander done %u us, IMU waited %u us, touch waited %u us (%u deferral), "
+           "granted %u us\n", (unsigned)e1.call.done_us, (unsigned)(i1.call.first_us - i1.call.req_us),
+           (unsigned)(t1.call.first_us - t1.call.req_us), (unsigned)(s1.devices[1].deferred - s0.devices[1].deferred),
+           (unsigned)t1.call.first_us);
+    check(i1.call.ok && t1.call.ok && e1.call.ok, "all three granted");
+    check(i1.call.first_us == e1.call.done_us, "IMU next after the transfer in flight");
+    check(s1.devices[1].deferred - s0.devices[1].deferred == 1, "touch backed off for the waiting IMU");
+    check(t1.call.first_us >= i1.call.done_us && t1.call.first_us % 1000 == 0, "touch retried on a tick after the IMU");
+
+    // Stretch 4ms: touch gives up after I2C_TOUCH_TIMEOUT_MS, the IMU waits it out
+    model.stretch_us[I2C_DEV_EXPANDER] = 4000;
+    Op e2 = { I2C_DEV_EXPANDER, 10000, 0, {} }, i2 = { I2C_DEV_IMU, 10200, 3, {} }, t2 = { I2C_DEV_TOUCH, 10400, 5, {} };
+    startOp(&e2);
+    startOp(&i2);
+    startOp(&t2);
+    hostTasksRunUntil(20000);
+    getI2CBusStats(&s2);
+    printf("    stretch 4000 us: IMU waited %u us, touch gave up after %u us (%u timeout)\n",
+           (unsigned)(i2.call.first_us - i2.call.req_us), (unsigned)(t2.call.done_us - t2.call.req_us),
+           (unsigned)(s2.devices[1].timeouts - s1.devices[1].timeouts));
+    check(i2.call.ok && !t2.call.started && !t2.call.ok, "IMU granted, touch skipped its poll");
+    check(s2.devices[1].timeouts - s1.devices[1].timeouts == 1, "touch timeout counted");
+    check(t2.call.done_us - t2.call.req_us <= (I2C_TOUCH_TIMEOUT_MS + 1) * 1000, "touch gave up within its timeout");
+    check(s2.devices[0].timeouts == 0, "IMU never timed out");
+    check(s2.queue_depth == 0, "queue empty afterwards");
+}
+
+// nested: the IMU holds the bus across a SensorLib-style sequence with
+// register helpers nested inside (configureSensor()), one of them NACKed.
+// Touch and the expander queue meanwhile and must not get in until the
+// outer unlock; the section counts as one transaction with one error.
+static Op n_touch = { I2C_DEV_TOUCH, 100, 5, {} }, n_exp = { I2C_DEV_EXPANDER, 150, 0, {} };
+static uint64_t section_start = 0, section_end = 0;
+static bool nested_ok[3];
+
+static void sectionTask(void*) {
+    if (!i2cBusLock(I2C_DEV_IMU)) return;
+    section_start = hostMicros64();
+    uint8_t b[3] = { 0, 0, 0 };
+    nested_ok[0] = i2cWriteReg(I2C_DEV_IMU, IMU_ADDR, 0x13, b, 1);
+    hostTaskSleepUs(300);                              // SensorLib work between registers
+    model.nack[I2C_DEV_IMU] = true;
+    nested_ok[1] = i2cReadRegs(I2C_DEV_IMU, IMU_ADDR, 0x02, b, 1);
+    model.nack[I2C_DEV_IMU] = false;
+    hostTaskSleepUs(300);
+    nested_ok[2] = i2cReadRegs(I2C_DEV_IMU, IMU_ADDR, 0x30, b, 3);
+    section_end = hostMicros64();
+    i2cBusUnlock(I2C_DEV_IMU);
+}
+
+static void nested() {
+    hostTasksInit();
+    i2cBusInit();
+    xTaskCreate(sectionTask, "IMU", 0, NULL, IMU_TASK_PRIORITY, NULL);
+    startOp(&n_touch);
+    startOp(&n_exp);
+    hostTasksRunUntil(5000);
+
+    // Afterwards the bus is free to anyone at once
+    Op t = { I2C_DEV_TOUCH, 6000, 5, {} };
+    startOp(&t);
+    hostTasksRunUntil(10000);
+
+    uint32_t inside = 0;
+    for (const Transfer& x : transfers) {
+        if (x.dev != I2C_DEV_IMU && x.start_us < section_end && x.end_us > section_start) inside++;
+    }
+    I2CBusStats s;
+    getI2CBusStats(&s);
+    printf("    section %u-%u us: nested %d/%d/%d, touch in at %u us, expander at %u us, %u foreign transfers inside\n",
+           (unsigned)section_start, (unsigned)section_end, nested_ok[0], nested_ok[1], nested_ok[2],
+           (unsigned)n_touch.call.first_us, (unsigned)n_exp.call.first_us, (unsigned)inside);
+    printf("    IMU: %u transactions, %u errors; later touch waited %u us\n", (unsigned)s.devices[0].transactions,
+           (unsigned)s.devices[0].errors, (unsigned)(t.call.first_us - t.call.req_us));
+    check(nested_ok[0] && !nested_ok[1] && nested_ok[2], "nested helpers run inside the lock (NACK reported)");
+    check(inside == 0, "nobody else on the bus inside the section");
+    check(n_touch.call.ok && n_exp.call.ok, "touch and expander granted after the section");
+    check(n_touch.call.first_us >= section_end && n_exp.call.first_us >= n_touch.call.done_us,
+          "queued in priority order behind the section");
+    check(s.devices[0].transactions == 1 && s.devices[0].errors == 1, "one transaction, one error for the section");
+    check(t.call.ok && t.call.first_us == t.call.req_us, "lock fully released (holder and nesting reset)");
+    check(s.queue_depth == 0, "queue empty afterwards");
+}
+
+// boot-power: the IMU task's bring-up (configureSensor()) holds the bus for
+// the QMI8658 soft reset and its polling, far past I2C_EXPANDER_TIMEOUT_MS.
+// The display power-on write, from setup() at the loop's priority, is lost
+// with the expander's runtime timeout; with I2C_WAIT_FOREVER it lands right
+// after the section. (setup() writes it before starting the IMU task anyway.)
+#define BRINGUP_US 80000
+static uint64_t bringup_end = 0;
+
+static void bringUpTask(void*) {
+    if (!i2cBusLock(I2C_DEV_IMU)) return;
+    uint8_t b = 0;
+    for (uint32_t t = 0; t < BRINGUP_US; t += 1000) {
+        i2cReadRegs(I2C_DEV_IMU, IMU_ADDR, 0x00, &b, 1);   // Reset done?
+        hostTaskWaitUs(1000);
+    }
+    bringup_end = hostMicros64();
+    i2cBusUnlock(I2C_DEV_IMU);
+}
+
+static void bootPower() {
+    hostTasksInit();
+    i2cBusInit();
+
+    // Power-on before the IMU task exists: granted at once
+    Op first = { I2C_DEV_EXPANDER, 0, 0, {} };
+    first.timeout_ms = I2C_WAIT_FOREVER;
+    startOp(&first);
+    hostTasksRunUntil(1000);
+
+    xTaskCreate(bringUpTask, "IMU", 0, NULL, IMU_TASK_PRIORITY, NULL);
+    Op runtime = { I2C_DEV_EXPANDER, 2000, 0, {} };
+    Op forever = { I2C_DEV_EXPANDER, 3000, 0, {} };
+    forever.timeout_ms = I2C_WAIT_FOREVER;
+    startOp(&runtime);
+    startOp(&forever);
+    hostTasksRunUntil(200000);
+
+    I2CBusStats s;
+    getI2CBusStats(&s);
+    printf("    before the IMU task: waited %u us; during bring-up (%u us): %u ms timeout %s after %u us, "
+           "wait forever %s after %u us\n", (unsigned)(first.call.first_us - first.call.req_us),
+           (unsigned)bringup_end, (unsigned)I2C_EXPANDER_TIMEOUT_MS, runtime.call.ok ? "ok" : "lost",
+           (unsigned)(runtime.call.done_us - runtime.call.req_us), forever.call.ok ? "ok" : "lost",
+           (unsigned)(forever.call.done_us - forever.call.req_us));
+    check(first.call.ok && first.call.first_us == first.call.req_us, "power-on ahead of the IMU task granted at once");
+    check(!runtime.call.ok && s.devices[I2C_DEV_EXPANDER].timeouts == 1, "runtime timeout gives up (and says so)");
+    check(forever.call.ok && forever.call.first_us >= bringup_end, "wait forever lands after the bring-up");
+    check(s.queue_depth == 0, "queue empty afterwards");
+}
+
+struct Scenario {
+    const char* name;
+    void (*fn)();
+};
+
+static const Scenario scenarios[] = {
+    { "priority", priority },
+    { "backoff", backoff },
+    { "nested", nested },
+    { "boot-power", bootPower },
+};
+
+static bool runScenario(const Scenario& sc) {
+    printf("%s\n", sc.name);
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+        sc.fn();
+        fflush(stdout);
+        _exit(failures ? 1 : 0);
+    }
+    int status = 0;
+    if (pid < 0 || waitpid(pid, &status, 0) != pid) return false;
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+int main(int argc, char** argv) {
+    Serial.enabled = false;
+    printf("I2C %u Hz, timeouts IMU %u / touch %u / expander %u ms, priorities %d / %d / %d, "
+           "%u us overhead per phase\n\n", (unsigned)I2C_BUS_CLOCK_HZ, I2C_IMU_TIMEOUT_MS, I2C_TOUCH_TIMEOUT_MS,
+           I2C_EXPANDER_TIMEOUT_MS, dev_prio[0], dev_prio[1], dev_prio[2], (unsigned)model.overhead_us);
+    int failed = 0, ran = 0;
+    for (const Scenario& sc : scenarios) {
+        bool selected = argc < 2;
+        for (int i = 1; i < argc; i++) selected |= !strcmp(argv[i], sc.name);
+        if (!selected) continue;
+        ran++;
+        if (!runScenario(sc)) {
+            printf("    -> FAIL\n");
+            failed++;
+        }
+    }
+    printf("\n%d of %d scenarios passed\n%s\n", ran - failed, ran, failed ? "FAIL" : "OK");
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,207 @@
+/*
+ * File: host_env.cpp
+ * Description: Host side of the imu_replay shims: virtual clock, serial,
+ *              QMI8658 register model and recorder stubs.
+ * Author: zzackk125
+ * License: MIT
+ */
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <Preferences.h>
+#include <chrono>
+#include "imu_recorder.h"
+
+// --- Clock ---
+// 64-bit underneath so millis() keeps counting when micros() wraps (as on the device)
+static uint64_t now_us = 0;
+
+uint32_t micros() { return (uint32_t)now_us; }
+uint32_t millis() { return (uint32_t)(now_us / 1000); }
+uint64_t hostMicros64() { return now_us; }
+
+void hostSetMicros(uint32_t us) {
+    // Nearest 64-bit time with these low bits (small steps back are allowed)
+    static bool started = false;
+    if (!started) {
+        now_us = us;
+        started = true;
+        return;
+    }
+    now_us += (int32_t)(us - (uint32_t)now_us);
+}
+
+HostSerial Serial;
+std::map<std::string, std::vector<uint8_t>> Preferences::store;
+
+// --- QMI8658 register model ---
+#define REG_CTRL1          0x02
+#define REG_CTRL7          0x08
+#define REG_CTRL9          0x0A
+#define REG_FIFO_WTM_TH    0x13
+#define REG_FIFO_CTRL      0x14
+#define REG_FIFO_SMPL_CNT  0x15
+#define REG_FIFO_STATUS    0x16
+#define REG_FIFO_DATA      0x17
+#define REG_STATUSINT      0x2D
+#define REG_TIMESTAMP_L    0x30
+
+#define CMD_RST_FIFO       0x04
+#define CMD_REQ_FIFO       0x05
+
+QMI8658Model qmi_model;
+TwoWire Wire;
+
+static void put16(uint8_t* out, int16_t v) {
+    out[0] = (uint8_t)v;
+    out[1] = (uint8_t)((uint16_t)v >> 8);
+}
+
+void QMI8658Model::push(const QMIFrame& f) {
+    if (!configured) return;
+    fifo.push_back(stuck ? stuck_frame : f);
+    if (fifo.size() > 128) {
+        fifo.pop_front(); // Stream mode: oldest overwritten
+        overflow = true;
+    }
+}
+
+void QMI8658Model::powerLoss() {
+    configured = false;
+    fifo.clear();
+    fifo_stream.clear();
+    fifo_words = 0;
+    overflow = false;
+    data_ready = false;
+    counter_base = counter;
+    memset(regs, 0, sizeof(regs));
+}
+
+bool QMI8658Model::int2() const {
+    if (!configured || !(regs[REG_CTRL1] & 0x10)) return false;   // INT2_EN
+    if (regs[REG_FIFO_CTRL] & 0x03) {
+        // FIFO mode: watermark (FIFO_INT_SEL = INT2)
+        if (!(regs[REG_CTRL1] & 0x04) && regs[REG_FIFO_WTM_TH] && fifo.size() >= regs[REG_FIFO_WTM_TH]) return true;
+    }
+    return data_ready && !(regs[REG_CTRL7] & 0x20);                 // DRDY_DIS
+}
+
+void QMI8658Model::writeReg(uint8_t reg, const uint8_t* data, size_t len) {
+    if (len == 0) return;
+    for (size_t i = 0; i < len && reg + i < sizeof(regs); i++) regs[reg + i] = data[i];
+    if (reg == REG_CTRL9 && data[0] == CMD_REQ_FIFO) {
+        // Latch the queue for FIFO_DATA reads
+        fifo_stream.clear();
+        fifo_pos = 0;
+        for (const QMIFrame& f : fifo) {
+            uint8_t b[12];
+            for (int k = 0; k < 6; k++) put16(&b[2 * k], f.raw[k]);
+            fifo_stream.insert(fifo_stream.end(), b, b + 12);
+        }
+        fifo_words = (uint16_t)(fifo.size() * 6);
+    } else if (reg == REG_CTRL9 && data[0] == CMD_RST_FIFO) {
+        fifo.clear();
+        fifo_stream.clear();
+        fifo_words = 0;
+        overflow = false;
+    } else if (reg == REG_FIFO_CTRL) {
+        // Leaving read mode: frames that were read are gone
+        size_t frames = fifo_pos / 12;
+        for (size_t i = 0; i < frames && !fifo.empty(); i++) fifo.pop_front();
+        fifo_stream.clear();
+        fifo_pos = 0;
+        fifo_words = 0;
+        overflow = false;
+    }
+    // Everything else (config registers) is only stored
+}
+
+size_t QMI8658Model::readRegs(uint8_t reg, uint8_t* out, size_t len) {
+    memset(out, 0, len);
+    switch (reg) {
+        case REG_STATUSINT:
+            out[0] = 0x80; // CmdDone: commands complete instantly
+            break;
+        case REG_FIFO_STATUS:
+            out[0] = overflow ? 0x20 : 0x00;
+            break;
+        case REG_FIFO_SMPL_CNT:
+            out[0] = (uint8_t)fifo_words;
+            if (len > 1) out[1] = (uint8_t)((fifo_words >> 8) & 0x03);
+            break;
+        case REG_FIFO_DATA:
+            for (size_t i = 0; i < len && fifo_pos < fifo_stream.size(); i++) out[i] = fifo_stream[fifo_pos++];
+            break;
+        case REG_TIMESTAMP_L: {
+            if (!configured) break; // Held in reset: all zero
+            if (burst) {
+                memcpy(out, burst, len < 17 ? len : 17);
+                data_ready = false;
+                break;
+            }
+            uint8_t b[17] = {0};
+            uint32_t c = counter - counter_base;
+            b[0] = (uint8_t)c;
+            b[1] = (uint8_t)(c >> 8);
+            b[2] = (uint8_t)(c >> 16);
+            const QMIFrame& f = stuck ? stuck_frame : current;
+            for (int k = 0; k < 6; k++) put16(&b[5 + 2 * k], f.raw[k]);
+            memcpy(out, b, len < sizeof(b) ? len : sizeof(b));
+            data_ready = false;
+            break;
+        }
+        default:
+            for (size_t i = 0; i < len && reg + i < sizeof(regs); i++) out[i] = regs[reg + i];
+            break;
+    }
+    return len;
+}
+
+// --- TwoWire ---
+void TwoWire::beginTransmission(uint8_t a) {
+    addr = a;
+    tx_len = 0;
+}
+
+size_t TwoWire::write(uint8_t b) {
+    if (tx_len >= sizeof(tx)) return 0;
+    tx[tx_len++] = b;
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t* data, size_t len) {
+    size_t n = 0;
+    while (n < len && write(data[n])) n++;
+    return n;
+}
+
+uint8_t TwoWire::endTransmission(bool) {
+    if (addr != QMI8658_MODEL_ADDR || qmi_model.fails()) return 2; // NACK: nothing else on the host bus
+    if (tx_len == 0) return 0;
+    auto t0 = std::chrono::steady_clock::now();
+    reg = tx[0];
+    qmi_model.writeReg(reg, &tx[1], tx_len - 1);
+    qmi_model.bus_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count();
+    return 0;
+}
+
+size_t TwoWire::requestFrom(uint8_t a, size_t len, bool) {
+    rx_len = rx_pos = 0;
+    if (a != QMI8658_MODEL_ADDR || qmi_model.fails() || len > sizeof(rx)) return 0;
+    auto t0 = std::chrono::steady_clock::now();
+    rx_len = qmi_model.readRegs(reg, rx, len);
+    qmi_model.bus_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count();
+    return rx_len;
+}
+
+// --- Recorder: never records while replaying ---
+void initRecorder() {}
+bool startRecording() { return false; }
+void stopRecording() {}
+bool isRecording() { return false; }
+void serviceRecorder() {}
+void getRecorderStats(IMURecorderStats* out) { if (out) *out = IMURecorderStats(); }
+bool recorderNeedsState() { return false; }
+void recorderBatch(uint32_t, uint16_t, uint8_t, uint32_t) {}
+void recorderSample(const int16_t*) {}
+void recorderEvent(const ImuLogEvent*) {}
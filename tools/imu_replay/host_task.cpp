@@ -0,0 +1,285 @@
+/*
+ * File: host_task.cpp
+ * Description: Cooperative FreeRTOS scheduler on the virtual clock (ucontext)
+ * Author: zzackk125
+ * License: MIT
+ */
+
+#include "host_task.h"
+#include <ucontext.h>
+#include <vector>
+
+#define HOST_TASK_STACK  (256 * 1024)
+#define NEVER            UINT64_MAX
+
+struct HostMutex;
+
+struct HostTask {
+    ucontext_t ctx;
+    std::vector<char> stack;
+    const char* name;
+    int prio;
+    void (*fn)(void*);
+    void* arg;
+    bool blocked;
+    uint64_t wake_us;        // Blocked: timeout (NEVER = none)
+    uint64_t busy_us;        // CPU time still owed by hostTaskSleepUs()
+    uint64_t ready_seq;      // FIFO order among equal priorities
+    uint32_t notify;
+    bool notify_wait;
+    HostMutex* mutex_wait;
+};
+
+struct HostMutex {
+    HostTask* owner;
+};
+
+static std::vector<HostTask*> tasks;
+static HostTask* cur = NULL;
+static HostTask outside;     // Owner of mutexes taken outside any task
+static ucontext_t sched_ctx;
+static uint64_t ready_seq = 0;
+static HostTaskStats stats = {0};
+
+static void setNow(uint64_t us) {
+    hostSetMicros((uint32_t)us);
+}
+
+// Absolute time of the tick `ticks` after the current one
+static uint64_t tickDeadline(TickType_t ticks) {
+    if (ticks == portMAX_DELAY) return NEVER;
+    return (hostMicros64() / 1000 + ticks) * 1000;
+}
+
+static void makeReady(HostTask* t) {
+    t->blocked = false;
+    t->wake_us = NEVER;
+    t->ready_seq = ++ready_seq;
+}
+
+// Own priority, raised by anything waiting on a mutex it holds
+static int effectivePrio(const HostTask* t, int depth = 0) {
+    int p = t->prio;
+    if (depth > 8) return p;
+    for (HostTask* w : tasks) {
+        if (w->blocked && w->mutex_wait && w->mutex_wait->owner == t) {
+            int wp = effectivePrio(w, depth + 1);
+            if (wp > p) p = wp;
+        }
+    }
+    return p;
+}
+
+static HostTask* pickReady() {
+    HostTask* best = NULL;
+    int best_prio = -1;
+    for (HostTask* t : tasks) {
+        if (t->blocked) continue;
+        int p = effectivePrio(t);
+        if (!best || p > best_prio || (p == best_prio && t->ready_seq < best->ready_seq)) {
+            best = t;
+            best_prio = p;
+        }
+    }
+    return best;
+}
+
+// Back to the scheduler; returns when this task is picked again
+static void yieldTask() {
+    HostTask* self = cur;
+    swapcontext(&self->ctx, &sched_ctx);
+}
+
+static void blockUntil(uint64_t wake_us) {
+    cur->blocked = true;
+    cur->wake_us = wake_us;
+    yieldTask();
+}
+
+// After waking someone: give way if they outrank the caller (preemption)
+static void maybePreempt() {
+    if (!cur) return;
+    HostTask* next = pickReady();
+    if (next && next != cur && effectivePrio(next) > effectivePrio(cur)) yieldTask();
+}
+
+static void taskEntry() {
+    cur->fn(cur->arg);
+    // FreeRTOS tasks never return; park it for good
+    blockUntil(NEVER);
+}
+
+// --- HostKernel hooks ---
+static TaskHandle_t kCurrent() {
+    return cur ? (TaskHandle_t)cur : (TaskHandle_t)&outside;
+}
+
+static BaseType_t kCreate(void (*fn)(void*), const char* name, void* arg, int prio, TaskHandle_t* handle) {
+    HostTask* t = new HostTask();
+    t->stack.resize(HOST_TASK_STACK);
+    t->name = name;
+    t->prio = prio;
+    t->fn = fn;
+    t->arg = arg;
+    getcontext(&t->ctx);
+    t->ctx.uc_stack.ss_sp = t->stack.data();
+    t->ctx.uc_stack.ss_size = t->stack.size();
+    t->ctx.uc_link = NULL;
+    makecontext(&t->ctx, taskEntry, 0);
+    makeReady(t);
+    tasks.push_back(t);
+    if (handle) *handle = (TaskHandle_t)t;
+    maybePreempt();
+    return pdTRUE;
+}
+
+static void kDelay(TickType_t ticks) {
+    if (!cur) {
+        // Outside a task: let the tasks run for that long
+        hostTasksRunUntil(tickDeadline(ticks));
+        return;
+    }
+    blockUntil(tickDeadline(ticks));
+}
+
+static void kDelayUntil(TickType_t* last_wake, TickType_t period) {
+    *last_wake += period;
+    int32_t ahead = (int32_t)(*last_wake - millis());
+    if (ahead <= 0) {
+        // Missed it: FreeRTOS returns at once (after a yield)
+        if (cur) maybePreempt();
+        return;
+    }
+    if (!cur) {
+        hostTasksRunUntil(tickDeadline((TickType_t)ahead));
+        return;
+    }
+    blockUntil(tickDeadline((TickType_t)ahead));
+}
+
+static uint32_t kNotifyTake(BaseType_t clear, TickType_t ticks) {
+    if (!cur) return 0;
+    if (!cur->notify && ticks) {
+        cur->notify_wait = true;
+        blockUntil(tickDeadline(ticks));
+        cur->notify_wait = false;
+    }
+    uint32_t v = cur->notify;
+    if (v) cur->notify = clear ? 0 : v - 1;
+    return v;
+}
+
+static void kNotifyGive(TaskHandle_t handle) {
+    HostTask* t = (HostTask*)handle;
+    if (!t || t == &outside) return;
+    t->notify++;
+    if (t->blocked && t->notify_wait) {
+        makeReady(t);
+        maybePreempt();
+    }
+}
+
+static SemaphoreHandle_t kMutexCreate() {
+    return (SemaphoreHandle_t) new HostMutex{ NULL };
+}
+
+static BaseType_t kMutexTake(SemaphoreHandle_t handle, TickType_t ticks) {
+    HostMutex* m = (HostMutex*)handle;
+    HostTask* self = cur ? cur : &outside;
+    if (!m->owner) {
+        m->owner = self;
+        return pdTRUE;
+    }
+    if (!ticks) return pdFALSE;
+    if (!cur) {
+        fprintf(stderr, "host_task: mutex held by %s, test code would block\n", m->owner->name);
+        abort();
+    }
+    cur->mutex_wait = m;
+    blockUntil(tickDeadline(ticks));
+    cur->mutex_wait = NULL;
+    return m->owner == cur ? pdTRUE : pdFALSE;
+}
+
+static BaseType_t kMutexGive(SemaphoreHandle_t handle) {
+    HostMutex* m = (HostMutex*)handle;
+    HostTask* self = cur ? cur : &outside;
+    if (m->owner != self) return pdFALSE;
+    m->owner = NULL;
+
+    // Straight to the highest priority waiter (first come among equals)
+    HostTask* next = NULL;
+    for (HostTask* t : tasks) {
+        if (!t->blocked || t->mutex_wait != m) continue;
+        if (!next || effectivePrio(t) > effectivePrio(next)) next = t;
+    }
+    if (next) {
+        m->owner = next;
+        next->mutex_wait = NULL;
+        makeReady(next);
+        maybePreempt();
+    }
+    return pdTRUE;
+}
+
+static const HostKernel kernel = {
+    kCurrent, kCreate, kDelay, kDelayUntil, kNotifyTake, kNotifyGive, kMutexCreate, kMutexTake, kMutexGive,
+};
+
+// --- Public ---
+void hostTasksInit() {
+    outside.name = "test";
+    host_kernel = &kernel;
+}
+
+void hostTasksRunUntil(uint64_t until_us) {
+    if (cur) return; // Not re-entrant from a task
+    for (;;) {
+        uint64_t now = hostMicros64();
+        for (HostTask* t : tasks) {
+            // Timed out: the waiter clears its own wait flags
+            if (t->blocked && t->wake_us <= now) makeReady(t);
+        }
+
+        HostTask* next = pickReady();
+        if (next && next->busy_us == 0) {
+            if (now >= until_us) break;
+            stats.switches++;
+            cur = next;
+            swapcontext(&sched_ctx, &next->ctx);
+            cur = NULL;
+            continue;
+        }
+
+        // Nothing to run at this instant: advance to the next event
+        uint64_t event = until_us;
+        for (HostTask* t : tasks) {
+            if (t->blocked && t->wake_us < event) event = t->wake_us;
+        }
+        if (next && now + next->busy_us < event) event = now + next->busy_us;
+        if (event <= now) break;
+        if (next) next->busy_us -= event - now;
+        setNow(event);
+    }
+}
+
+void hostTaskSleepUs(uint32_t us) {
+    if (!cur) {
+        hostTasksRunUntil(hostMicros64() + us);
+        return;
+    }
+    cur->busy_us += us;
+    yieldTask();
+}
+
+void hostTaskWaitUs(uint32_t us) {
+    if (!cur) {
+        hostTasksRunUntil(hostMicros64() + us);
+        return;
+    }
+    blockUntil(hostMicros64() + us);
+}
+
+void getHostTaskStats(HostTaskStats* out) {
+    if (out) *out = stats;
+}
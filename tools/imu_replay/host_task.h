@@ -0,0 +1,36 @@
+/*
+ * File: host_task.h
+ * Description: Cooperative FreeRTOS scheduler on the virtual clock, for host
+ *              tests that run the firmware's real tasks (see shim/freertos)
+ * Author: zzackk125
+ * License: MIT
+ *
+ * Tasks are coroutines. The highest priority ready task runs until it blocks
+ * (delay, notify, mutex, queue) or yields CPU time with hostTaskSleepUs();
+ * virtual time only moves while every task is blocked or busy, so a higher
+ * priority wakeup preempts busy work at the right microsecond. Ticks fall on
+ * millis() edges as on the device. Mutexes hand over to their highest
+ * priority waiter and lend it their owner's priority (inheritance).
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+// Installs host_kernel. Code outside a task (the test) keeps running on the
+// caller's stack; tasks only run inside hostTasksRunUntil().
+void hostTasksInit();
+
+// Runs tasks until the virtual clock reaches until_us (hostMicros64() time)
+void hostTasksRunUntil(uint64_t until_us);
+
+// From a task: use the CPU for us microseconds (preemptible busy work)
+void hostTaskSleepUs(uint32_t us);
+
+// From a task: block for us microseconds (hardware / interrupt models)
+void hostTaskWaitUs(uint32_t us);
+
+struct HostTaskStats {
+    uint32_t switches;       // Context switches into tasks
+};
+void getHostTaskStats(HostTaskStats* out);
@@ -0,0 +1,639 @@
+/*
+ * File: imu_test.cpp
+ * Description: Host unit tests of the IMU driver against the QMI8658
+ *              register model (same shims as the replay).
+ * Author: zzackk125
+ * License: MIT
+ *
+ *   imu_test [--verbose] [case...]
+ *
+ * Each case runs in its own process (the driver's state is static), on the
+ * virtual clock, and drives the sensor model sample by sample. The exit
+ * status is non-zero if any check fails.
+ */
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <chrono>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "board_config.h"
+#include "imu_driver.h"
+#include "i2c_bus.h"
+#include "persist.h"
+#include "host_task.h"
+
+// Driver globals (imu_driver.cpp)
+extern float currentRoll, currentPitch;
+extern float gyroX_offset, gyroY_offset, gyroZ_offset;
+
+typedef std::chrono::steady_clock Clock;
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    if (!ok) {
+        printf("    FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+// --- Sensor ---
+#define QMI_COUNTER_WRAP 0x1000000
+
+static uint64_t t0_us;          // Virtual clock at the start of the case
+static uint64_t sample_us;      // Production time of the next sample, relative to t0_us
+static uint32_t produced = 0;
+
+static void setClock(uint64_t rel_us) {
+    hostSetMicros((uint32_t)(t0_us + rel_us));
+}
+
+#if IMU_USE_FIFO
+// Level and still, with an LSB or two of noise (the stuck detector needs it)
+static uint32_t rng = 1;
+
+static QMIFrame stillFrame() {
+    rng = rng * 1664525u + 1013904223u;
+    uint32_t r = rng >> 8;
+    QMIFrame f;
+    f.raw[0] = (int16_t)((r & 3) - 1);
+    f.raw[1] = (int16_t)(((r >> 2) & 3) - 1);
+    f.raw[2] = (int16_t)(8192 + ((r >> 4) & 3) - 1);
+    f.raw[3] = (int16_t)(100 + ((r >> 6) & 7) - 3);   // ~0.2 dps bias
+    f.raw[4] = (int16_t)(-50 + ((r >> 9) & 7) - 3);
+    f.raw[5] = (int16_t)(25 + ((r >> 12) & 7) - 3);
+    return f;
+}
+
+// One sample from the sensor: into the FIFO and onto the counter
+static void produce() {
+    qmi_model.push(stillFrame());
+    qmi_model.counter = (qmi_model.counter + 1) & (QMI_COUNTER_WRAP - 1);
+    sample_us += IMU_SAMPLE_PERIOD_US;
+    produced++;
+}
+
+// Every sample due by rel_us, then the clock
+static void runTo(uint64_t rel_us) {
+    while (sample_us <= rel_us) produce();
+    setClock(rel_us);
+}
+#endif
+
+// micros() and the sensor counter both wrap a couple of seconds in.
+// init = false leaves initIMU() to the caller (the IMU task runs it itself).
+static void bringUp(uint32_t counter0, bool init = true) {
+    t0_us = 0x100000000ULL - 2000000;
+    sample_us = 0;
+    produced = 0;
+    hostSetMicros((uint32_t)t0_us);
+    qmi_model.counter = counter0;
+    i2cBusInit();
+    initPersist();
+    if (init) initIMU();
+}
+
+// --- Cases ---
+#if IMU_USE_FIFO
+// Drained every IMU_TASK_PERIOD_MS across both wraps: every sample fused once
+static void fifoWrap() {
+    bringUp(QMI_COUNTER_WRAP - 500);
+    uint64_t period = IMU_TASK_PERIOD_MS * 1000;
+    for (uint64_t t = period; t <= 4000000; t += period) {
+        runTo(t);
+        updateIMU();
+    }
+    IMUFifoStats fs;
+    IMUTimeStats ts;
+    getIMUFifoStats(&fs);
+    getIMUTimeStats(&ts);
+    printf("    %u samples in %u batches, %u fused, %u dropped, %u resyncs\n", (unsigned)produced,
+           (unsigned)fs.batches, (unsigned)fs.samples, (unsigned)ts.dropped_samples, (unsigned)ts.resyncs);
+    check(fs.samples == produced, "every sample fused");
+    check(ts.dropped_samples == 0 && ts.gaps == 0, "nothing counted as dropped");
+    check(ts.resyncs == 0, "counter wrap is not a resync");
+    check(ts.sensor_time_us == (uint64_t)produced * IMU_SAMPLE_PERIOD_US, "sensor time = samples x period");
+}
+
+// A sample lands between the FIFO latch and the counter read: counted now,
+// drained next time. The backlog of one must not read as a gap.
+static void fifoBacklog() {
+    bringUp(QMI_COUNTER_WRAP - 500);
+    uint64_t period = IMU_TASK_PERIOD_MS * 1000;
+    int late = 0;
+    for (uint64_t t = period; t <= 3000000; t += period) {
+        runTo(t);
+        bool racing = (t / period) % 7 == 0 && sample_us - t < IMU_SAMPLE_PERIOD_US;
+        if (racing) {
+            // Counter already ticked, frame reaches the FIFO after the drain
+            qmi_model.counter = (qmi_model.counter + 1) & (QMI_COUNTER_WRAP - 1);
+            updateIMU();
+            qmi_model.push(stillFrame());
+            sample_us += IMU_SAMPLE_PERIOD_US;
+            produced++;
+            late++;
+        } else {
+            updateIMU();
+        }
+    }
+    runTo(3000000 + period);
+    updateIMU();
+    IMUFifoStats fs;
+    IMUTimeStats ts;
+    getIMUFifoStats(&fs);
+    getIMUTimeStats(&ts);
+    printf("    %u samples, %d drained a batch late, %u fused, %u dropped\n", (unsigned)produced, late,
+           (unsigned)fs.samples, (unsigned)ts.dropped_samples);
+    check(late > 0, "backlog exercised");
+    check(fs.samples == produced, "every sample fused");
+    check(ts.dropped_samples == 0, "backlog of one is not a gap");
+}
+
+// The drain stalls: 100ms fits the 128-deep FIFO, 250ms overflows it and
+// exactly the overwritten samples are counted.
+static void fifoStall() {
+    bringUp(QMI_COUNTER_WRAP - 200);
+    uint64_t period = IMU_TASK_PERIOD_MS * 1000;
+    uint64_t t = 0;
+    for (int i = 0; i < 50; i++) {
+        runTo(t += period);
+        updateIMU();
+    }
+
+    runTo(t += 100000);
+    updateIMU();
+    IMUTimeStats ts;
+    getIMUTimeStats(&ts);
+    check(ts.dropped_samples == 0, "100ms stall: nothing lost");
+
+    uint32_t before = produced;
+    runTo(t += 250000);
+    uint32_t backlog = produced - before;
+    updateIMU();
+    for (int i = 0; i < 50; i++) {
+        runTo(t += period);
+        updateIMU();
+    }
+
+    IMUFifoStats fs;
+    getIMUFifoStats(&fs);
+    getIMUTimeStats(&ts);
+    uint32_t lost = backlog - IMU_FIFO_MAX_SAMPLES;
+    printf("    250ms stall: %u samples queued, %u lost, %u counted dropped in %u gap(s), %u overflows\n",
+           (unsigned)backlog, (unsigned)lost, (unsigned)ts.dropped_samples, (unsigned)ts.gaps,
+           (unsigned)fs.overflows);
+    check(ts.dropped_samples == lost && ts.gaps == 1, "overwritten samples counted exactly");
+    check(fs.samples + lost == produced, "everything else fused");
+    check(fs.overflows == 1, "overflow flag seen");
+    check(ts.sensor_time_us == (uint64_t)produced * IMU_SAMPLE_PERIOD_US, "sensor time covers the gap");
+}
+
+// Host cost of one drain (bus model + decode + fusion) by batch size
+static void fifoCost() {
+    bringUp(0);
+    runTo(100000);
+    updateIMU(); // Seed and first batch
+
+    static const int sizes[] = { 1, IMU_FIFO_WATERMARK, 32, IMU_FIFO_MAX_SAMPLES };
+    printf("    %8s %12s %12s\n", "samples", "ns/batch", "ns/sample");
+    for (int n : sizes) {
+        const int reps = 2000;
+        uint64_t ns = 0;
+        for (int r = 0; r < reps; r++) {
+            for (int i = 0; i < n; i++) produce();
+            setClock(sample_us);
+            Clock::time_point c0 = Clock::now();
+            updateIMU();
+            ns += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - c0).count();
+        }
+        printf("    %8d %12.0f %12.1f\n", n, (double)ns / reps, (double)ns / reps / n);
+    }
+    IMUTimeStats ts;
+    getIMUTimeStats(&ts);
+    check(ts.dropped_samples == 0, "nothing dropped");
+}
+
+// --- Task jitter (host_task scheduler on the virtual clock) ---
+// The same single-core load for both loop shapes, with tools/sched_sim's
+// figures: interrupts of 5-30us about every ms plus a 100-600us WiFi burst on
+// 5% of them, LVGL rendering 2-10ms every 33ms under the LVGL lock, updateUI
+// 300-800us and the web server 150us with a 15-30ms request about once a second.
+#define JITTER_RUN_US   10000000
+#define LOAD_PRIORITY   23          // WiFi / interrupt level
+#define SENSOR_PRIORITY 24
+
+static uint32_t load_rng = 7;
+static std::vector<uint32_t> stamps;    // Start of each IMU update (micros())
+
+static uint32_t loadRand(uint32_t lo, uint32_t hi) {
+    load_rng = load_rng * 1103515245u + 12345u;
+    return lo + (load_rng >> 8) % (hi - lo + 1);
+}
+
+static void irqLoadTask(void*) {
+    for (;;) {
+        hostTaskWaitUs(loadRand(500, 1500));
+        hostTaskSleepUs(loadRand(5, 30));
+        if (loadRand(0, 99) < 5) hostTaskSleepUs(loadRand(100, 600));
+    }
+}
+
+// Sees every snapshot the IMU task publishes (they land at its wakeups)
+static void publishWatchTask(void*) {
+    uint32_t last = 0;
+    for (;;) {
+        IMUAttitude att;
+        if (readIMUAttitude(&att) && att.publish_us != last) {
+            last = att.publish_us;
+            stamps.push_back(last);
+        }
+        hostTaskWaitUs(50);
+    }
+}
+
+#if IMU_INT_PIN < 0
+// Loop shapes and their load (timed-wakeup build only)
+static SemaphoreHandle_t lvgl_lock = NULL;
+
+// QMI8658 at its ODR, whoever is running
+static void sensorTask(void*) {
+    for (;;) {
+        uint64_t due = t0_us + sample_us;
+        uint64_t now = hostMicros64();
+        if (due > now) hostTaskWaitUs((uint32_t)(due - now));
+        produce();
+    }
+}
+
+static void lvglTask(void*) {
+    uint64_t frame = hostMicros64();
+    for (;;) {
+        frame += 33000;
+        hostTaskWaitUs((uint32_t)(frame - hostMicros64()));
+        xSemaphoreTake(lvgl_lock, portMAX_DELAY);
+        hostTaskSleepUs(loadRand(2000, 10000));
+        xSemaphoreGive(lvgl_lock);
+    }
+}
+
+// UI and web work of the Arduino loop
+static void loopWork() {
+    xSemaphoreTake(lvgl_lock, portMAX_DELAY);
+    hostTaskSleepUs(loadRand(300, 800));
+    xSemaphoreGive(lvgl_lock);
+    static uint64_t next_request = 0;
+    if (hostMicros64() >= next_request) {
+        if (next_request) hostTaskSleepUs(loadRand(15000, 30000));
+        next_request = hostMicros64() + loadRand(800000, 1200000);
+    } else {
+        hostTaskSleepUs(150);
+    }
+}
+
+// Before the IMU task: updateIMU() from the loop, then UI and web, delay(20)
+static void oldLoopTask(void*) {
+    for (;;) {
+        stamps.push_back(micros());
+        updateIMU();
+        loopWork();
+        delay(20);
+    }
+}
+
+static void loopTask(void*) {
+    for (;;) {
+        IMUAttitude att;
+        readIMUAttitude(&att);
+        loopWork();
+        delay(20);
+    }
+}
+
+static void startLoad() {
+    hostTasksInit();
+    bringUp(0, false);
+    lvgl_lock = xSemaphoreCreateMutex();
+    xTaskCreate(sensorTask, "QMI8658", 0, NULL, SENSOR_PRIORITY, NULL);
+    xTaskCreate(irqLoadTask, "IRQ/WiFi", 0, NULL, LOAD_PRIORITY, NULL);
+    xTaskCreate(lvglTask, "LVGL", 0, NULL, LVGL_TASK_PRIORITY, NULL);
+}
+
+struct Jitter {
+    uint32_t updates;
+    uint32_t mean_us;       // Mean interval between updates
+    uint32_t avg_us;        // |interval - nominal|
+    uint32_t max_us;
+    uint32_t dropped;
+    uint32_t task_max_us;   // IMU task's own jitter stat (after only)
+};
+
+// Over the steady state (nominal 0 = the mean interval)
+static Jitter intervalJitter(uint32_t nominal_us) {
+    Jitter j = {0};
+    if (stamps.size() < 10) return j;
+    size_t first = stamps.size() / 10; // Skip bring-up
+    size_t n = stamps.size() - first - 1;
+    j.updates = (uint32_t)stamps.size();
+    j.mean_us = (stamps.back() - stamps[first]) / n;
+    if (!nominal_us) nominal_us = j.mean_us;
+    uint64_t dev_sum = 0;
+    for (size_t i = first + 1; i < stamps.size(); i++) {
+        uint32_t d = stamps[i] - stamps[i - 1];
+        uint32_t dev = d > nominal_us ? d - nominal_us : nominal_us - d;
+        dev_sum += dev;
+        if (dev > j.max_us) j.max_us = dev;
+    }
+    j.avg_us = (uint32_t)(dev_sum / n);
+    IMUTimeStats ts;
+    getIMUTimeStats(&ts);
+    j.dropped = ts.dropped_samples;
+    return j;
+}
+
+static Jitter loopShape() {
+    startLoad();
+    initIMU();
+    xTaskCreate(oldLoopTask, "loopTask", 0, NULL, 1, NULL);
+    hostTasksRunUntil(t0_us + JITTER_RUN_US);
+    return intervalJitter(0);
+}
+
+static Jitter taskShape() {
+    startLoad();
+    startIMUTask();
+    xTaskCreate(loopTask, "loopTask", 0, NULL, 1, NULL);
+    xTaskCreate(publishWatchTask, "watch", 0, NULL, SENSOR_PRIORITY + 1, NULL);
+    hostTasksRunUntil(t0_us + JITTER_RUN_US);
+    Jitter j = intervalJitter(IMU_TASK_PERIOD_MS * 1000);
+    IMUTaskStats st;
+    getIMUTaskStats(&st);
+    j.task_max_us = st.jitter_max_us;
+    return j;
+}
+
+// Each shape gets a fresh driver: run it in a child, result back over a pipe
+static Jitter measure(Jitter (*shape)()) {
+    Jitter j = {0};
+    int fd[2];
+    if (pipe(fd)) return j;
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fd[0]);
+        j = shape();
+        if (write(fd[1], &j, sizeof(j)) != sizeof(j)) _exit(1);
+        _exit(0);
+    }
+    close(fd[1]);
+    if (read(fd[0], &j, sizeof(j)) != sizeof(j)) memset(&j, 0, sizeof(j));
+    close(fd[0]);
+    waitpid(pid, NULL, 0);
+    return j;
+}
+
+// Before/after for the IMU task: update intervals under the same load
+// (timed wakeups; the interrupt build is covered by irq-wake)
+static void taskJitter() {
+    Jitter before = measure(loopShape);
+    Jitter after = measure(taskShape);
+    printf("    %-28s %8s %10s %10s %10s %8s\n", "", "updates", "interval", "jitter avg", "jitter max", "dropped");
+    printf("    %-28s %8u %7u us %7u us %7u us %8u\n", "updateIMU() in loop (before)", (unsigned)before.updates,
+           (unsigned)before.mean_us, (unsigned)before.avg_us, (unsigned)before.max_us, (unsigned)before.dropped);
+    printf("    %-28s %8u %7u us %7u us %7u us %8u\n", "IMU task (after)", (unsigned)after.updates,
+           (unsigned)after.mean_us, (unsigned)after.avg_us, (unsigned)after.max_us, (unsigned)after.dropped);
+    check(before.updates > 0 && after.updates > 0, "both shapes ran");
+    check(after.mean_us + 50 > IMU_TASK_PERIOD_MS * 1000 && after.mean_us < IMU_TASK_PERIOD_MS * 1000 + 50,
+          "IMU task runs at its period");
+    printf("    IMU task's own stat: jitter max %u us\n", (unsigned)after.task_max_us);
+    check(after.max_us < 1000, "IMU task wakes within 1ms (only interrupts / WiFi in the way)");
+    check(after.task_max_us < 1000, "task stat agrees");
+    check(after.max_us * 10 < before.max_us, "max jitter down by 10x or more");
+    check(before.dropped == 0 && after.dropped == 0, "FIFO rode out the stalls");
+}
+#endif
+
+#if IMU_INT_PIN >= 0
+// --- Interrupt wake path (IMU_INT_PIN variant) ---
+static std::vector<uint32_t> isr_stamps;    // micros() of each ISR call
+static bool int_line_cut = false;           // INT2 wire "disconnected"
+
+// The sensor model again, now driving its INT2 pin into the attached ISR
+static void intSensorTask(void*) {
+    bool level = false;
+    for (;;) {
+        uint64_t due = t0_us + sample_us;
+        uint64_t now = hostMicros64();
+        if (due > now) hostTaskWaitUs((uint32_t)(due - now));
+        produce();
+        bool was = level;
+        level = qmi_model.int2() && !int_line_cut;
+        if (level && !was && host_isr[IMU_INT_PIN]) {
+            isr_stamps.push_back(micros());
+            host_isr[IMU_INT_PIN]();
+        }
+    }
+}
+
+// Watermark interrupt -> vTaskNotifyGiveFromISR -> IMU task drains; and the
+// IMU_INT_TIMEOUT_MS fallback while the line is cut
+static void irqWake() {
+    hostTasksInit();
+    bringUp(0, false);
+    xTaskCreate(intSensorTask, "QMI8658", 0, NULL, SENSOR_PRIORITY, NULL);
+    xTaskCreate(irqLoadTask, "IRQ/WiFi", 0, NULL, LOAD_PRIORITY, NULL);
+    startIMUTask();
+    check(host_isr[IMU_INT_PIN] != NULL, "ISR attached to IMU_INT_PIN");
+    xTaskCreate(publishWatchTask, "watch", 0, NULL, SENSOR_PRIORITY + 1, NULL);
+
+    hostTasksRunUntil(t0_us + 3000000);
+    check((qmi_model.regs[0x02] & 0x10) && (qmi_model.regs[0x08] & 0x20), "INT2 enabled, data-ready kept off it");
+    IMUTaskStats st;
+    IMUFifoStats fs;
+    getIMUTaskStats(&st);
+    getIMUFifoStats(&fs);
+
+    // Each publish after the first interrupt follows one: ISR-to-publish latency
+    uint32_t lat_max = 0;
+    uint64_t lat_sum = 0;
+    size_t n = 0, k = 0;
+    for (uint32_t p : stamps) {
+        if (isr_stamps.empty() || (int32_t)(p - isr_stamps[0]) < 0) continue;
+        while (k + 1 < isr_stamps.size() && (int32_t)(p - isr_stamps[k + 1]) >= 0) k++;
+        uint32_t lat = p - isr_stamps[k];
+        lat_sum += lat;
+        if (lat > lat_max) lat_max = lat;
+        n++;
+    }
+    printf("    %u interrupts, %u irq wakeups, %u timeouts, %.1f samples per batch\n", (unsigned)isr_stamps.size(),
+           (unsigned)st.irq_wakeups, (unsigned)st.timeout_wakeups, fs.batches ? (double)fs.samples / fs.batches : 0.0);
+    printf("    ISR to publish: avg %u us, max %u us over %u wakeups\n", n ? (unsigned)(lat_sum / n) : 0,
+           (unsigned)lat_max, (unsigned)n);
+    check(isr_stamps.size() > 2500000 / (IMU_FIFO_WATERMARK * IMU_SAMPLE_PERIOD_US), "watermark interrupts fired");
+    check(st.irq_wakeups + 1 >= isr_stamps.size(), "every interrupt woke the task");
+    check(st.timeout_wakeups <= 1, "no timeout wakeups while the line works");
+    check(lat_max < 1000, "woken within 1ms of the interrupt");
+    check(fs.samples + IMU_FIFO_WATERMARK >= produced, "every sample fused");
+
+    // Cut the line for 500ms: the timeout keeps the FIFO drained
+    uint32_t timeouts = st.timeout_wakeups;
+    int_line_cut = true;
+    hostTasksRunUntil(t0_us + 3500000);
+    int_line_cut = false;
+    hostTasksRunUntil(t0_us + 4000000);
+    IMUTimeStats ts;
+    getIMUTaskStats(&st);
+    getIMUFifoStats(&fs);
+    getIMUTimeStats(&ts);
+    printf("    line cut 500ms: %u timeout wakeups, %u dropped\n", (unsigned)(st.timeout_wakeups - timeouts),
+           (unsigned)ts.dropped_samples);
+    check(st.timeout_wakeups - timeouts >= 500 / IMU_INT_TIMEOUT_MS - 1, "timeout fallback ran");
+    check(ts.dropped_samples == 0, "nothing dropped");
+    check(fs.samples + IMU_FIFO_WATERMARK >= produced, "every sample fused");
+}
+#endif
+#endif // IMU_USE_FIFO
+
+#if !IMU_USE_FIFO
+// --- Burst read (polling build) ---
+// 0x30..0x40 as read off a board resting ~30 deg in roll: TS[3] TEMP[2] AX AY
+// AZ GX GY GZ, little endian. The four reads are served in turn with the
+// counter bytes rewritten per sample.
+static const uint8_t burst_dump[4][17] = {
+    { 0xF0, 0xFF, 0xFF, 0x80, 0x1A, 0x9C, 0xFF, 0x01, 0x10, 0xB5, 0x1B, 0x23, 0x01, 0xDD, 0xFE, 0x40, 0x00 },
+    { 0xF1, 0xFF, 0xFF, 0x80, 0x1A, 0x9B, 0xFF, 0x00, 0x10, 0xB6, 0x1B, 0x24, 0x01, 0xDC, 0xFE, 0x41, 0x00 },
+    { 0xF2, 0xFF, 0xFF, 0x81, 0x1A, 0x9D, 0xFF, 0x01, 0x10, 0xB4, 0x1B, 0x22, 0x01, 0xDE, 0xFE, 0x3F, 0x00 },
+    { 0xF3, 0xFF, 0xFF, 0x81, 0x1A, 0x9C, 0xFF, 0x02, 0x10, 0xB5, 0x1B, 0x23, 0x01, 0xDD, 0xFE, 0x40, 0x00 },
+};
+// Decoded: AX -100, AY 4097, AZ 7093 (roll 30.01, pitch 0.70 deg);
+// GX 291, GY -291, GZ 64 counts (0.568, -0.568, 0.125 dps)
+#define BURST_SKIP_AT 600   // Sample the driver misses (counter jumps by 3)
+
+// One transaction per sample, decoded in the right byte order and sign, with
+// the counter wrapping through 0xFFFFFF and a 2-sample gap
+static void burstRead() {
+    bringUp(0xFFFFF0);
+    uint8_t b[17];
+    uint32_t counter = 0xFFFFF0;
+    IMUBusStats bus0;
+    getIMUBusStats(&bus0);
+    const uint32_t n = 4800;
+    for (uint32_t k = 0; k < n; k++) {
+        if (k == BURST_SKIP_AT) counter += 2;
+        memcpy(b, burst_dump[k % 4], sizeof(b));
+        b[0] = (uint8_t)counter;
+        b[1] = (uint8_t)(counter >> 8);
+        b[2] = (uint8_t)(counter >> 16);
+        counter = (counter + 1) & (QMI_COUNTER_WRAP - 1);
+        qmi_model.burst = b;
+        qmi_model.data_ready = true;
+        setClock((uint64_t)(k + 1) * IMU_SAMPLE_PERIOD_US);
+        updateIMU();
+    }
+    qmi_model.burst = NULL;
+
+    IMUBusStats bus;
+    IMUTimeStats ts;
+    getIMUBusStats(&bus);
+    getIMUTimeStats(&ts);
+    uint32_t txn = bus.transactions - bus0.transactions, bytes = bus.bytes - bus0.bytes;
+    printf("    %u reads: %u transactions, %u bytes; roll %.3f pitch %.3f; bias %.3f %.3f %.3f dps\n", (unsigned)n,
+           (unsigned)txn, (unsigned)bytes, currentRoll, currentPitch, gyroX_offset, gyroY_offset, gyroZ_offset);
+    printf("    %u dropped in %u gap(s), %u resyncs, sensor time %.4f s\n", (unsigned)ts.dropped_samples,
+           (unsigned)ts.gaps, (unsigned)ts.resyncs, ts.sensor_time_us / 1e6);
+    check(txn == n && bytes == n * 18, "one 17-byte burst (plus address) per sample");
+    check(fabsf(currentRoll - 30.01f) < 0.05f && fabsf(currentPitch - 0.70f) < 0.05f, "accel decoded (roll, pitch)");
+    check(fabsf(gyroX_offset - 291 / 512.0f) < 0.005f && fabsf(gyroY_offset + 291 / 512.0f) < 0.005f &&
+              fabsf(gyroZ_offset - 64 / 512.0f) < 0.005f,
+          "gyro decoded (bias estimate)");
+    check(ts.dropped_samples == 2 && ts.gaps == 1 && ts.resyncs == 0, "counter: gap counted, wrap is not a resync");
+    check(ts.sensor_time_us == (uint64_t)(n + 2) * IMU_SAMPLE_PERIOD_US, "sensor time from the counter");
+}
+#endif
+
+// startIMUTask() loads the stored settings before it returns: setup() builds
+// the UI and web server from them while the task is still bringing up the sensor
+static void settingsFirst() {
+    hostTasksInit();
+    bringUp(0, false);
+    persistPutInt(PERSIST_IMU, "smooth", 40);
+    persistPutInt(PERSIST_IMU, "mode", 1);
+    persistSync(100);
+    I2CBusStats bus0, bus1, bus2;
+    getI2CBusStats(&bus0);
+    startIMUTask();
+    int smooth = getSmoothing(), mode = getCalculationMode();
+    getI2CBusStats(&bus1);
+    hostTasksRunUntil(hostMicros64() + 100000);
+    getI2CBusStats(&bus2);
+    uint32_t imu0 = bus0.devices[I2C_DEV_IMU].transactions, imu1 = bus1.devices[I2C_DEV_IMU].transactions,
+             imu2 = bus2.devices[I2C_DEV_IMU].transactions;
+    printf("    after startIMUTask(): smoothing %d%%, mode %d, %u IMU bus transactions; 100ms later %u\n", smooth,
+           mode, (unsigned)(imu1 - imu0), (unsigned)(imu2 - imu0));
+    check(smooth == 40 && mode == 1, "settings loaded before the task runs");
+    check(imu1 == imu0, "no sensor traffic in setup()");
+    check(imu2 > imu1, "task brought up the sensor");
+    check(getSmoothing() == 40 && getCalculationMode() == 1, "task kept the loaded settings");
+}
+
+struct TestCase {
+    const char* name;
+    void (*fn)();
+};
+
+static const TestCase cases[] = {
+    { "settings-first", settingsFirst },
+#if IMU_USE_FIFO
+    { "fifo-wrap", fifoWrap },
+    { "fifo-backlog", fifoBacklog },
+    { "fifo-stall", fifoStall },
+    { "fifo-cost", fifoCost },
+#if IMU_INT_PIN >= 0
+    { "irq-wake", irqWake },
+#else
+    { "task-jitter", taskJitter },
+#endif
+#else
+    { "burst-read", burstRead },
+#endif
+};
+
+// Fresh driver state per case: run it in a child process
+static bool runCase(const TestCase& tc) {
+    printf("%s\n", tc.name);
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+        tc.fn();
+        fflush(stdout);
+        _exit(failures ? 1 : 0);
+    }
+    int status = 0;
+    if (pid < 0 || waitpid(pid, &status, 0) != pid) return false;
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+int main(int argc, char** argv) {
+    Serial.enabled = false;
+    std::vector<const char*> only;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--verbose")) Serial.enabled = true;
+        else only.push_back(argv[i]);
+    }
+
+    printf("FIFO=%d FIXED=%d INT_PIN=%d, sample period %u us, task period %u ms\n\n", IMU_USE_FIFO,
+           IMU_USE_FIXED_POINT, IMU_INT_PIN, IMU_SAMPLE_PERIOD_US, IMU_TASK_PERIOD_MS);
+    int failed = 0, ran = 0;
+    for (const TestCase& tc : cases) {
+        bool selected = only.empty();
+        for (const char* name : only) selected |= !strcmp(name, tc.name);
+        if (!selected) continue;
+        ran++;
+        if (!runCase(tc)) {
+            printf("    -> FAIL\n");
+            failed++;
+        }
+    }
+    printf("\n%d of %d cases passed\n%s\n", ran - failed, ran, failed ? "FAIL" : "OK");
+    return failed ? 1 : 0;
+}
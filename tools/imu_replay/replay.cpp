@@ -0,0 +1,991 @@
+/*
+ * File: replay.cpp
+ * Description: Deterministic host replay of /imu.bin recordings through the
+ *              unmodified imu_driver.cpp (shims + QMI8658 register model).
+ * Author: zzackk125
+ * License: MIT
+ *
+ *   imu_replay [--cold] [--quiet] [--csv trace.csv] [--fault kind@s[+s]]... [--power [s,s,s]] imu.bin
+ *   imu_replay --synth out.bin [seconds] [jitter_us]
+ *   imu_replay --check [scenario...]
+ *
+ * Same log + same build = bit identical output on every run: the clock is
+ * virtual and the driver sees the recorded samples at the recorded times.
+ */
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <Preferences.h>
+#include <chrono>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "board_config.h"
+#include "imu_driver.h"
+#include "i2c_bus.h"
+#include "imu_log.h"
+#include "persist.h"
+#include "power_policy.h"
+
+// Driver globals (imu_driver.cpp)
+extern float currentRoll, currentPitch;
+extern float offsetRoll, offsetPitch;
+extern float gyroX_offset, gyroY_offset, gyroZ_offset;
+
+typedef std::chrono::steady_clock Clock;
+
+static uint64_t elapsedNs(Clock::time_point t0) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t0).count();
+}
+
+struct StageTime {
+    uint64_t total_ns = 0;
+    uint64_t max_ns = 0;
+    uint64_t calls = 0;
+
+    void add(uint64_t ns) {
+        total_ns += ns;
+        if (ns > max_ns) max_ns = ns;
+        calls++;
+    }
+    void print(const char* name, uint64_t samples) const {
+        printf("  %-8s %10.1f ns/sample  max %8.1f us/call  (%llu calls)\n", name,
+               samples ? (double)total_ns / samples : 0.0, max_ns / 1000.0, (unsigned long long)calls);
+    }
+};
+
+static bool readFile(const char* path, std::vector<uint8_t>* out) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+    uint8_t buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) out->insert(out->end(), buf, buf + n);
+    fclose(f);
+    return true;
+}
+
+static bool writeFile(const char* path, const std::vector<uint8_t>& data) {
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+    bool ok = fwrite(data.data(), 1, data.size(), f) == data.size();
+    return fclose(f) == 0 && ok;
+}
+
+static uint8_t buildFlags() {
+    return (IMU_USE_FIFO ? IMU_LOG_FLAG_FIFO : 0) | (IMU_USE_FIXED_POINT ? IMU_LOG_FLAG_FIXED_POINT : 0);
+}
+
+// --- Synthetic logs ---
+// A profile gives the vehicle motion and the gyro bias at each instant; the
+// sensor samples (with noise) and the per-sample truth follow from it.
+#define QMI_COUNTER_WRAP   0x1000000  // 24-bit sample counter
+
+struct SynthInput {
+    float roll_rate, pitch_rate, yaw_rate;  // dps
+    float lateral_g, vertical_g;
+    float bias[3];                          // Gyro bias, dps
+};
+
+typedef void (*SynthProfile)(float t, float seconds, SynthInput* in);
+
+// What the driver should report after sample k
+struct SynthTruth {
+    float roll, pitch;
+    float bias[3];
+};
+
+static uint32_t lcg(uint32_t* state) {
+    *state = *state * 1664525u + 1013904223u;
+    return *state >> 8;
+}
+
+static float noise(uint32_t* state, float amplitude) {
+    return amplitude * ((lcg(state) & 0xFFFF) / 32768.0f - 1.0f);
+}
+
+static int16_t clampCounts(float v) {
+    if (v > 32767.0f) return 32767;
+    if (v < -32768.0f) return -32768;
+    return (int16_t)lrintf(v);
+}
+
+static std::vector<QMIFrame> synthFrames(uint32_t total, SynthProfile profile, std::vector<SynthTruth>* truth) {
+    const float acc_lsb = 8192.0f, gyr_lsb = 512.0f;
+    const float dt = IMU_SAMPLE_PERIOD_US / 1000000.0f;
+    const float seconds = total * dt;
+    uint32_t rng = 12345;
+    float roll = 2.0f, pitch = -1.0f;
+
+    std::vector<QMIFrame> out(total);
+    truth->resize(total);
+    for (uint32_t k = 0; k < total; k++) {
+        SynthInput in = {};
+        profile(k * dt, seconds, &in);
+        roll += in.roll_rate * dt;
+        pitch += in.pitch_rate * dt;
+
+        float rr = roll * (float)M_PI / 180.0f, pr = pitch * (float)M_PI / 180.0f;
+        float g = 1.0f + in.vertical_g;
+        int16_t* raw = out[k].raw;
+        raw[0] = clampCounts((-sinf(pr) * g + noise(&rng, 0.01f)) * acc_lsb);
+        raw[1] = clampCounts((sinf(rr) * cosf(pr) * g + in.lateral_g + noise(&rng, 0.01f)) * acc_lsb);
+        raw[2] = clampCounts((cosf(rr) * cosf(pr) * g + noise(&rng, 0.01f)) * acc_lsb);
+        raw[3] = clampCounts((in.roll_rate + in.bias[0] + noise(&rng, 0.05f)) * gyr_lsb);
+        raw[4] = clampCounts((in.pitch_rate + in.bias[1] + noise(&rng, 0.05f)) * gyr_lsb);
+        raw[5] = clampCounts((in.yaw_rate + in.bias[2] + noise(&rng, 0.05f)) * gyr_lsb);
+
+        SynthTruth& tr = (*truth)[k];
+        tr.roll = roll;
+        tr.pitch = pitch;
+        memcpy(tr.bias, in.bias, sizeof(tr.bias));
+    }
+    return out;
+}
+
+// Still, roll ramp, cornering, bumps
+static void driveProfile(float t, float seconds, SynthInput* in) {
+    static const float bias[3] = { 0.35f, -0.20f, 0.12f };
+    float phase = t / seconds;
+    if (phase >= 0.25f && phase < 0.45f) {
+        in->roll_rate = 12.0f / (0.2f * seconds);            // Ramp to +12 deg roll
+        in->pitch_rate = 4.0f / (0.2f * seconds);
+    } else if (phase >= 0.45f && phase < 0.7f) {
+        in->yaw_rate = 45.0f;                                  // Steady corner
+        in->lateral_g = 0.35f;
+    } else if (phase >= 0.7f) {
+        in->vertical_g = (fmodf(t, 0.25f) < 0.02f) ? 0.8f : 0.0f; // Bumps
+    }
+    memcpy(in->bias, bias, sizeof(bias));
+}
+
+// Log of the samples as the driver would have drained them: task wakeups
+// late by up to jitter_us, and lost_n samples from lost_from on never read (a
+// stalled drain). Starts 3s before micros() wraps with the sensor counter
+// about to wrap; `pre` events follow the settings ahead of the first batch
+// (BIAS / ATTITUDE: the warm-start snapshot). Returns the number of samples lost.
+static uint32_t synthLog(const std::vector<QMIFrame>& samples, uint32_t jitter_us, uint32_t lost_from, uint32_t lost_n,
+                         const std::vector<ImuLogEvent>& pre, std::vector<uint8_t>* out) {
+    const uint32_t start_us = 0xFFFFFFFFu - 3000000u + 1;  // micros() wraps 3s in
+    const uint32_t counter0 = QMI_COUNTER_WRAP - 1000;      // Sensor counter wraps ~1.1s in
+    const uint32_t period = IMU_SAMPLE_PERIOD_US;
+    const uint32_t total = (uint32_t)samples.size();
+
+    out->assign(IMU_LOG_HEADER_BYTES, 0);
+    ImuLogHeader h = {0};
+    h.flags = buildFlags();
+    h.sample_period_us = period;
+    h.acc_lsb_per_g = 8192;
+    h.gyr_lsb_per_dps = 512;
+    h.start_us = start_us;
+    imuLogWriteHeader(out->data(), &h);
+
+    ImuLogCodec codec;
+    imuLogCodecInit(&codec, start_us);
+    uint8_t rec[IMU_LOG_MAX_BATCH_BYTES + IMU_FIFO_MAX_SAMPLES * IMU_LOG_MAX_SAMPLE_BYTES];
+
+    ImuLogEvent ev = {0};
+    ev.type = IMU_LOG_EV_MODE;
+    ev.u8 = 0;
+    out->insert(out->end(), rec, rec + imuLogEncodeEvent(rec, &ev));
+    ev.type = IMU_LOG_EV_SMOOTHING;
+    ev.u8 = 100;
+    out->insert(out->end(), rec, rec + imuLogEncodeEvent(rec, &ev));
+    ev.type = IMU_LOG_EV_OFFSETS;
+    out->insert(out->end(), rec, rec + imuLogEncodeEvent(rec, &ev));
+    for (const ImuLogEvent& e : pre) out->insert(out->end(), rec, rec + imuLogEncodeEvent(rec, &e));
+
+    uint32_t jitter_rng = 777;
+    uint32_t next = 0;          // First sample not yet delivered
+    uint32_t lost = 0;
+    for (uint32_t wake = 1; next < total; wake++) {
+        // Task wakeup (FIFO) or sample read (polling), late by up to jitter_us
+        uint32_t late = jitter_us ? lcg(&jitter_rng) % (jitter_us + 1) : 0;
+        uint32_t t_rel = IMU_USE_FIFO ? wake * IMU_TASK_PERIOD_MS * 1000 + late
+                                      : (wake - 1) * period + (late % period);
+        uint32_t newest = IMU_USE_FIFO ? t_rel / period : wake - 1;  // Last sample produced
+        if (newest >= total) newest = total - 1;
+        if (lost_n && next < lost_from && newest >= lost_from) newest = lost_from - 1; // Same loss at any jitter
+        if (newest < next) continue;
+
+        ImuLogBatch b = {0};
+        b.t_us = start_us + t_rel;
+        b.flags = IMU_LOG_BATCH_COUNTER;
+        b.counter = (counter0 + newest) & (QMI_COUNTER_WRAP - 1);
+        // Now and then the next sample lands while the FIFO is being read:
+        // counted by the counter, drained next time
+        if (IMU_USE_FIFO && newest + 1 < total && lcg(&jitter_rng) % 10 == 0) {
+            b.counter = (b.counter + 1) & (QMI_COUNTER_WRAP - 1);
+        }
+
+        // Stalled drain (and anything beyond the FIFO depth) never reaches the
+        // driver. Lost samples always precede the batch, as with the real FIFO.
+        uint32_t first = next;
+        if (first >= lost_from && first < lost_from + lost_n) first = lost_from + lost_n;
+        if (newest + 1 > first + IMU_FIFO_MAX_SAMPLES) first = newest + 1 - IMU_FIFO_MAX_SAMPLES;
+        if (first > newest + 1) first = newest + 1;
+        if (first > next) {
+            lost += first - next;
+            b.flags |= IMU_LOG_BATCH_OVERFLOW;
+        }
+        next = newest + 1;
+        if (first > newest) continue;
+
+        b.n = (uint16_t)(newest + 1 - first);
+        size_t len = imuLogEncodeBatch(&codec, rec, &b);
+        for (uint32_t k = first; k <= newest; k++) len += imuLogEncodeSample(&codec, &rec[len], samples[k].raw);
+        out->insert(out->end(), rec, rec + len);
+    }
+    return lost;
+}
+
+// --synth: the drive, losing SYNTH_LOST_SAMPLES 60% of the way in. With the
+// counter time base the fused angles must not depend on the wakeup jitter.
+#define SYNTH_LOST_SAMPLES 40
+
+static int synthesize(const char* path, float seconds, uint32_t jitter_us) {
+    const uint32_t total = (uint32_t)(seconds * 1000000.0f / IMU_SAMPLE_PERIOD_US);
+    std::vector<SynthTruth> truth;
+    std::vector<QMIFrame> samples = synthFrames(total, driveProfile, &truth);
+    std::vector<uint8_t> out;
+    uint32_t lost = synthLog(samples, jitter_us, total * 6 / 10, SYNTH_LOST_SAMPLES, {}, &out);
+
+    if (!writeFile(path, out)) {
+        fprintf(stderr, "Cannot write %s\n", path);
+        return 1;
+    }
+    printf("Wrote %s: %u samples (%u lost), %u bytes (%.2f bytes/sample). Truth at end: Roll=%f Pitch=%f\n",
+           path, (unsigned)total, (unsigned)lost, (unsigned)out.size(), (double)out.size() / total,
+           truth.back().roll, truth.back().pitch);
+    return 0;
+}
+
+// --- Replay ---
+// Device state at the start of the recording, from the events ahead of the first batch
+struct InitialState {
+    bool have_mode = false, have_smooth = false, have_offsets = false, have_bias = false, have_att = false;
+    int mode = 0, smooth = 100;
+    float off[2] = {0, 0};
+    int32_t bias_q8[3] = {0, 0, 0};
+    float att[2] = {0, 0};
+};
+
+static void scanInitialState(const std::vector<uint8_t>& log, size_t pos, uint32_t start_us, InitialState* st) {
+    ImuLogCodec c;
+    imuLogCodecInit(&c, start_us);
+    while (pos < log.size()) {
+        uint8_t tag;
+        ImuLogBatch b;
+        ImuLogEvent ev;
+        size_t n = imuLogDecodeRecord(&c, &log[pos], log.size() - pos, &tag, &b, &ev);
+        if (!n || tag != IMU_LOG_TAG_EVENT) return;
+        pos += n;
+        switch (ev.type) {
+            case IMU_LOG_EV_MODE:      st->have_mode = true; st->mode = ev.u8; break;
+            case IMU_LOG_EV_SMOOTHING: st->have_smooth = true; st->smooth = ev.u8; break;
+            case IMU_LOG_EV_OFFSETS:   st->have_offsets = true; st->off[0] = ev.f[0]; st->off[1] = ev.f[1]; break;
+            case IMU_LOG_EV_BIAS:      st->have_bias = true; memcpy(st->bias_q8, ev.bias_q8, sizeof(st->bias_q8)); break;
+            case IMU_LOG_EV_ATTITUDE:  st->have_att = true; st->att[0] = ev.f[0]; st->att[1] = ev.f[1]; break;
+            default: break;
+        }
+    }
+}
+
+// Seed the NVS stand-in so initIMU() starts the way the device was running
+static void preloadPrefs(const InitialState& st, bool cold) {
+    Preferences p;
+    p.begin("imu", false);
+    if (st.have_mode) p.putInt("mode", st.mode);
+    if (st.have_smooth) p.putInt("smooth", st.smooth);
+    if (st.have_offsets) {
+        p.putFloat("roll_off", st.off[0]);
+        p.putFloat("pitch_off", st.off[1]);
+    }
+    if (cold || !st.have_bias) return;
+    p.putUInt("boots", 0);
+    p.putUInt("ws_boot", 1);
+    p.putBytes("ws_bias", st.bias_q8, sizeof(st.bias_q8));
+    if (st.have_att) {
+        p.putFloat("ws_roll", st.att[0]);
+        p.putFloat("ws_pitch", st.att[1]);
+    }
+}
+
+static void applyEvent(const ImuLogEvent& ev) {
+    switch (ev.type) {
+        case IMU_LOG_EV_MODE:      setCalculationMode(ev.u8); break;
+        case IMU_LOG_EV_SMOOTHING: setSmoothing(ev.u8); break;
+        case IMU_LOG_EV_OFFSETS:   offsetRoll = ev.f[0]; offsetPitch = ev.f[1]; break;
+        default: break; // ZERO: the new offsets follow. BIAS: re-estimated by the driver.
+    }
+}
+
+// --- Fault injection into the register model ---
+// reset@T      Brown-out at T s: sensor silent until the driver re-inits it
+// nack@T+D     Every transaction NACKs for D s
+// flaky@T+D    Every 20th transaction NACKs for D s
+// stuck@T+D    Output frozen on the last sample for D s (counter keeps running)
+enum FaultKind { FAULT_RESET, FAULT_NACK, FAULT_FLAKY, FAULT_STUCK };
+
+struct Fault {
+    FaultKind kind;
+    uint32_t start_us;   // Relative to the log start
+    uint32_t dur_us;
+    bool fired;
+};
+
+static std::vector<Fault> faults;
+static QMIFrame last_frame = {};
+
+static bool parseFault(const char* arg) {
+    char kind[16];
+    float start = 0.0f, dur = 0.0f;
+    int n = sscanf(arg, "%15[a-z]@%f+%f", kind, &start, &dur);
+    if (n < 2 || start < 0.0f || dur < 0.0f) return false;
+
+    Fault f = { FAULT_RESET, (uint32_t)(start * 1e6f), (uint32_t)(dur * 1e6f), false };
+    if (!strcmp(kind, "reset")) f.kind = FAULT_RESET;
+    else if (!strcmp(kind, "nack") && n == 3) f.kind = FAULT_NACK;
+    else if (!strcmp(kind, "flaky") && n == 3) f.kind = FAULT_FLAKY;
+    else if (!strcmp(kind, "stuck") && n == 3) f.kind = FAULT_STUCK;
+    else return false;
+    faults.push_back(f);
+    return true;
+}
+
+static void applyFaults(uint32_t t_rel) {
+    bool nack = false, flaky = false, stuck = false;
+    for (Fault& f : faults) {
+        bool active = t_rel >= f.start_us && t_rel - f.start_us < f.dur_us;
+        if (f.kind == FAULT_RESET && t_rel >= f.start_us && !f.fired) {
+            qmi_model.powerLoss();
+            f.fired = true;
+            fprintf(stderr, "[fault] Power loss at %.3f s\n", t_rel / 1e6);
+        }
+        if (f.kind == FAULT_NACK) nack |= active;
+        if (f.kind == FAULT_FLAKY) flaky |= active;
+        if (f.kind == FAULT_STUCK) stuck |= active;
+    }
+    if (nack != qmi_model.nack) fprintf(stderr, "[fault] NACK %s at %.3f s\n", nack ? "on" : "off", t_rel / 1e6);
+    if (flaky != qmi_model.flaky) fprintf(stderr, "[fault] Flaky bus %s at %.3f s\n", flaky ? "on" : "off", t_rel / 1e6);
+    if (stuck != qmi_model.stuck) fprintf(stderr, "[fault] Stuck %s at %.3f s\n", stuck ? "on" : "off", t_rel / 1e6);
+    if (stuck && !qmi_model.stuck) qmi_model.stuck_frame = last_frame;
+    qmi_model.nack = nack;
+    qmi_model.flaky = flaky;
+    qmi_model.stuck = stuck;
+}
+
+// --- Power policy (--power) ---
+// Polls the driver's motion peaks every POWER_POLL_MS of log time, like the
+// loop's power job. Asleep, the device only has the QMI8658 wake-on-motion:
+// modelled as the accel deviation passing POWER_WOM_MG, acted on at the next
+// POWER_SLEEP_POLL_MS timer wakeup (straight away with IMU_INT_PIN routed).
+static bool power_on = false;
+static PowerConfig power_cfg = {
+    POWER_STILL_GYRO_DPS * 1000UL, POWER_STILL_ACC_MG, POWER_STILL_MS, POWER_DIM_MS, POWER_SLEEP_MS,
+};
+static PowerPolicy power;
+static uint32_t power_next_ms = 0;
+static uint32_t power_sleep_ms = 0;    // Entered SLEEP
+static uint32_t power_motion_ms = 0;   // WoM threshold passed while asleep
+static uint32_t power_wake_at_ms = 0;
+static uint32_t power_wake_max_ms = 0;
+
+static bool parsePower(const char* arg) {
+    float still, dim, sleep;
+    if (sscanf(arg, "%f,%f,%f", &still, &dim, &sleep) != 3 || still < 0 || dim < 0 || sleep < 0) return false;
+    power_cfg.still_ms = (uint32_t)(still * 1000);
+    power_cfg.dim_ms = (uint32_t)(dim * 1000);
+    power_cfg.sleep_ms = (uint32_t)(sleep * 1000);
+    return true;
+}
+
+static void powerStep(uint32_t now_ms) {
+    IMUMotion m;
+    readIMUMotion(&m);
+
+    if (power.state == PWR_SLEEP) {
+        if (!power_motion_ms && m.acc_mg > POWER_WOM_MG) {
+            power_motion_ms = now_ms;
+#if IMU_INT_PIN >= 0
+            power_wake_at_ms = now_ms;
+#else
+            uint32_t polls = (now_ms - power_sleep_ms + POWER_SLEEP_POLL_MS - 1) / POWER_SLEEP_POLL_MS;
+            power_wake_at_ms = power_sleep_ms + polls * POWER_SLEEP_POLL_MS;
+#endif
+        }
+        if (!power_motion_ms || now_ms < power_wake_at_ms) return;
+        pwrWake(&power, now_ms);
+        uint32_t latency = now_ms - power_motion_ms;
+        if (latency > power_wake_max_ms) power_wake_max_ms = latency;
+        printf("  %9.1f s  %-6s  (wake-on-motion, %u ms after the motion)\n", now_ms / 1000.0f,
+               pwrStateName(power.state), (unsigned)latency);
+        return;
+    }
+
+    if (!pwrUpdate(&power, now_ms, m.gyro_mdps, m.acc_mg, false)) return;
+    printf("  %9.1f s  %-6s  (gyro %u mdps, accel %u mg)\n", now_ms / 1000.0f, pwrStateName(power.state),
+           (unsigned)m.gyro_mdps, (unsigned)m.acc_mg);
+    if (power.state == PWR_SLEEP) {
+        power_sleep_ms = now_ms;
+        power_motion_ms = 0;
+    }
+}
+
+// After each driver update: every POWER_POLL_MS of log time crossed
+static void powerAdvance(uint32_t t_rel_us) {
+    if (!power_on) return;
+    uint32_t now_ms = t_rel_us / 1000;
+    if (now_ms < power_next_ms) return;
+    powerStep(now_ms);
+    while (power_next_ms <= now_ms) power_next_ms += POWER_POLL_MS;
+}
+
+static void powerSummary() {
+    if (!power_on) return;
+    printf("Power: %u transitions, %u wakes (max %u ms after the motion, poll %u ms)\n",
+           (unsigned)power.transitions, (unsigned)power.wakes, (unsigned)power_wake_max_ms, POWER_SLEEP_POLL_MS);
+    printf("  time in");
+    for (int i = 0; i < PWR_STATE_COUNT; i++) printf(" %s %.1fs", pwrStateName(i), power.time_ms[i] / 1000.0f);
+    printf("\n");
+}
+
+// --- Replay loop ---
+// Called after each driver update with the time into the log
+typedef void (*ReplayHook)(uint32_t t_rel_us, void* ctx);
+
+struct ReplayRun {
+    uint32_t start_us = 0;
+    bool warm = false;
+    uint64_t samples = 0, batches = 0, events = 0, gaps = 0;
+    bool truncated = false;
+    StageTime t_decode, t_bus, t_fusion;
+};
+
+// Initializes the driver as the recording's device was and feeds it the log.
+// False if the log is unreadable.
+static bool replayLog(const std::vector<uint8_t>& log, const char* name, bool cold, FILE* csv,
+                      ReplayHook hook, void* ctx, ReplayRun* run) {
+    ImuLogHeader h;
+    size_t pos = imuLogReadHeader(log.data(), log.size(), &h);
+    if (!pos) {
+        fprintf(stderr, "%s: Not an IMU log (or unsupported version)\n", name);
+        return false;
+    }
+    if (h.flags != buildFlags()) {
+        fprintf(stderr, "Warning: Recorded with FIFO=%d FIXED=%d, replaying with FIFO=%d FIXED=%d\n",
+                !!(h.flags & IMU_LOG_FLAG_FIFO), !!(h.flags & IMU_LOG_FLAG_FIXED_POINT),
+                IMU_USE_FIFO, IMU_USE_FIXED_POINT);
+    }
+    if (h.sample_period_us != IMU_SAMPLE_PERIOD_US || h.acc_lsb_per_g != 8192 || h.gyr_lsb_per_dps != 512) {
+        fprintf(stderr, "Warning: Sensor config differs from this build (period %u us, %u LSB/g, %u LSB/dps)\n",
+                h.sample_period_us, h.acc_lsb_per_g, h.gyr_lsb_per_dps);
+    }
+
+    InitialState st;
+    scanInitialState(log, pos, h.start_us, &st);
+    preloadPrefs(st, cold);
+    run->start_us = h.start_us;
+    run->warm = !cold && st.have_bias;
+
+    hostSetMicros(h.start_us);
+    i2cBusInit();
+    initPersist(); // No task on the host: settings writes just queue up
+    initIMU();
+    pwrInit(&power, &power_cfg, 0);
+    if (power_on) {
+        printf("Power policy: still %.0fs, dim %.0fs, sleep %.0fs (gyro > %u dps or accel > %u mg is motion)\n",
+               power_cfg.still_ms / 1000.0f, power_cfg.dim_ms / 1000.0f, power_cfg.sleep_ms / 1000.0f,
+               POWER_STILL_GYRO_DPS, POWER_STILL_ACC_MG);
+    }
+
+    ImuLogCodec codec;
+    imuLogCodecInit(&codec, h.start_us);
+    std::vector<QMIFrame> frames;
+
+    while (pos < log.size()) {
+        uint8_t tag;
+        ImuLogBatch b;
+        ImuLogEvent ev;
+        Clock::time_point t0 = Clock::now();
+        size_t n = imuLogDecodeRecord(&codec, &log[pos], log.size() - pos, &tag, &b, &ev);
+        if (!n) {
+            run->truncated = true;
+            break;
+        }
+        pos += n;
+
+        if (tag == IMU_LOG_TAG_EVENT) {
+            applyEvent(ev);
+            run->events++;
+            continue;
+        }
+
+        frames.resize(b.n);
+        for (uint16_t i = 0; i < b.n; i++) {
+            size_t m = imuLogDecodeSample(&codec, &log[pos], log.size() - pos, frames[i].raw);
+            if (!m) {
+                run->truncated = true;
+                break;
+            }
+            pos += m;
+        }
+        if (run->truncated) break;
+        run->t_decode.add(elapsedNs(t0));
+        if (b.flags & IMU_LOG_BATCH_GAP) run->gaps++;
+        run->batches++;
+        run->samples += b.n;
+
+        // Feed the driver exactly as the sensor delivered it
+#if IMU_USE_FIFO
+        applyFaults(b.t_us - h.start_us);
+        for (const QMIFrame& f : frames) qmi_model.push(f);
+        if (b.n) last_frame = frames[b.n - 1];
+        if (b.flags & IMU_LOG_BATCH_OVERFLOW) qmi_model.overflow = true;
+        qmi_model.counter = (b.flags & IMU_LOG_BATCH_COUNTER) ? b.counter : qmi_model.counter + b.n;
+        hostSetMicros(b.t_us);
+        uint64_t bus0 = qmi_model.bus_ns;
+        t0 = Clock::now();
+        updateIMU();
+        uint64_t total = elapsedNs(t0), bus = qmi_model.bus_ns - bus0;
+        run->t_bus.add(bus);
+        run->t_fusion.add(total > bus ? total - bus : 0);
+        if (csv) fprintf(csv, "%u,%.6f,%.6f\n", (unsigned)b.t_us, currentRoll, currentPitch);
+        powerAdvance(b.t_us - h.start_us);
+        if (hook) hook(b.t_us - h.start_us, ctx);
+#else
+        for (uint16_t i = 0; i < b.n; i++) {
+            uint32_t t = b.t_us - (uint32_t)(b.n - 1 - i) * h.sample_period_us;
+            applyFaults(t - h.start_us);
+            qmi_model.current = last_frame = frames[i];
+            qmi_model.counter = (b.flags & IMU_LOG_BATCH_COUNTER) ? b.counter - (b.n - 1 - i) : qmi_model.counter + 1;
+            qmi_model.data_ready = true;
+            hostSetMicros(t);
+            uint64_t bus0 = qmi_model.bus_ns;
+            t0 = Clock::now();
+            updateIMU();
+            uint64_t total = elapsedNs(t0), bus = qmi_model.bus_ns - bus0;
+            run->t_bus.add(bus);
+            run->t_fusion.add(total > bus ? total - bus : 0);
+            if (csv) fprintf(csv, "%u,%.6f,%.6f\n", (unsigned)t, currentRoll, currentPitch);
+            powerAdvance(t - h.start_us);
+            if (hook) hook(t - h.start_us, ctx);
+        }
+#endif
+    }
+    return true;
+}
+
+// --- Checks (--check) ---
+// Synthetic logs with known truth, replayed in memory; each scenario runs in
+// its own process (the driver's state is static) and prints its numbers
+// against the pass/fail thresholds.
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    if (!ok) {
+        printf("    FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+// Driver output against the truth of the newest fused sample
+struct Tracking {
+    const std::vector<SynthTruth>* truth;
+    float tol_dps;              // Bias error that counts as converged
+    float tol_deg = 1.0f;       // Attitude error that counts as correct
+    uint32_t from_us = 0;       // Ignore the first estimate
+    float bias_err_max = 0;     // dps, worst axis
+    float att_err_max = 0;      // deg
+    uint32_t last_off_us = 0;   // Last update with the bias error above tol_dps
+    uint32_t right_since_us = 0; // Both errors within tolerance from this update on (0 = not)
+    uint32_t valid_us = 0;      // First update the driver reported valid (0 = never)
+    float valid_bias_err = 0, valid_att_err = 0;
+    float bias_err_at[64] = {}; // Worst axis, per second of log
+    float att_err_at[64] = {};  // Worse of roll / pitch, per second of log
+};
+
+static void trackHook(uint32_t t_rel_us, void* ctx) {
+    Tracking* tk = (Tracking*)ctx;
+    if (t_rel_us < tk->from_us) return;
+    size_t k = t_rel_us / IMU_SAMPLE_PERIOD_US;
+    if (k >= tk->truth->size()) k = tk->truth->size() - 1;
+    const SynthTruth& tr = (*tk->truth)[k];
+
+    const float off[3] = { gyroX_offset, gyroY_offset, gyroZ_offset };
+    float err = 0;
+    for (int i = 0; i < 3; i++) err = fmaxf(err, fabsf(off[i] - tr.bias[i]));
+    float att = fmaxf(fabsf(currentRoll - tr.roll), fabsf(currentPitch - tr.pitch));
+
+    if (err > tk->bias_err_max) tk->bias_err_max = err;
+    if (att > tk->att_err_max) tk->att_err_max = att;
+    if (err > tk->tol_dps) tk->last_off_us = t_rel_us;
+    if (err > tk->tol_dps || att > tk->tol_deg) tk->right_since_us = 0;
+    else if (!tk->right_since_us) tk->right_since_us = t_rel_us;
+    if (!tk->valid_us && getIMUTimeToValidMs()) {
+        tk->valid_us = t_rel_us;
+        tk->valid_bias_err = err;
+        tk->valid_att_err = att;
+    }
+    uint32_t s = t_rel_us / 1000000;
+    if (s < 64) {
+        tk->bias_err_at[s] = fmaxf(tk->bias_err_at[s], err);
+        tk->att_err_at[s] = fmaxf(tk->att_err_at[s], att);
+    }
+}
+
+static void replayTracked(SynthProfile profile, float seconds, const std::vector<ImuLogEvent>& pre, bool cold,
+                          Tracking* tk, std::vector<SynthTruth>* truth) {
+    std::vector<QMIFrame> samples = synthFrames((uint32_t)(seconds * 1000000.0f / IMU_SAMPLE_PERIOD_US), profile, truth);
+    std::vector<uint8_t> log;
+    synthLog(samples, 2000, 0, 0, pre, &log);
+    tk->truth = truth;
+    ReplayRun run;
+    replayLog(log, "synth", cold, NULL, trackHook, tk, &run);
+}
+
+// drive: the --synth drive (still, roll ramp, corner, bumps) for 20s, cold.
+// The corner's 0.35g lateral is not gravity: roll must not follow it, and
+// must not be left off by it once the bumps start. The bias never changes.
+#define DRIVE_SECONDS      20.0f
+#define DRIVE_ATT_MAX_DEG  0.5f   // Any phase, once valid
+#define DRIVE_FINAL_DEG    0.2f
+#define DRIVE_TOL_DPS      0.02f
+
+static void drive() {
+    std::vector<SynthTruth> truth;
+    Tracking tk;
+    tk.tol_dps = DRIVE_TOL_DPS;
+    replayTracked(driveProfile, DRIVE_SECONDS, {}, true, &tk, &truth);
+
+    // driveProfile's phases, in seconds of a 20s log
+    struct { const char* name; int from, to; } phases[] = {
+        { "still", 1, 5 }, { "roll ramp", 5, 9 }, { "corner", 9, 14 }, { "bumps", 14, 20 },
+    };
+    bool phases_ok = true;
+    for (const auto& ph : phases) {
+        float att = 0, bias = 0;
+        for (int s = ph.from; s < ph.to; s++) {
+            att = fmaxf(att, tk.att_err_at[s]);
+            bias = fmaxf(bias, tk.bias_err_at[s]);
+        }
+        printf("    %-10s attitude error max %.3f deg, bias error max %.4f dps\n", ph.name, att, bias);
+        phases_ok &= att < DRIVE_ATT_MAX_DEG && bias < DRIVE_TOL_DPS;
+    }
+    const SynthTruth& end = truth.back();
+    float final_err = fmaxf(fabsf(currentRoll - end.roll), fabsf(currentPitch - end.pitch));
+    printf("    final Roll=%.3f Pitch=%.3f, truth %.3f / %.3f (limit %.1f deg), limits %.1f deg / %.2f dps per phase\n",
+           currentRoll, currentPitch, end.roll, end.pitch, DRIVE_FINAL_DEG, DRIVE_ATT_MAX_DEG, DRIVE_TOL_DPS);
+    check(tk.valid_us > 0 && tk.valid_us < 1000000, "valid within the first still second");
+    check(phases_ok, "attitude and bias follow the truth through every phase");
+    check(final_err < DRIVE_FINAL_DEG, "final attitude");
+}
+
+// bias-step: parked, the bias jumps by 0.5 dps (X) and -0.3 dps (Y). The
+// estimate must track the old value, then settle on the new one within a
+// few still windows without the attitude moving.
+#define STEP_AT_S         16.0f
+#define STEP_SETTLE_MAX_S 8.0f    // Blend of 1/4 per 0.5s window: ~6s to 0.5 dps/40
+#define STEP_TOL_DPS      0.02f
+#define STEP_ATT_MAX_DEG  0.5f
+
+static void biasStepProfile(float t, float seconds, SynthInput* in) {
+    static const float before[3] = { 0.35f, -0.20f, 0.12f };
+    static const float after[3] = { 0.85f, -0.50f, 0.12f };
+    memcpy(in->bias, t < STEP_AT_S ? before : after, sizeof(in->bias));
+}
+
+static void biasStep() {
+    std::vector<SynthTruth> truth;
+    Tracking tk;
+    tk.tol_dps = STEP_TOL_DPS;
+    tk.from_us = 2000000;
+    replayTracked(biasStepProfile, 40.0f, {}, true, &tk, &truth);
+
+    float before = 0;
+    for (int s = 2; s < (int)STEP_AT_S; s++) before = fmaxf(before, tk.bias_err_at[s]);
+    float settle = tk.last_off_us / 1e6f - STEP_AT_S;
+    printf("    before the step: bias error max %.4f dps (limit %.2f)\n", before, STEP_TOL_DPS);
+    printf("    after: within %.2f dps %.2f s after the step (limit %.1f s), final error %.4f dps\n",
+           STEP_TOL_DPS, settle, STEP_SETTLE_MAX_S, tk.bias_err_at[39]);
+    printf("    attitude error max %.3f deg (limit %.1f)\n", tk.att_err_max, STEP_ATT_MAX_DEG);
+    check(before < STEP_TOL_DPS, "bias tracked before the step");
+    check(settle > 0 && settle < STEP_SETTLE_MAX_S, "bias settles after the step");
+    check(tk.bias_err_at[39] < STEP_TOL_DPS, "final bias");
+    check(tk.att_err_max < STEP_ATT_MAX_DEG, "attitude held through the step");
+}
+
+// temp-ramp: 60s warm-up, the bias drifting by ~0.6 dps on each axis, with
+// the car swaying (no still windows) 4s in every 10. The estimate lags the
+// ramp by the blend time constant and coasts through each sway.
+#define RAMP_STILL_TOL_DPS 0.05f  // Still for 3s or more
+#define RAMP_MAX_DPS       0.10f  // Anywhere after the first still window
+#define RAMP_ATT_MAX_DEG   0.5f
+
+static const float ramp_rate[3] = { 0.010f, -0.006f, 0.008f };  // dps/s
+
+static bool rampSway(float t) {
+    return t >= 8.0f && fmodf(t - 8.0f, 10.0f) < 4.0f;
+}
+
+static void tempRampProfile(float t, float seconds, SynthInput* in) {
+    static const float b0[3] = { 0.35f, -0.20f, 0.12f };
+    for (int i = 0; i < 3; i++) in->bias[i] = b0[i] + ramp_rate[i] * t;
+    if (rampSway(t)) in->roll_rate = 10.0f * sinf(2.0f * (float)M_PI * (t - 8.0f) / 2.0f); // +-3 deg at 0.5 Hz
+}
+
+static void tempRamp() {
+    std::vector<SynthTruth> truth;
+    Tracking tk;
+    tk.tol_dps = RAMP_STILL_TOL_DPS;
+    tk.from_us = 2000000;
+    replayTracked(tempRampProfile, 60.0f, {}, true, &tk, &truth);
+
+    // Still seconds whose start is 3s or more past the last sway
+    float still_max = 0;
+    for (int s = 3; s < 60; s++) {
+        if (!rampSway(s) && !rampSway(s - 1.0f) && !rampSway(s - 2.0f) && !rampSway(s - 3.0f)) {
+            still_max = fmaxf(still_max, tk.bias_err_at[s]);
+        }
+    }
+    printf("    bias error max %.4f dps still (limit %.2f), %.4f overall (limit %.2f)\n", still_max,
+           RAMP_STILL_TOL_DPS, tk.bias_err_max, RAMP_MAX_DPS);
+    printf("    attitude error max %.3f deg (limit %.1f)\n", tk.att_err_max, RAMP_ATT_MAX_DEG);
+    check(still_max < RAMP_STILL_TOL_DPS, "bias follows the ramp while still");
+    check(tk.bias_err_max < RAMP_MAX_DPS, "bias coasts through the sway");
+    check(tk.att_err_max < RAMP_ATT_MAX_DEG, "attitude held through the ramp");
+}
+
+// boot: time from the first sample to a valid angle, cold (no snapshot: the
+// bias waits for a still window, as before the warm start) and warm (bias and
+// attitude from the NVS snapshot, valid after the IMU_SEED_SAMPLES seed). The
+// snapshot is a little off (0.03 dps, 0.3 deg), as after a short drive. Parked,
+// and rocking for the first 8s (someone getting in: no still window).
+#define BOOT_WARM_MAX_MS  50      // Seed window ~18ms + first drain
+#define BOOT_SPEEDUP_MIN  10      // Warm vs cold, parked
+#define BOOT_TOL_DPS      0.05f
+#define BOOT_TOL_DEG      1.0f
+
+static void bootParkedProfile(float t, float seconds, SynthInput* in) {
+    static const float bias[3] = { 0.35f, -0.20f, 0.12f };
+    memcpy(in->bias, bias, sizeof(bias));
+}
+
+static void bootRockingProfile(float t, float seconds, SynthInput* in) {
+    bootParkedProfile(t, seconds, in);
+    if (t < 8.0f) in->roll_rate = 10.0f * sinf(2.0f * (float)M_PI * t / 2.0f);
+}
+
+struct BootResult {
+    uint32_t valid_ms;          // Driver's first valid reading (0 = never)
+    uint32_t correct_ms;        // Angle and bias within tolerance from here on
+    float bias_err, att_err;    // At the first valid reading
+};
+
+static BootResult bootRun(SynthProfile profile, bool warm) {
+    std::vector<ImuLogEvent> pre;
+    if (warm) {
+        SynthInput in = {};
+        profile(0.0f, 12.0f, &in);
+        ImuLogEvent ev = {0};
+        ev.type = IMU_LOG_EV_BIAS;
+        for (int i = 0; i < 3; i++) ev.bias_q8[i] = (int32_t)lrintf((in.bias[i] + 0.03f) * 512.0f * 256.0f);
+        pre.push_back(ev);
+        ev.type = IMU_LOG_EV_ATTITUDE;
+        ev.f[0] = 2.0f + 0.3f;   // synthFrames() starts at roll 2, pitch -1
+        ev.f[1] = -1.0f - 0.3f;
+        pre.push_back(ev);
+    }
+    std::vector<SynthTruth> truth;
+    Tracking tk;
+    tk.tol_dps = BOOT_TOL_DPS;
+    tk.tol_deg = BOOT_TOL_DEG;
+    replayTracked(profile, 12.0f, pre, !warm, &tk, &truth);
+    BootResult r = { tk.valid_us / 1000, tk.right_since_us / 1000, tk.valid_bias_err, tk.valid_att_err };
+    return r;
+}
+
+// Each run gets a fresh driver: in a child, result back over a pipe
+static BootResult bootMeasure(SynthProfile profile, bool warm) {
+    BootResult r = {0, 0, 0, 0};
+    int fd[2];
+    if (pipe(fd)) return r;
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fd[0]);
+        r = bootRun(profile, warm);
+        if (write(fd[1], &r, sizeof(r)) != sizeof(r)) _exit(1);
+        _exit(0);
+    }
+    close(fd[1]);
+    if (read(fd[0], &r, sizeof(r)) != sizeof(r)) memset(&r, 0, sizeof(r));
+    close(fd[0]);
+    waitpid(pid, NULL, 0);
+    return r;
+}
+
+static void bootTime() {
+    struct { const char* name; SynthProfile profile; } shapes[] = {
+        { "parked", bootParkedProfile },
+        { "rocking 8s", bootRockingProfile },
+    };
+    printf("    %-26s %10s %10s %12s %10s\n", "", "valid", "correct", "bias err", "att err");
+    for (const auto& sh : shapes) {
+        BootResult cold = bootMeasure(sh.profile, false);
+        BootResult warm = bootMeasure(sh.profile, true);
+        char label[40];
+        snprintf(label, sizeof(label), "%s, cold (before)", sh.name);
+        printf("    %-26s %7u ms %7u ms %8.4f dps %6.2f deg\n", label, (unsigned)cold.valid_ms,
+               (unsigned)cold.correct_ms, cold.bias_err, cold.att_err);
+        snprintf(label, sizeof(label), "%s, warm (after)", sh.name);
+        printf("    %-26s %7u ms %7u ms %8.4f dps %6.2f deg\n", label, (unsigned)warm.valid_ms,
+               (unsigned)warm.correct_ms, warm.bias_err, warm.att_err);
+
+        check(cold.valid_ms > 0 && warm.valid_ms > 0, "both starts become valid");
+        check(warm.valid_ms <= BOOT_WARM_MAX_MS, "warm start valid within BOOT_WARM_MAX_MS");
+        check(warm.correct_ms && warm.correct_ms <= warm.valid_ms, "warm start correct when it says valid");
+        check(cold.correct_ms && cold.correct_ms <= cold.valid_ms, "cold start not valid before it is correct");
+        check(warm.bias_err < BOOT_TOL_DPS && warm.att_err < BOOT_TOL_DEG, "warm start within tolerance");
+        check(cold.valid_ms >= BOOT_SPEEDUP_MIN * warm.valid_ms, "warm start BOOT_SPEEDUP_MIN x faster");
+    }
+}
+
+struct ReplayCheck {
+    const char* name;
+    void (*fn)();
+};
+
+static const ReplayCheck checks[] = {
+    { "drive", drive },
+    { "bias-step", biasStep },
+    { "temp-ramp", tempRamp },
+    { "boot", bootTime },
+};
+
+static bool runCheck(const ReplayCheck& rc) {
+    printf("%s\n", rc.name);
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+        rc.fn();
+        fflush(stdout);
+        _exit(failures ? 1 : 0);
+    }
+    int status = 0;
+    if (pid < 0 || waitpid(pid, &status, 0) != pid) return false;
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+static int runChecks(const std::vector<const char*>& only) {
+    Serial.enabled = false;
+    int failed = 0, ran = 0;
+    for (const ReplayCheck& rc : checks) {
+        bool selected = only.empty();
+        for (const char* name : only) selected |= !strcmp(name, rc.name);
+        if (!selected) continue;
+        ran++;
+        if (!runCheck(rc)) {
+            printf("    -> FAIL\n");
+            failed++;
+        }
+    }
+    printf("\n%d of %d checks passed\n%s\n", ran - failed, ran, failed ? "FAIL" : "OK");
+    return failed ? 1 : 0;
+}
+
+static void usage() {
+    fprintf(stderr, "usage: imu_replay [--cold] [--quiet] [--csv trace.csv] [--fault kind@s[+s]]... [--power [s,s,s]] imu.bin\n"
+                    "       imu_replay --synth out.bin [seconds] [jitter_us]\n"
+                    "       imu_replay --check [scenario...]\n"
+                    "faults: reset@T, nack@T+D, flaky@T+D, stuck@T+D (seconds into the log)\n"
+                    "power: still,dim,sleep idle seconds (default from board_config.h)\n");
+}
+
+int main(int argc, char** argv) {
+    const char* log_path = NULL;
+    const char* csv_path = NULL;
+    bool cold = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--synth") && i + 1 < argc) {
+            float seconds = (i + 2 < argc) ? (float)atof(argv[i + 2]) : 20.0f;
+            if (seconds <= 0.0f) seconds = 20.0f;
+            uint32_t jitter_us = (i + 3 < argc) ? (uint32_t)atoi(argv[i + 3]) : 0;
+            return synthesize(argv[i + 1], seconds, jitter_us);
+        } else if (!strcmp(argv[i], "--check")) {
+            return runChecks(std::vector<const char*>(argv + i + 1, argv + argc));
+        } else if (!strcmp(argv[i], "--cold")) {
+            cold = true;
+        } else if (!strcmp(argv[i], "--quiet")) {
+            Serial.enabled = false;
+        } else if (!strcmp(argv[i], "--fault") && i + 1 < argc) {
+            if (!parseFault(argv[++i])) {
+                usage();
+                return 2;
+            }
+        } else if (!strcmp(argv[i], "--power")) {
+            power_on = true;
+            if (i + 1 < argc && isdigit((unsigned char)argv[i + 1][0]) && strchr(argv[i + 1], ',')) {
+                if (!parsePower(argv[++i])) {
+                    usage();
+                    return 2;
+                }
+            }
+        } else if (!strcmp(argv[i], "--csv") && i + 1 < argc) {
+            csv_path = argv[++i];
+        } else if (argv[i][0] != '-' && !log_path) {
+            log_path = argv[i];
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (!log_path) {
+        usage();
+        return 2;
+    }
+
+    std::vector<uint8_t> log;
+    if (!readFile(log_path, &log)) {
+        fprintf(stderr, "Cannot read %s\n", log_path);
+        return 1;
+    }
+
+    FILE* csv = NULL;
+    if (csv_path) {
+        csv = fopen(csv_path, "w");
+        if (!csv) {
+            fprintf(stderr, "Cannot write %s\n", csv_path);
+            return 1;
+        }
+        fprintf(csv, "t_us,roll,pitch\n");
+    }
+
+    ReplayRun run;
+    bool ok = replayLog(log, log_path, cold, csv, NULL, NULL, &run);
+    if (csv) fclose(csv);
+    if (!ok) return 1;
+
+    printf("%s: %llu samples in %llu batches, %llu events, %llu gaps%s\n", log_path,
+           (unsigned long long)run.samples, (unsigned long long)run.batches, (unsigned long long)run.events,
+           (unsigned long long)run.gaps, run.truncated ? " (truncated)" : "");
+    IMUTimeStats ts;
+    getIMUTimeStats(&ts);
+    uint32_t valid_ms = getIMUTimeToValidMs();
+    printf("Final: Roll=%f Pitch=%f  Valid %u ms into the log (%s)\n", currentRoll, currentPitch,
+           valid_ms ? (unsigned)(valid_ms - run.start_us / 1000) : 0, run.warm ? "warm" : "cold");
+    printf("Sensor time %.3f s, %u samples dropped in %u gaps (max %u), %u resyncs\n",
+           ts.sensor_time_us / 1e6, (unsigned)ts.dropped_samples, (unsigned)ts.gaps,
+           (unsigned)ts.max_gap_samples, (unsigned)ts.resyncs);
+    IMUHealthStats hs;
+    getIMUHealthStats(&hs);
+    printf("Health %s: %u stalls, %u stuck, %u error bursts, %u re-inits (%u failed), %u recoveries\n",
+           getIMUFaultName(hs.fault), (unsigned)hs.stalls, (unsigned)hs.stuck, (unsigned)hs.error_bursts,
+           (unsigned)hs.reinits, (unsigned)hs.reinit_failures, (unsigned)hs.recoveries);
+    powerSummary();
+    printf("Stage timing (host):\n");
+    run.t_decode.print("decode", run.samples);
+    run.t_bus.print("bus", run.samples);
+    run.t_fusion.print("fusion", run.samples);
+    return run.truncated ? 1 : 0;
+}
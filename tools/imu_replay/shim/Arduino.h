@@ -0,0 +1,57 @@
+/*
+ * File: Arduino.h (imu_replay host shim)
+ * Description: Minimal Arduino API on a virtual clock for host replay
+ * Author: zzackk125
+ * License: MIT
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+#define IRAM_ATTR
+#define HIGH 1
+#define LOW 0
+#define INPUT 0x01
+#define INPUT_PULLUP 0x05
+#define RISING 0x01
+
+// Virtual time, advanced by the replay loop
+uint32_t micros();
+uint32_t millis();
+void hostSetMicros(uint32_t us);
+uint64_t hostMicros64();
+
+inline void delay(uint32_t ms) {
+    if (host_kernel) host_kernel->delay(pdMS_TO_TICKS(ms));
+}
+inline void delayMicroseconds(uint32_t) {}
+inline void pinMode(int, int) {}
+inline int digitalPinToInterrupt(int pin) { return pin; }
+// Attached handlers, for tests that model the pin (called as the ISR)
+inline void (*host_isr[48])(void) = {};
+inline void attachInterrupt(int pin, void (*isr)(void), int) {
+    if (pin >= 0 && pin < 48) host_isr[pin] = isr;
+}
+inline uint32_t getCpuFrequencyMhz() { return 1000; } // esp_cpu.h shim counts nanoseconds
+
+// Firmware log output goes to stderr (silenced with --quiet)
+class HostSerial {
+public:
+    bool enabled = true;
+    template <typename... A> int printf(const char* fmt, A... args) {
+        return enabled ? fprintf(stderr, fmt, args...) : 0;
+    }
+    void println(const char* s) { if (enabled) fprintf(stderr, "%s\n", s); }
+    void println() { if (enabled) fputc('\n', stderr); }
+    void print(const char* s) { if (enabled) fputs(s, stderr); }
+};
+extern HostSerial Serial;
@@ -0,0 +1,50 @@
+/*
+ * File: Preferences.h (imu_replay host shim)
+ * Description: In-memory NVS stand-in. The replay preloads it from the
+ *              log's initial events so initIMU() warm starts like the device.
+ * Author: zzackk125
+ * License: MIT
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <map>
+#include <string>
+#include <vector>
+
+class Preferences {
+public:
+    static std::map<std::string, std::vector<uint8_t>> store; // "namespace/key"
+
+    bool begin(const char* name, bool = false) { ns = name; return true; }
+    void end() {}
+    bool isKey(const char* key) { return store.count(k(key)) != 0; }
+
+    size_t putBytes(const char* key, const void* v, size_t len) {
+        const uint8_t* p = (const uint8_t*)v;
+        store[k(key)] = std::vector<uint8_t>(p, p + len);
+        return len;
+    }
+    size_t getBytes(const char* key, void* out, size_t len) {
+        auto it = store.find(k(key));
+        if (it == store.end() || it->second.size() > len) return 0;
+        memcpy(out, it->second.data(), it->second.size());
+        return it->second.size();
+    }
+
+    size_t putFloat(const char* key, float v) { return putBytes(key, &v, sizeof(v)); }
+    size_t putInt(const char* key, int32_t v) { return putBytes(key, &v, sizeof(v)); }
+    size_t putUInt(const char* key, uint32_t v) { return putBytes(key, &v, sizeof(v)); }
+    float getFloat(const char* key, float d = 0) { return get(key, d); }
+    int32_t getInt(const char* key, int32_t d = 0) { return get(key, d); }
+    uint32_t getUInt(const char* key, uint32_t d = 0) { return get(key, d); }
+
+private:
+    std::string ns;
+    std::string k(const char* key) const { return ns + "/" + key; }
+    template <typename T> T get(const char* key, T d) {
+        T v;
+        return getBytes(key, &v, sizeof(v)) == sizeof(v) ? v : d;
+    }
+};
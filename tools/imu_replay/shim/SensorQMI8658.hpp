@@ -0,0 +1,37 @@
+/*
+ * File: SensorQMI8658.hpp (imu_replay host shim)
+ * Description: The SensorLib calls imu_driver.cpp makes, against the register model
+ * Author: zzackk125
+ * License: MIT
+ */
+
+#pragma once
+
+#include <Wire.h>
+
+#define QMI8658_L_SLAVE_ADDRESS 0x6B
+
+struct IMUdata {
+    float x, y, z;
+};
+
+class SensorQMI8658 {
+public:
+    enum AccelRange { ACC_RANGE_2G, ACC_RANGE_4G, ACC_RANGE_8G, ACC_RANGE_16G };
+    enum AccelODR { ACC_ODR_1000Hz = 3 };
+    enum GyroRange { GYR_RANGE_16DPS, GYR_RANGE_32DPS, GYR_RANGE_64DPS };
+    enum GyroODR { GYR_ODR_896_8Hz = 3 };
+    enum LpfMode { LPF_MODE_0, LPF_MODE_1, LPF_MODE_2, LPF_MODE_3 };
+
+    bool begin(TwoWire&, uint8_t, int, int) {
+        if (qmi_model.nack) return false;
+        qmi_model.configured = true;
+        qmi_model.fifo.clear();
+        return true;
+    }
+    int configAccelerometer(AccelRange, AccelODR, LpfMode = LPF_MODE_0) { return 0; }
+    int configGyroscope(GyroRange, GyroODR, LpfMode = LPF_MODE_0) { return 0; }
+    bool enableGyroscope() { return true; }
+    bool enableAccelerometer() { return true; }
+    bool getDataReady() { return qmi_model.configured && !qmi_model.nack && qmi_model.data_ready; }
+};
@@ -0,0 +1,78 @@
+/*
+ * File: Wire.h (imu_replay host shim)
+ * Description: TwoWire stand-in backed by a QMI8658 register model that
+ *              serves the replayed samples (FIFO and burst registers).
+ * Author: zzackk125
+ * License: MIT
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <deque>
+#include <vector>
+
+#define QMI8658_MODEL_ADDR 0x6B
+
+struct QMIFrame {
+    int16_t raw[6];   // AX AY AZ GX GY GZ
+};
+
+// The register surface imu_driver.cpp touches directly
+class QMI8658Model {
+public:
+    std::deque<QMIFrame> fifo;   // Drained through FIFO_SMPL_CNT / FIFO_DATA
+    QMIFrame current = {};       // Served by the 0x30..0x40 burst
+    const uint8_t* burst = NULL; // Recorded 0x30..0x40 bytes served as is instead (register dumps)
+    uint32_t counter = 0;        // Samples produced (reported relative to the last power up)
+    bool data_ready = false;
+    bool overflow = false;
+    uint64_t bus_ns = 0;         // Host time spent inside the model
+    uint8_t regs[0x80] = {};     // Registers as last written (read back unless modelled)
+
+    // Fault injection (replay --fault)
+    bool configured = true;      // Cleared by powerLoss(), set again by SensorQMI8658::begin()
+    bool nack = false;           // Every transaction fails
+    bool flaky = false;          // Every 20th transaction fails
+    uint32_t transactions = 0;
+    bool stuck = false;          // Output frozen on stuck_frame
+    QMIFrame stuck_frame = {};
+    uint32_t counter_base = 0;
+
+    void push(const QMIFrame& f);      // New FIFO sample (dropped / frozen per faults)
+    void powerLoss();                  // Brown-out: config and FIFO gone, counter restarts
+    bool fails() { return nack || (flaky && ++transactions % 20 == 0); }
+    bool int2() const;                 // INT2 pin level: FIFO watermark / data-ready, as configured
+    void writeReg(uint8_t reg, const uint8_t* data, size_t len);
+    size_t readRegs(uint8_t reg, uint8_t* out, size_t len);
+
+private:
+    uint16_t fifo_words = 0;     // Latched by CTRL9 REQ_FIFO
+    std::vector<uint8_t> fifo_stream;
+    size_t fifo_pos = 0;
+};
+extern QMI8658Model qmi_model;
+
+class TwoWire {
+public:
+    bool begin(int, int, uint32_t = 0) { return true; }
+    bool setClock(uint32_t hz) { clock_hz = hz; return true; }
+    void beginTransmission(uint8_t addr);
+    size_t write(uint8_t b);
+    size_t write(const uint8_t* data, size_t len);
+    uint8_t endTransmission(bool stop = true);
+    size_t requestFrom(uint8_t addr, size_t len, bool stop = true);
+    int available() { return (int)(rx_len - rx_pos); }
+    int read() { return rx_pos < rx_len ? rx[rx_pos++] : -1; }
+
+    uint32_t clock_hz = 100000;   // Last setClock() (i2c_sim's latency model)
+
+private:
+    uint8_t addr = 0;
+    uint8_t tx[256];
+    size_t tx_len = 0;
+    uint8_t reg = 0;
+    uint8_t rx[256];
+    size_t rx_len = 0, rx_pos = 0;
+};
+extern TwoWire Wire;
@@ -0,0 +1,18 @@
+/*
+ * File: driver/gpio.h (imu_replay host shim)
+ * Description: GPIO numbers used by board_config.h
+ * Author: zzackk125
+ * License: MIT
+ */
+
+#pragma once
+
+#define GPIO_NUM_3  3
+#define GPIO_NUM_4  4
+#define GPIO_NUM_5  5
+#define GPIO_NUM_6  6
+#define GPIO_NUM_7  7
+#define GPIO_NUM_8  8
+#define GPIO_NUM_10 10
+#define GPIO_NUM_11 11
+#define GPIO_NUM_18 18
@@ -0,0 +1,16 @@
+/*
+ * File: esp_cpu.h (imu_replay host shim)
+ * Description: CPU cycle counter stand-in: host nanoseconds (1000 "MHz")
+ * Author: zzackk125
+ * License: MIT
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <chrono>
+
+inline uint32_t esp_cpu_get_cycle_count() {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
@@ -0,0 +1,45 @@
+/*
+ * File: freertos/FreeRTOS.h (imu_replay host shim)
+ * Description: Single-threaded FreeRTOS stand-ins for host replay
+ * Author: zzackk125
+ * License: MIT
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+typedef int BaseType_t;
+typedef uint32_t TickType_t;
+typedef void* TaskHandle_t;
+typedef void* SemaphoreHandle_t;
+
+#define pdTRUE  1
+#define pdFALSE 0
+#define portMAX_DELAY 0xFFFFFFFFu
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define portYIELD_FROM_ISR(x) ((void)(x))
+
+// Tools that run real tasks (imu_test, i2c_sim) install a cooperative
+// scheduler on the virtual clock here (../host_task.cpp). Without one the
+// stubs behave single-threaded: nothing blocks, nothing is contended.
+struct HostKernel {
+    TaskHandle_t (*current)();
+    BaseType_t (*create)(void (*fn)(void*), const char* name, void* arg, int prio, TaskHandle_t* handle);
+    void (*delay)(TickType_t ticks);
+    void (*delayUntil)(TickType_t* last_wake, TickType_t period);
+    uint32_t (*notifyTake)(BaseType_t clear, TickType_t ticks);
+    void (*notifyGive)(TaskHandle_t task);
+    SemaphoreHandle_t (*mutexCreate)();
+    BaseType_t (*mutexTake)(SemaphoreHandle_t m, TickType_t ticks);
+    BaseType_t (*mutexGive)(SemaphoreHandle_t m);
+};
+inline const HostKernel* host_kernel = nullptr;
+
+// Critical sections: nothing to exclude on a single host thread
+typedef int portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED 0
+#define portENTER_CRITICAL(m) ((void)(m))
+#define portEXIT_CRITICAL(m) ((void)(m))
+#define portENTER_CRITICAL_SAFE(m) ((void)(m))
+#define portEXIT_CRITICAL_SAFE(m) ((void)(m))
@@ -0,0 +1,48 @@
+/*
+ * File: freertos/queue.h (imu_replay host shim)
+ * Description: Queue stand-in. Single-threaded: never blocks, a full queue
+ *              fails the send and an empty one fails the receive at once.
+ *              Under host_kernel a blocked sender/receiver re-polls every tick.
+ * Author: zzackk125
+ * License: MIT
+ */
+
+#pragma once
+
+#include "FreeRTOS.h"
+#include <deque>
+#include <vector>
+#include <string.h>
+
+struct HostQueue {
+    size_t item_size;
+    size_t length;
+    std::deque<std::vector<uint8_t>> items;
+};
+typedef HostQueue* QueueHandle_t;
+
+inline QueueHandle_t xQueueCreate(size_t length, size_t item_size) {
+    return new HostQueue{ item_size, length, {} };
+}
+
+inline BaseType_t xQueueSend(QueueHandle_t q, const void* item, TickType_t ticks) {
+    for (TickType_t waited = 0; q->items.size() >= q->length && host_kernel && waited < ticks; waited++) {
+        host_kernel->delay(1);
+    }
+    if (q->items.size() >= q->length) return pdFALSE;
+    const uint8_t* p = (const uint8_t*)item;
+    q->items.emplace_back(p, p + q->item_size);
+    return pdTRUE;
+}
+
+inline BaseType_t xQueueReceive(QueueHandle_t q, void* item, TickType_t ticks) {
+    for (TickType_t waited = 0; q->items.empty() && host_kernel && waited < ticks; waited++) {
+        host_kernel->delay(1);
+    }
+    if (q->items.empty()) return pdFALSE;
+    memcpy(item, q->items.front().data(), q->item_size);
+    q->items.pop_front();
+    return pdTRUE;
+}
+
+inline uint32_t uxQueueMessagesWaiting(QueueHandle_t q) { return (uint32_t)q->items.size(); }
@@ -0,0 +1,23 @@
+/*
+ * File: freertos/semphr.h (imu_replay host shim)
+ * Description: Mutex stand-ins (replay is single-threaded, never contended;
+ *              host_kernel tools get real blocking mutexes)
+ * Author: zzackk125
+ * License: MIT
+ */
+
+#pragma once
+
+#include "FreeRTOS.h"
+
+inline SemaphoreHandle_t xSemaphoreCreateMutex() {
+    return host_kernel ? host_kernel->mutexCreate() : (SemaphoreHandle_t)1;
+}
+
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t m, TickType_t ticks) {
+    return host_kernel ? host_kernel->mutexTake(m, ticks) : pdTRUE;
+}
+
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t m) {
+    return host_kernel ? host_kernel->mutexGive(m) : pdTRUE;
+}
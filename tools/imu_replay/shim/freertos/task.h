@@ -0,0 +1,46 @@
+/*
+ * File: freertos/task.h (imu_replay host shim)
+ * Description: Task API stand-ins. The replay drives updateIMU() directly,
+ *              so no task is ever created; tools that install host_kernel
+ *              run them as coroutines.
+ * Author: zzackk125
+ * License: MIT
+ */
+
+#pragma once
+
+#include "FreeRTOS.h"
+
+uint32_t millis();
+
+inline TickType_t xTaskGetTickCount() { return millis(); }
+inline TaskHandle_t xTaskGetCurrentTaskHandle() { return host_kernel ? host_kernel->current() : (TaskHandle_t)1; }
+
+inline void vTaskDelay(TickType_t ticks) {
+    if (host_kernel) host_kernel->delay(ticks);
+}
+
+inline void vTaskDelayUntil(TickType_t* last_wake, TickType_t period) {
+    if (host_kernel) host_kernel->delayUntil(last_wake, period);
+}
+
+inline uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t ticks) {
+    return host_kernel ? host_kernel->notifyTake(clear, ticks) : 0;
+}
+
+inline void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* woken) {
+    if (!host_kernel) return;
+    host_kernel->notifyGive(task);
+    if (woken) *woken = pdTRUE;
+}
+
+inline BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+    if (host_kernel) host_kernel->notifyGive(task);
+    return pdTRUE;
+}
+
+inline BaseType_t xTaskCreate(void (*fn)(void*), const char* name, uint32_t, void* arg, int prio, TaskHandle_t* handle) {
+    if (host_kernel) return host_kernel->create(fn, name, arg, prio, handle);
+    if (handle) *handle = NULL;
+    return pdFALSE;
+}
@@ -0,0 +1,80 @@
+/*
+ * File: nvs.h (imu_replay host shim)
+ * Description: In-memory NVS API stand-in over the Preferences shim's store
+ *              (same "namespace/key" map), counting writes and commits.
+ * Author: zzackk125
+ * License: MIT
+ */
+
+#pragma once
+
+#include <Preferences.h>
+#include <string.h>
+
+typedef int esp_err_t;
+typedef uint32_t nvs_handle_t;
+typedef enum { NVS_READONLY, NVS_READWRITE } nvs_open_mode_t;
+
+#define ESP_OK                     0
+#define ESP_FAIL                   -1
+#define ESP_ERR_NVS_NOT_FOUND      0x1102
+#define ESP_ERR_NVS_INVALID_LENGTH 0x110c
+
+struct HostNvs {
+    std::vector<std::string> ns;   // Handle - 1
+    uint32_t sets = 0;
+    uint32_t commits = 0;
+    bool fail = false;             // Every call errors (fault injection)
+};
+inline HostNvs host_nvs;
+
+inline std::string hostNvsKey(nvs_handle_t h, const char* key) {
+    return host_nvs.ns[h - 1] + "/" + key;
+}
+
+inline esp_err_t nvs_open(const char* name, nvs_open_mode_t, nvs_handle_t* h) {
+    host_nvs.ns.push_back(name);
+    *h = (nvs_handle_t)host_nvs.ns.size();
+    return ESP_OK;
+}
+
+inline esp_err_t nvs_commit(nvs_handle_t) {
+    if (host_nvs.fail) return ESP_FAIL;
+    host_nvs.commits++;
+    return ESP_OK;
+}
+
+inline esp_err_t nvs_set_blob(nvs_handle_t h, const char* key, const void* v, size_t len) {
+    if (host_nvs.fail) return ESP_FAIL;
+    const uint8_t* p = (const uint8_t*)v;
+    Preferences::store[hostNvsKey(h, key)] = std::vector<uint8_t>(p, p + len);
+    host_nvs.sets++;
+    return ESP_OK;
+}
+
+inline esp_err_t nvs_get_blob(nvs_handle_t h, const char* key, void* out, size_t* len) {
+    auto it = Preferences::store.find(hostNvsKey(h, key));
+    if (host_nvs.fail || it == Preferences::store.end()) return ESP_ERR_NVS_NOT_FOUND;
+    if (out) {
+        if (*len < it->second.size()) return ESP_ERR_NVS_INVALID_LENGTH;
+        memcpy(out, it->second.data(), it->second.size());
+    }
+    *len = it->second.size();
+    return ESP_OK;
+}
+
+template <typename T> inline esp_err_t hostNvsGet(nvs_handle_t h, const char* key, T* v) {
+    size_t len = sizeof(T);
+    T tmp;
+    esp_err_t err = nvs_get_blob(h, key, &tmp, &len);
+    if (err == ESP_OK && len != sizeof(T)) return ESP_ERR_NVS_NOT_FOUND; // Stored as another type
+    if (err == ESP_OK) *v = tmp;
+    return err;
+}
+
+inline esp_err_t nvs_set_i32(nvs_handle_t h, const char* key, int32_t v) { return nvs_set_blob(h, key, &v, sizeof(v)); }
+inline esp_err_t nvs_set_u32(nvs_handle_t h, const char* key, uint32_t v) { return nvs_set_blob(h, key, &v, sizeof(v)); }
+inline esp_err_t nvs_set_u8(nvs_handle_t h, const char* key, uint8_t v) { return nvs_set_blob(h, key, &v, sizeof(v)); }
+inline esp_err_t nvs_get_i32(nvs_handle_t h, const char* key, int32_t* v) { return hostNvsGet(h, key, v); }
+inline esp_err_t nvs_get_u32(nvs_handle_t h, const char* key, uint32_t* v) { return hostNvsGet(h, key, v); }
+inline esp_err_t nvs_get_u8(nvs_handle_t h, const char* key, uint8_t* v) { return hostNvsGet(h, key, v); }
@@ -0,0 +1,16 @@
+/*
+ * File: esp_cpu.h (perf_sim host shim)
+ * Description: Virtual cycle counter, set by the test driver
+ * Author: zzackk125
+ * License: MIT
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+extern uint32_t host_cycles;
+
+inline uint32_t esp_cpu_get_cycle_count() {
+    return host_cycles;
+}
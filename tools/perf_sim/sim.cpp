@@ -0,0 +1,108 @@
+/*
+ * File: sim.cpp
+ * Description: Host Check of the Perf Counter Statistics
+ * Author: zzackk125
+ * License: MIT
+ *
+ * Feeds src/perf_counters.cpp known span distributions on a virtual cycle
+ * counter and compares each window's min / avg / max / p99 with the exact
+ * values from the sorted samples. Then times real begin/end pairs on the
+ * host's clock to show what the instrumentation itself costs per call.
+ */
+
+#include <Arduino.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include "perf_counters.h"
+
+// --- Host environment ---
+uint32_t host_cycles = 0;
+static uint32_t now_us = 0;
+uint32_t micros() { return now_us; }
+uint32_t millis() { return now_us / 1000; }
+void hostSetMicros(uint32_t us) { now_us = us; }
+HostSerial Serial;
+
+static uint32_t rng = 1;
+static uint32_t lcg() {
+    rng = rng * 1664525u + 1013904223u;
+    return rng >> 8;
+}
+
+struct Dist {
+    const char* name;
+    uint32_t (*gen)();
+};
+
+// Cycles at 160MHz
+static const Dist dists[] = {
+    { "constant 2400",         []() -> uint32_t { return 2400; } },
+    { "uniform 1000-9000",     []() -> uint32_t { return 1000 + lcg() % 8001; } },
+    { "1.5% tail at 80000",    []() -> uint32_t { return (lcg() % 1000 < 15) ? 80000 + lcg() % 4000 : 3000 + lcg() % 500; } },
+    { "0.5% tail at 80000",    []() -> uint32_t { return (lcg() % 1000 < 5) ? 80000 + lcg() % 4000 : 3000 + lcg() % 500; } },
+    { "exponential mean 5000", []() -> uint32_t { return (uint32_t)(-5000.0 * log((lcg() + 1) / 16777217.0)); } },
+    { "tiny 0-3",              []() -> uint32_t { return lcg() % 4; } },
+};
+
+int main() {
+    Serial.enabled = false;
+    perfInit();
+
+    int failures = 0;
+    printf("  %-22s %7s %9s %9s %9s %9s %9s\n", "distribution", "count", "min", "avg", "max", "p99", "exact p99");
+    for (const Dist& d : dists) {
+        std::vector<uint32_t> v;
+        for (int i = 0; i < 3000; i++) {
+            uint32_t c = d.gen();
+            v.push_back(c);
+            host_cycles += 12345;                  // Any start point: spans are differences
+            perfEnd(PERF_IMU_UPDATE, host_cycles - c);
+        }
+        now_us += PERF_WINDOW_MS * 1000;
+        perfRollWindow();
+
+        PerfSnapshot s;
+        getPerfSnapshot(&s);
+        const PerfStat& st = s.stat[PERF_IMU_UPDATE];
+        std::sort(v.begin(), v.end());
+        uint64_t sum = 0;
+        for (uint32_t c : v) sum += c;
+        uint32_t exact = v[v.size() - v.size() / 100 - 1];
+
+        printf("  %-22s %7u %9u %9u %9u %9u %9u\n", d.name, (unsigned)st.count, (unsigned)st.min,
+               (unsigned)st.avg, (unsigned)st.max, (unsigned)st.p99, (unsigned)exact);
+        bool ok = st.count == v.size() && st.min == v.front() && st.max == v.back() &&
+                  st.avg == (uint32_t)(sum / v.size()) && st.p99 >= exact && st.p99 <= exact + exact / 4 + 1;
+        for (int i = 0; i < PERF_COUNT; i++) {
+            if (i != PERF_IMU_UPDATE && s.stat[i].count) ok = false; // Other counters untouched
+        }
+        if (!ok) {
+            printf("    FAIL\n");
+            failures++;
+        }
+    }
+
+    // A window with nothing in it reports zeros, not UINT32_MAX
+    now_us += PERF_WINDOW_MS * 1000;
+    perfRollWindow();
+    PerfSnapshot s;
+    getPerfSnapshot(&s);
+    if (s.stat[PERF_IMU_UPDATE].count || s.stat[PERF_IMU_UPDATE].min || s.stat[PERF_IMU_UPDATE].p99) {
+        printf("  empty window: FAIL\n");
+        failures++;
+    }
+
+    // Instrumentation cost on this host (the device measures its own in perfInit())
+    const int n = 1000000;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; i++) {
+        host_cycles += 7;
+        perfEnd(PERF_WEB, perfBegin());
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / n;
+    printf("\nbegin/end pair: %.1f ns on this host\n", ns);
+
+    printf("%s\n", failures ? "FAIL" : "OK");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,193 @@
+/*
+ * File: sim.cpp
+ * Description: Host Test Drive of the Persistence Service
+ * Author: zzackk125
+ * License: MIT
+ *
+ * Runs src/persist.cpp against the in-memory NVS stand-in (imu_replay's
+ * nvs.h shim, which counts writes and commits) on a virtual clock. Each
+ * scenario replays a write pattern from the firmware and compares the
+ * commits with what the old direct Preferences calls cost (one commit per
+ * put), then reads the values back.
+ */
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include <nvs.h>
+#include "persist.h"
+#include "board_config.h"
+
+// --- Host environment ---
+static uint64_t now_us = 0;
+uint32_t micros() { return (uint32_t)now_us; }
+uint32_t millis() { return (uint32_t)(now_us / 1000); }
+void hostSetMicros(uint32_t us) { now_us = us; }
+HostSerial Serial;
+std::map<std::string, std::vector<uint8_t>> Preferences::store;
+
+// The persistence task, woken every millisecond
+static void run(uint32_t ms) {
+    for (uint32_t i = 0; i < ms; i++) {
+        now_us += 1000;
+        persistService(false);
+    }
+}
+
+// --- Scenarios ---
+struct Scenario {
+    const char* name;
+    void (*fn)();
+    uint32_t max_commits;     // Pass limit
+};
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    if (!ok) {
+        printf("    FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+// Web slider dragged for 3s: setSmoothing() on every change
+static void sliderStorm() {
+    for (int i = 1; i <= 60; i++) {
+        persistPutInt(PERSIST_IMU, "smooth", i);
+        run(50);
+    }
+    run(PERSIST_COMMIT_MS);
+    check(persistGetInt(PERSIST_IMU, "smooth", 0) == 60, "last slider value stored");
+}
+
+// updateUI(): four all-time maxima every 5s for a minute
+static void maxAngles() {
+    for (int i = 0; i < 12; i++) {
+        persistPutFloat(PERSIST_UI, "m_rl", -1.0f - i);
+        persistPutFloat(PERSIST_UI, "m_rr", 1.0f + i);
+        persistPutFloat(PERSIST_UI, "m_pf", -0.5f - i);
+        persistPutFloat(PERSIST_UI, "m_pb", 0.5f + i);
+        run(5000);
+    }
+    check(persistGetFloat(PERSIST_UI, "m_rr", 0) == 12.0f, "all-time max stored");
+}
+
+// Calibration: offsets plus the warm start snapshot
+static void calibration() {
+    int32_t bias[3] = { 120, -45, 7 };
+    persistPutFloat(PERSIST_IMU, "roll_off", 1.25f);
+    persistPutFloat(PERSIST_IMU, "pitch_off", -0.75f);
+    persistPutBytes(PERSIST_IMU, "ws_bias", bias, sizeof(bias));
+    persistPutFloat(PERSIST_IMU, "ws_roll", 2.5f);
+    persistPutFloat(PERSIST_IMU, "ws_pitch", -3.5f);
+    persistPutUInt(PERSIST_IMU, "ws_boot", 42);
+    run(PERSIST_COMMIT_MS + 10);
+
+    int32_t back[3] = {0};
+    check(persistGetBytes(PERSIST_IMU, "ws_bias", back, sizeof(back)) == sizeof(back) &&
+          memcmp(back, bias, sizeof(bias)) == 0, "bias blob read back");
+    check(persistGetBytes(PERSIST_IMU, "ws_bias", back, sizeof(back) - 4) == 0, "blob size mismatch rejected");
+    check(persistGetUInt(PERSIST_IMU, "ws_boot", 0) == 42, "boot stamp read back");
+    check(persistGetFloat(PERSIST_IMU, "pitch_off", 0) == -0.75f, "offset read back");
+}
+
+// Settings page save: every namespace in one window
+static void settingsPage() {
+    persistPutInt(PERSIST_UI, "crit_r", 35);
+    persistPutInt(PERSIST_UI, "crit_p", 40);
+    persistPutBool(PERSIST_UI, "p_shift", false);
+    persistPutInt(PERSIST_UI, "color", 3);
+    persistPutInt(PERSIST_IMU, "mode", 2);
+    persistPutInt(PERSIST_WEB, "to", 120);
+    run(PERSIST_COMMIT_MS + 10);
+    check(persistGetBool(PERSIST_UI, "p_shift", true) == false, "bool read back");
+    check(persistGetInt(PERSIST_WEB, "to", 0) == 120, "web namespace read back");
+}
+
+// resetSettings(): writes, then a sync right before the restart
+static void syncBeforeReboot() {
+    persistPutInt(PERSIST_UI, "crit_r", 50);
+    persistPutInt(PERSIST_UI, "crit_p", 50);
+    persistPutInt(PERSIST_UI, "color", 0);
+    uint32_t before = millis();
+    check(persistSync(1000), "sync completes");
+    check(millis() == before, "sync doesn't wait for the batch window");
+    check(persistGetInt(PERSIST_UI, "color", -1) == 0, "synced value stored");
+}
+
+// Writers outrunning the task: the queue fills, the newest value per key is
+// held aside and still lands, after (not before) the older queued ones
+static void queueOverflow() {
+    for (int i = 0; i < PERSIST_QUEUE_LEN + 8; i++) {
+        persistPutInt(PERSIST_IMU, "smooth", i);
+        if (i % 4 == 3) persistPutInt(PERSIST_UI, "crit_r", i);
+    }
+    PersistStats ps;
+    getPersistStats(&ps);
+    check(ps.dropped == 0, "nothing dropped");
+    run(PERSIST_COMMIT_MS + 10);
+    check(persistGetInt(PERSIST_IMU, "smooth", -1) == PERSIST_QUEUE_LEN + 7, "newest value stored");
+    check(persistGetInt(PERSIST_UI, "crit_r", -1) == PERSIST_QUEUE_LEN + 7, "newest value of the other key stored");
+}
+
+// Flash errors are counted, not fatal
+static void flashErrors() {
+    host_nvs.fail = true;
+    persistPutInt(PERSIST_WEB, "to", 10);
+    run(PERSIST_COMMIT_MS + 10);
+    host_nvs.fail = false;
+    PersistStats ps;
+    getPersistStats(&ps);
+    check(ps.errors >= 1 && ps.pending == 0, "error counted, batch released");
+}
+
+static const Scenario scenarios[] = {
+    { "slider storm (60 x smooth)", sliderStorm, 2 },
+    { "max angles (12 x 4 floats)", maxAngles, 12 },
+    { "calibration + warm start", calibration, 1 },
+    { "settings page (3 namespaces)", settingsPage, 3 },
+    { "sync before reboot", syncBeforeReboot, 1 },
+    { "queue overflow (50 intents)", queueOverflow, 2 },
+    { "flash errors", flashErrors, 0 },
+};
+
+int main(int argc, char** argv) {
+    if (argc > 1 && !strcmp(argv[1], "--verbose")) Serial.enabled = true;
+    else Serial.enabled = false;
+
+    // Values written by the old Preferences code must still load
+    {
+        Preferences p;
+        p.begin("ui", false);
+        p.putFloat("m_pb", 4.5f);
+        p.putInt("rot", 270);
+    }
+    initPersist();
+    check(persistGetFloat(PERSIST_UI, "m_pb", 0) == 4.5f, "Preferences float loads");
+    check(persistGetInt(PERSIST_UI, "rot", 0) == 270, "Preferences int loads");
+    check(persistGetInt(PERSIST_UI, "missing", -7) == -7, "default for a missing key");
+
+    printf("batch window %ums, queue %u, %u keys per batch\n\n", PERSIST_COMMIT_MS, PERSIST_QUEUE_LEN,
+           PERSIST_MAX_PENDING);
+    printf("  %-30s %8s %10s %8s %8s %12s\n", "scenario", "intents", "coalesced", "keys", "commits", "old commits");
+    for (const Scenario& sc : scenarios) {
+        PersistStats a, b;
+        getPersistStats(&a);
+        uint32_t commits0 = host_nvs.commits;
+        sc.fn();
+        getPersistStats(&b);
+        uint32_t commits = host_nvs.commits - commits0;
+        printf("  %-30s %8u %10u %8u %8u %12u\n", sc.name, (unsigned)(b.intents - a.intents),
+               (unsigned)(b.coalesced - a.coalesced), (unsigned)(b.keys_written - a.keys_written),
+               (unsigned)commits, (unsigned)(b.intents - a.intents));
+        check(commits == b.commits - a.commits, "service commit count matches the NVS");
+        check(commits <= sc.max_commits, "commits within the scenario's limit");
+    }
+
+    PersistStats ps;
+    getPersistStats(&ps);
+    printf("\nTotal: %u intents, %u coalesced, %u dropped, %u keys in %u commits, %u errors\n",
+           (unsigned)ps.intents, (unsigned)ps.coalesced, (unsigned)ps.dropped, (unsigned)ps.keys_written,
+           (unsigned)ps.commits, (unsigned)ps.errors);
+    printf("%s\n", failures ? "FAIL" : "OK");
+    return failures ? 1 : 0;
+}
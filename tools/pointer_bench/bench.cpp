@@ -0,0 +1,263 @@
+/*
+ * File: bench.cpp
+ * Description: Host Render Benchmark of the Pointer Atlas
+ * Author: zzackk125
+ * License: MIT
+ *
+ * Draws one gauge pointer into an RGB565 draw buffer chunk the two ways
+ * updateUI() can ask LVGL to, following what LVGL's software renderer does:
+ *
+ *   rotated   img_pointer (20x30 ARGB8888) with a rotation: bilinear
+ *             transform of the bounding box into a temporary ARGB8888
+ *             buffer, recolor pass, then an alpha blend into the chunk
+ *   atlas     the pre-rotated img_pointer_atlas frame (38x38 A8): the
+ *             recolor blended through the frame as a mask
+ *
+ * Both are timed over the roll gauge's range. Every atlas frame is first
+ * checked against the transformed pointer: same coverage, same centroid.
+ */
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+extern "C" {
+#include "img_pointer.h"
+#include "img_pointer_atlas.h"
+}
+#include "board_config.h"
+
+static const int PIVOT_X = 10, PIVOT_Y = 15;  // lv_image_set_pivot() of img_pointer
+static const uint32_t RECOLOR = 0xFF3D00;     // POINTER_COLOR in ui.cpp
+
+struct Chunk {
+    std::vector<uint16_t> px;
+    int w, h;
+};
+
+struct Area {
+    int x1, y1, x2, y2;
+};
+
+static inline uint16_t to565(uint32_t rgb) {
+    return (uint16_t)(((rgb >> 8) & 0xF800) | ((rgb >> 5) & 0x07E0) | ((rgb >> 3) & 0x001F));
+}
+
+// lv_color_mix() on RGB565: a = weight of fg
+static inline uint16_t mix565(uint16_t fg, uint16_t bg, uint32_t a) {
+    uint32_t r = (((fg >> 11) * a) + ((bg >> 11) * (255 - a))) >> 8;
+    uint32_t g = ((((fg >> 5) & 0x3F) * a) + (((bg >> 5) & 0x3F) * (255 - a))) >> 8;
+    uint32_t b = (((fg & 0x1F) * a) + ((bg & 0x1F) * (255 - a))) >> 8;
+    return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+// Screen area the rotated pointer covers (lv_image_buf_get_transformed_area)
+static Area rotatedArea(int px, int py, float deg) {
+    float c = cosf(deg * (float)M_PI / 180), s = sinf(deg * (float)M_PI / 180);
+    const float cx[4] = { 0, 20, 20, 0 }, cy[4] = { 0, 0, 30, 30 };
+    float x1 = 1e9f, y1 = 1e9f, x2 = -1e9f, y2 = -1e9f;
+    for (int i = 0; i < 4; i++) {
+        float dx = cx[i] - PIVOT_X, dy = cy[i] - PIVOT_Y;
+        float x = dx * c - dy * s, y = dx * s + dy * c;
+        x1 = fminf(x1, x); x2 = fmaxf(x2, x);
+        y1 = fminf(y1, y); y2 = fmaxf(y2, y);
+    }
+    return { px + (int)floorf(x1), py + (int)floorf(y1), px + (int)ceilf(x2), py + (int)ceilf(y2) };
+}
+
+// --- rotated: transform, recolor, blend ---
+static uint8_t tmp_argb[64 * 64 * 4];
+
+__attribute__((noinline)) static void transformArgb(const Area& a, int px, int py, float deg) {
+    const uint8_t* src = img_pointer.data;
+    const int sw = img_pointer.header.w, sh = img_pointer.header.h;
+    // Source step per destination pixel, 8 fractional bits (as LVGL's transform)
+    int32_t c = (int32_t)lroundf(cosf(deg * (float)M_PI / 180) * 256);
+    int32_t s = (int32_t)lroundf(sinf(deg * (float)M_PI / 180) * 256);
+    int w = a.x2 - a.x1 + 1;
+    for (int y = a.y1; y <= a.y2; y++) {
+        int32_t dx = a.x1 - px, dy = y - py;
+        int32_t xs = dx * c + dy * s + (PIVOT_X << 8);
+        int32_t ys = -dx * s + dy * c + (PIVOT_Y << 8);
+        uint8_t* out = tmp_argb + (size_t)(y - a.y1) * w * 4;
+        for (int x = 0; x < w; x++, xs += c, ys -= s, out += 4) {
+            int32_t xi = xs >> 8, yi = ys >> 8, xf = xs & 0xFF, yf = ys & 0xFF;
+            uint32_t acc[4] = { 0, 0, 0, 0 };
+            bool any = false;
+            for (int k = 0; k < 4; k++) {
+                int sx = xi + (k & 1), sy = yi + (k >> 1);
+                if (sx < 0 || sy < 0 || sx >= sw || sy >= sh) continue;
+                uint32_t wgt = ((k & 1) ? xf : 256 - xf) * ((k >> 1) ? yf : 256 - yf);
+                const uint8_t* p = src + ((size_t)sy * sw + sx) * 4;
+                for (int ch = 0; ch < 4; ch++) acc[ch] += p[ch] * wgt;
+                any = true;
+            }
+            if (!any) {
+                out[3] = 0;
+                continue;
+            }
+            for (int ch = 0; ch < 4; ch++) out[ch] = (uint8_t)(acc[ch] >> 16);
+        }
+    }
+}
+
+__attribute__((noinline)) static void recolorArgb(const Area& a, uint32_t rgb) {
+    int n = (a.x2 - a.x1 + 1) * (a.y2 - a.y1 + 1);
+    uint8_t b = rgb & 0xFF, g = (rgb >> 8) & 0xFF, r = (rgb >> 16) & 0xFF;
+    for (int i = 0; i < n; i++) {
+        uint8_t* p = tmp_argb + i * 4;
+        // LV_OPA_COVER: the mix still runs, with the recolor at full weight
+        p[0] = (uint8_t)((b * 255 + p[0] * 0) >> 8);
+        p[1] = (uint8_t)((g * 255 + p[1] * 0) >> 8);
+        p[2] = (uint8_t)((r * 255 + p[2] * 0) >> 8);
+    }
+}
+
+__attribute__((noinline)) static void blendArgb(Chunk& dst, const Area& a) {
+    int w = a.x2 - a.x1 + 1;
+    for (int y = a.y1; y <= a.y2; y++) {
+        if (y < 0 || y >= dst.h) continue;
+        const uint8_t* p = tmp_argb + (size_t)(y - a.y1) * w * 4;
+        uint16_t* row = dst.px.data() + (size_t)y * dst.w;
+        for (int x = a.x1; x <= a.x2; x++, p += 4) {
+            if (x < 0 || x >= dst.w || p[3] == 0) continue;
+            uint16_t c = (uint16_t)(((p[2] & 0xF8) << 8) | ((p[1] & 0xFC) << 3) | (p[0] >> 3));
+            row[x] = p[3] == 255 ? c : mix565(c, row[x], p[3]);
+        }
+    }
+}
+
+static void drawRotated(Chunk& dst, int px, int py, float deg) {
+    Area a = rotatedArea(px, py, deg);
+    transformArgb(a, px, py, deg);
+    recolorArgb(a, RECOLOR);
+    blendArgb(dst, a);
+}
+
+// --- atlas: one masked fill ---
+__attribute__((noinline)) static void blendA8(Chunk& dst, const lv_image_dsc_t* frame, int x0, int y0, uint16_t color) {
+    const int fw = frame->header.w, fh = frame->header.h;
+    for (int fy = 0; fy < fh; fy++) {
+        int y = y0 + fy;
+        if (y < 0 || y >= dst.h) continue;
+        const uint8_t* m = frame->data + (size_t)fy * fw;
+        uint16_t* row = dst.px.data() + (size_t)y * dst.w;
+        for (int fx = 0; fx < fw; fx++) {
+            int x = x0 + fx;
+            if (x < 0 || x >= dst.w || m[fx] == 0) continue;
+            row[x] = m[fx] == 255 ? color : mix565(color, row[x], m[fx]);
+        }
+    }
+}
+
+// set_pointer() in ui.cpp: roll range, rotation 270 - roll
+static const lv_image_dsc_t* atlasFrame(float deg) {
+    int k = (int)lroundf((deg - POINTER_ATLAS_CENTRE_0) / POINTER_ATLAS_STEP);
+    if (k < -POINTER_ATLAS_HALF || k > POINTER_ATLAS_HALF) return NULL;
+    return &img_pointer_atlas[k + POINTER_ATLAS_HALF];
+}
+
+static void drawAtlas(Chunk& dst, int px, int py, float deg) {
+    const lv_image_dsc_t* f = atlasFrame(deg);
+    blendA8(dst, f, px - POINTER_ATLAS_FRAME / 2, py - POINTER_ATLAS_FRAME / 2, to565(RECOLOR));
+}
+
+// --- Check: each frame against the transformed pointer ---
+struct Moments {
+    double sum, cx, cy;
+};
+
+static Moments momentsOf(const uint8_t* alpha, int stride, int w, int h, int bpp) {
+    Moments m = { 0, 0, 0 };
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            double a = alpha[((size_t)y * stride + x) * bpp] / 255.0;
+            m.sum += a;
+            m.cx += a * x;
+            m.cy += a * y;
+        }
+    }
+    if (m.sum > 0) {
+        m.cx /= m.sum;
+        m.cy /= m.sum;
+    }
+    return m;
+}
+
+static bool checkAtlas() {
+    const int half = POINTER_ATLAS_FRAME / 2;
+    const double area = 20.0 * 30.0 / 2;
+    const int centres[2] = { POINTER_ATLAS_CENTRE_0, POINTER_ATLAS_CENTRE_1 };
+    double worst_shift = 0, worst_cover = 0;
+    for (int r = 0; r < 2; r++) {
+        for (int k = -POINTER_ATLAS_HALF; k <= POINTER_ATLAS_HALF; k++) {
+            float deg = (float)(centres[r] + k * POINTER_ATLAS_STEP);
+            const lv_image_dsc_t* f = &img_pointer_atlas[r * POINTER_ATLAS_RANGE + k + POINTER_ATLAS_HALF];
+            if (f->header.cf != LV_COLOR_FORMAT_A8 || f->header.w != POINTER_ATLAS_FRAME ||
+                f->data_size != POINTER_ATLAS_FRAME * POINTER_ATLAS_FRAME) {
+                printf("BAD FRAME: %g deg\n", deg);
+                return false;
+            }
+            // Transformed pointer over the frame's footprint, pivot at its centre
+            Area a = { 0, 0, POINTER_ATLAS_FRAME - 1, POINTER_ATLAS_FRAME - 1 };
+            transformArgb(a, half, half, deg);
+            Moments ref = momentsOf(tmp_argb + 3, POINTER_ATLAS_FRAME, POINTER_ATLAS_FRAME, POINTER_ATLAS_FRAME, 4);
+            Moments got = momentsOf(f->data, POINTER_ATLAS_FRAME, POINTER_ATLAS_FRAME, POINTER_ATLAS_FRAME, 1);
+            double shift = hypot(got.cx - ref.cx, got.cy - ref.cy);
+            double cover = fabs(got.sum - area) / area;
+            if (shift > worst_shift) worst_shift = shift;
+            if (cover > worst_cover) worst_cover = cover;
+            if (shift > 1.0 || cover > 0.1) {
+                printf("MISMATCH: %g deg, centroid off by %.2f px, coverage off by %.1f%%\n", deg, shift,
+                       cover * 100);
+                return false;
+            }
+        }
+    }
+    printf("%d frames checked: centroid within %.2f px, coverage within %.1f%% of the transformed pointer\n",
+           2 * POINTER_ATLAS_RANGE, worst_shift, worst_cover * 100);
+    return true;
+}
+
+int main() {
+    if (!checkAtlas()) return 1;
+
+    // A roll pointer inside one draw buffer chunk
+    Chunk chunk = { std::vector<uint16_t>(LCD_H_RES * LVGL_BUF_HEIGHT, 0x18E3), LCD_H_RES, LVGL_BUF_HEIGHT };
+    const int px = 40, py = LVGL_BUF_HEIGHT / 2;
+
+    std::vector<float> angles;
+    for (float roll = -45; roll <= 45; roll += 0.25f) angles.push_back(270 - roll);
+
+    struct Path {
+        const char* name;
+        void (*draw)(Chunk&, int, int, float);
+    };
+    const Path paths[] = {
+        { "rotated (ARGB8888 transform)", drawRotated },
+        { "atlas (A8 frame)", drawAtlas },
+    };
+
+    const int reps = 200;
+    double ns[2];
+    printf("\n%u angles over +/-45 deg, %d passes, chunk %ux%u\n\n", (unsigned)angles.size(), reps, LCD_H_RES,
+           LVGL_BUF_HEIGHT);
+    printf("  %-30s %14s\n", "pointer draw", "ns / pointer");
+    for (int i = 0; i < 2; i++) {
+        for (float a : angles) paths[i].draw(chunk, px, py, a); // Warm up
+        auto t0 = std::chrono::steady_clock::now();
+        for (int r = 0; r < reps; r++) {
+            for (float a : angles) paths[i].draw(chunk, px, py, a);
+        }
+        double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        ns[i] = s * 1e9 / ((double)reps * angles.size());
+        printf("  %-30s %14.1f\n", paths[i].name, ns[i]);
+    }
+    printf("\natlas is %.1fx faster; %u bytes of A8 frames vs %u bytes of ARGB8888 pointer\n", ns[0] / ns[1],
+           (unsigned)(2 * POINTER_ATLAS_RANGE * POINTER_ATLAS_FRAME * POINTER_ATLAS_FRAME),
+           (unsigned)img_pointer.data_size);
+    return 0;
+}
@@ -0,0 +1,44 @@
+/*
+ * File: lvgl.h
+ * Description: Host Stand-in for the LVGL Image Types
+ * Author: zzackk125
+ * License: MIT
+ *
+ * Just enough for the generated src/img_*.c files and src/truck_cache.cpp
+ * to compile on the host.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#define LV_IMAGE_HEADER_MAGIC 0x19
+
+enum {
+    LV_COLOR_FORMAT_A8 = 0x0E,
+    LV_COLOR_FORMAT_ARGB8888 = 0x10,
+    LV_COLOR_FORMAT_RGB565 = 0x12,
+    LV_COLOR_FORMAT_RGB565A8 = 0x14,
+    LV_COLOR_FORMAT_RGB565_SWAPPED = 0x1B,
+};
+
+typedef struct {
+    uint32_t magic : 8;
+    uint32_t cf : 8;
+    uint32_t flags : 16;
+    uint32_t w : 16;
+    uint32_t h : 16;
+    uint32_t stride : 16;
+    uint32_t reserved_2 : 16;
+} lv_image_header_t;
+
+typedef struct {
+    lv_image_header_t header;
+    uint32_t data_size;
+    const uint8_t* data;
+} lv_image_dsc_t;
+
+// No decoded image cache on the host
+static inline void lv_image_cache_drop(const void* src) {
+    (void)src;
+}
@@ -0,0 +1,276 @@
+/*
+ * File: sim.cpp
+ * Description: Host Simulation of the Arduino Loop Scheduler
+ * Author: zzackk125
+ * License: MIT
+ *
+ * Runs src/loop_sched.cpp on a virtual clock against a cost model of the
+ * loop's jobs and of the higher priority tasks that preempt it (IMU drain,
+ * LVGL render), then does the same for the old fixed delay(20) loop and
+ * reports achieved rates, start-interval jitter and CPU use for both.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "loop_sched.h"
+#include "board_config.h"
+
+// --- Virtual time ---
+static uint32_t now_us;
+static uint32_t t0_us;
+static uint32_t tick_phase_us;   // FreeRTOS tick edges vs micros()
+
+static uint32_t rng_state = 1;
+static uint32_t rnd() {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static uint32_t hashRange(uint32_t k, uint32_t lo, uint32_t hi) {
+    uint32_t h = k * 2654435761u;
+    h ^= h >> 15;
+    h *= 2246822519u;
+    h ^= h >> 13;
+    return lo + h % (hi - lo + 1);
+}
+
+static uint32_t elapsed() {
+    return now_us - t0_us;
+}
+
+// Higher priority tasks: IMU drain every FIFO watermark, LVGL render at its
+// refresh period. The loop (priority 1) only runs outside these windows.
+#define IMU_BUSY_PERIOD_US   (IMU_FIFO_WATERMARK * IMU_SAMPLE_PERIOD_US)
+#define IMU_BUSY_US          350
+#define LVGL_BUSY_PERIOD_US  33000
+#define LVGL_BUSY_MIN_US     2000
+#define LVGL_BUSY_MAX_US     10000
+
+// End of the busy window covering t (t if the CPU is free for the loop)
+static uint32_t freeAt(uint32_t t) {
+    for (;;) {
+        uint32_t e = t - t0_us, end = e;
+        uint32_t k = e / IMU_BUSY_PERIOD_US, off = e % IMU_BUSY_PERIOD_US;
+        if (off < IMU_BUSY_US) end = k * IMU_BUSY_PERIOD_US + IMU_BUSY_US;
+        k = e / LVGL_BUSY_PERIOD_US;
+        off = e % LVGL_BUSY_PERIOD_US;
+        uint32_t lv = hashRange(k, LVGL_BUSY_MIN_US, LVGL_BUSY_MAX_US);
+        if (off < lv && k * LVGL_BUSY_PERIOD_US + lv > end) end = k * LVGL_BUSY_PERIOD_US + lv;
+        if (end == e) return t;
+        t = t0_us + end;
+    }
+}
+
+// Run the loop for cpu_us of CPU time, preempted where busy
+static void cpu(uint32_t cpu_us) {
+    now_us = freeAt(now_us);
+    while (cpu_us > 0) {
+        uint32_t step = cpu_us < 50 ? cpu_us : 50;
+        now_us += step;
+        cpu_us -= step;
+        now_us = freeAt(now_us);
+    }
+}
+
+// vTaskDelay(ms): wake on a tick edge, then wait for the CPU
+static uint32_t wakeups;
+static void sleepMs(uint32_t ms) {
+    uint32_t e = now_us - t0_us + tick_phase_us;
+    uint32_t wake = (e / 1000 + ms) * 1000;
+    now_us = t0_us + wake - tick_phase_us;
+    now_us = freeAt(now_us);
+    wakeups++;
+}
+
+static uint32_t simClock() {
+    return now_us;
+}
+
+// --- Job cost model ---
+static bool ap_mode = false;
+static bool recording = false;
+
+static uint32_t costUI() {
+    return 300 + rnd() % 500; // Attitude copy + widget updates (LVGL renders later)
+}
+
+static uint32_t next_request_us = 0;
+static uint32_t costWeb() {
+    if (!ap_mode) return 5;
+    if (elapsed() >= next_request_us) {
+        next_request_us = elapsed() + 800000 + rnd() % 400000; // Stats page polling
+        return 15000 + rnd() % 15000;
+    }
+    return 150;
+}
+
+static uint32_t rec_flushed_us = 0;
+static uint32_t costRecorder() {
+    if (!recording) return 5;
+    if (elapsed() - rec_flushed_us >= 450000) { // 4KB buffer full
+        rec_flushed_us += 450000;
+        return 12000 + rnd() % 25000;
+    }
+    return 10;
+}
+
+static uint32_t next_save_us = 0;
+static uint32_t costPersist() {
+    if (elapsed() >= next_save_us) {
+        next_save_us = elapsed() + 7000000; // Calibration / warm start intents (persist.h writes the flash)
+        return 60;
+    }
+    return 5;
+}
+
+// --- Measured jobs ---
+struct SimJob {
+    const char* name;
+    uint32_t period_ms;
+    uint8_t flags;
+    uint32_t (*cost)();
+
+    // Start intervals
+    uint32_t n;
+    uint32_t last_us;
+    double sum, sum_sq;
+    uint32_t max_dev_us;
+    uint64_t exec_us;
+};
+
+static SimJob sim_jobs[] = {
+    { "ui",       LOOP_UI_PERIOD_MS,       0,          costUI },
+    { "web",      LOOP_WEB_PERIOD_MS,      0,          costWeb },
+    { "recorder", LOOP_RECORDER_PERIOD_MS, 0,          costRecorder },
+    { "persist",  LOOP_PERSIST_PERIOD_MS,  SCHED_IDLE, costPersist },
+};
+#define SIM_JOBS ((int)(sizeof(sim_jobs) / sizeof(sim_jobs[0])))
+
+static uint32_t nominal_us[SIM_JOBS]; // Interval the jitter is measured against
+
+static void runSim(int i) {
+    SimJob* j = &sim_jobs[i];
+    uint32_t start = now_us;
+    if (j->n > 0 || j->last_us) {
+        uint32_t iv = start - j->last_us;
+        j->sum += iv;
+        j->sum_sq += (double)iv * iv;
+        uint32_t dev = iv > nominal_us[i] ? iv - nominal_us[i] : nominal_us[i] - iv;
+        if (dev > j->max_dev_us) j->max_dev_us = dev;
+        j->n++;
+    }
+    j->last_us = start ? start : 1;
+    cpu(j->cost());
+    j->exec_us += now_us - start;
+}
+
+template <int I> static void jobFn() {
+    runSim(I);
+}
+static const SchedFn job_fns[] = { jobFn<0>, jobFn<1>, jobFn<2>, jobFn<3> };
+
+// --- Runs ---
+static void reset(uint32_t seed) {
+    rng_state = seed ? seed : 1;
+    t0_us = now_us = 0xFFFFFFFFu - 2000000; // micros() wraps 2s in
+    tick_phase_us = rnd() % 1000;
+    wakeups = 0;
+    next_request_us = next_save_us = 0;
+    rec_flushed_us = 0;
+    for (int i = 0; i < SIM_JOBS; i++) {
+        SimJob* j = &sim_jobs[i];
+        j->n = j->last_us = j->max_dev_us = 0;
+        j->sum = j->sum_sq = 0;
+        j->exec_us = 0;
+    }
+}
+
+static void report(const char* title, double seconds, const SchedJob* sj) {
+    printf("\n%s\n", title);
+    printf("  %-9s %7s %9s %10s %10s %9s %9s\n", "job", "want Hz", "got Hz", "jitter sd", "jitter max", "cpu %", "overruns");
+    for (int i = 0; i < SIM_JOBS; i++) {
+        const SimJob* j = &sim_jobs[i];
+        double mean = j->n ? j->sum / j->n : 0;
+        double var = j->n ? j->sum_sq / j->n - mean * mean : 0;
+        char over[16] = "-";
+        if (sj) snprintf(over, sizeof(over), "%u", (unsigned)sj[i].overruns);
+        printf("  %-9s %7.1f %9.1f %8.2fms %8.2fms %8.2f%% %9s\n", j->name, 1000.0 / j->period_ms,
+               (j->n + 1) / seconds, sqrt(var > 0 ? var : 0) / 1000.0, j->max_dev_us / 1000.0,
+               100.0 * j->exec_us / (seconds * 1e6), over);
+    }
+    printf("  loop wakeups %.1f/s\n", wakeups / seconds);
+}
+
+static void runFixed(double seconds, uint32_t seed) {
+    reset(seed);
+    // Everything every pass: the old loop's rate is 1 / (20ms + pass time)
+    for (int i = 0; i < SIM_JOBS; i++) nominal_us[i] = 20000;
+    while (elapsed() < seconds * 1e6) {
+        runSim(0); // ui
+        runSim(1); // web
+        runSim(3); // persist
+        runSim(2); // recorder
+        sleepMs(20);
+    }
+    report("fixed delay(20) loop", seconds, NULL);
+}
+
+static void runSched(double seconds, uint32_t seed) {
+    reset(seed);
+    SchedJob jobs[SIM_JOBS];
+    memset(jobs, 0, sizeof(jobs));
+    for (int i = 0; i < SIM_JOBS; i++) {
+        jobs[i].name = sim_jobs[i].name;
+        jobs[i].fn = job_fns[i];
+        jobs[i].period_us = sim_jobs[i].period_ms * 1000;
+        jobs[i].flags = sim_jobs[i].flags;
+        nominal_us[i] = jobs[i].period_us;
+    }
+    SchedLoop s;
+    schedInit(&s, jobs, SIM_JOBS, simClock, LOOP_IDLE_SLACK_MS * 1000);
+
+    uint32_t late_max = 0;
+    while (elapsed() < seconds * 1e6) {
+        uint32_t wait = schedRun(&s);
+        if (wait > 0) sleepMs((wait + 999) / 1000);
+        else cpu(1);
+    }
+    report("deadline scheduler", seconds, jobs);
+    for (int i = 0; i < SIM_JOBS; i++) {
+        const SchedJob* j = &jobs[i];
+        if (!(j->flags & SCHED_IDLE) && j->late_max_us > late_max) late_max = j->late_max_us;
+    }
+    uint32_t deferred = jobs[SIM_JOBS - 1].deferred;
+    printf("  start late max %.2fms (regular jobs), idle job deferred %u times, busy %.2f%%\n",
+           late_max / 1000.0, (unsigned)deferred, 100.0 * s.busy_us / (seconds * 1e6));
+}
+
+static void usage() {
+    fprintf(stderr,
+            "usage: sched_sim [--ap] [--rec] [--seed n] [seconds]\n"
+            "  --ap    Web server active (stats page polled ~1/s)\n"
+            "  --rec   IMU recording active (4KB flash write every ~0.45s)\n");
+    exit(2);
+}
+
+int main(int argc, char** argv) {
+    double seconds = 60;
+    uint32_t seed = 1;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--ap")) ap_mode = true;
+        else if (!strcmp(argv[i], "--rec")) recording = true;
+        else if (!strcmp(argv[i], "--seed") && i + 1 < argc) seed = (uint32_t)strtoul(argv[++i], NULL, 0);
+        else if (argv[i][0] == '-') usage();
+        else seconds = atof(argv[i]);
+    }
+    if (seconds <= 0) usage();
+
+    printf("%.0fs simulated, web %s, recorder %s\n", seconds, ap_mode ? "on" : "off", recording ? "on" : "off");
+    runFixed(seconds, seed);
+    runSched(seconds, seed);
+    return 0;
+}
@@ -0,0 +1,307 @@
+/*
+ * File: sim.cpp
+ * Description: Host Tests and Benchmark of the Truck Image Cache
+ * Author: zzackk125
+ * License: MIT
+ *
+ * Runs src/truck_cache.cpp on the real truck images, set up as ui.cpp does
+ * (rear: 1x, side: 1.25x, both about (32, 32)). The checks cover the
+ * renderings (exact at 0 and 90 degrees, coverage and centroid at other
+ * angles, tint), key quantization, LRU order, counters and memory. The
+ * benchmark then replays angle traces and compares a frame through the
+ * cache (lookup + blend of the rendering) against transforming every frame
+ * (render + blend), which is what LVGL did.
+ */
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "truck_cache.h"
+#include "board_config.h"
+extern "C" {
+#include "img_truck_rear.h"
+#include "img_truck_side.h"
+}
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    if (!ok) {
+        printf("    FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+static const uint8_t* srcPx(const lv_image_dsc_t* src, int x, int y) {
+    return src->data + ((size_t)y * src->header.w + x) * 4;
+}
+
+static uint16_t to565(uint8_t r, uint8_t g, uint8_t b) {
+    return (uint16_t)(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3));
+}
+
+static uint8_t entryAlpha(const TruckCacheEntry* e, int x, int y) {
+    int w = e->dsc.header.w, h = e->dsc.header.h;
+    return e->dsc.data[(size_t)w * h * 2 + (size_t)y * w + x];
+}
+
+static uint16_t entryRgb(const TruckCacheEntry* e, int x, int y) {
+    return ((const uint16_t*)e->dsc.data)[(size_t)y * e->dsc.header.w + x];
+}
+
+// Rendering pixel (x, y) must equal the source pixel map(X, Y), where (X, Y)
+// is the pixel's offset from the pivot (only for exact quarter turns)
+static bool matchesSource(const TruckCacheEntry* e, const lv_image_dsc_t* src, int turn) {
+    int sw = src->header.w, sh = src->header.h;
+    uint64_t src_alpha = 0, got_alpha = 0;
+    for (int y = 0; y < sh; y++) {
+        for (int x = 0; x < sw; x++) src_alpha += srcPx(src, x, y)[3];
+    }
+    for (int y = 0; y < (int)e->dsc.header.h; y++) {
+        for (int x = 0; x < (int)e->dsc.header.w; x++) {
+            int X = e->ox + x, Y = e->oy + y;
+            int sx = turn ? 32 + Y : 32 + X, sy = turn ? 32 - X : 32 + Y;
+            uint8_t a = entryAlpha(e, x, y);
+            got_alpha += a;
+            if (sx < 0 || sy < 0 || sx >= sw || sy >= sh) {
+                if (a) return false;
+                continue;
+            }
+            const uint8_t* p = srcPx(src, sx, sy);
+            if (a != p[3]) return false;
+            if (a && entryRgb(e, x, y) != to565(p[2], p[1], p[0])) return false;
+        }
+    }
+    return got_alpha == src_alpha; // Nothing clipped away
+}
+
+struct Moments {
+    double sum, cx, cy;
+};
+
+static Moments sourceMoments(const lv_image_dsc_t* src) {
+    Moments m = { 0, 0, 0 };
+    for (int y = 0; y < (int)src->header.h; y++) {
+        for (int x = 0; x < (int)src->header.w; x++) {
+            double a = srcPx(src, x, y)[3] / 255.0;
+            m.sum += a;
+            m.cx += a * (x - 32);
+            m.cy += a * (y - 32);
+        }
+    }
+    m.cx /= m.sum;
+    m.cy /= m.sum;
+    return m;
+}
+
+static Moments entryMoments(const TruckCacheEntry* e) {
+    Moments m = { 0, 0, 0 };
+    for (int y = 0; y < (int)e->dsc.header.h; y++) {
+        for (int x = 0; x < (int)e->dsc.header.w; x++) {
+            double a = entryAlpha(e, x, y) / 255.0;
+            m.sum += a;
+            m.cx += a * (e->ox + x);
+            m.cy += a * (e->oy + y);
+        }
+    }
+    m.cx /= m.sum;
+    m.cy /= m.sum;
+    return m;
+}
+
+// --- Checks ---
+static void checkRenderings() {
+    TruckCache tc;
+    check(truckCacheInit(&tc, &img_truck_rear, 32, 32, 256, TRUCK_CACHE_STEP, 4), "rear init");
+    check(matchesSource(truckCacheGet(&tc, 0), &img_truck_rear, 0), "0 deg rendering is the source");
+    check(matchesSource(truckCacheGet(&tc, 900), &img_truck_rear, 1), "90 deg rendering is the source turned");
+
+    // Any angle, 1x and 1.25x: same coverage (x scale^2), centroid turned with it
+    const struct { const lv_image_dsc_t* src; uint16_t scale; } cases[] = {
+        { &img_truck_rear, 256 }, { &img_truck_side, 320 },
+    };
+    for (auto& c : cases) {
+        TruckCache t;
+        truckCacheInit(&t, c.src, 32, 32, c.scale, TRUCK_CACHE_STEP, 1);
+        Moments ref = sourceMoments(c.src);
+        double k = c.scale / 256.0, worst_cover = 0, worst_shift = 0;
+        for (int32_t rot = -1800; rot < 1800; rot += 73) {
+            const TruckCacheEntry* e = truckCacheGet(&t, rot);
+            check(e->dsc.header.w <= t.side && e->dsc.header.h <= t.side, "rendering fits its slot");
+            Moments m = entryMoments(e);
+            double rad = e->key * t.step * M_PI / 1800;
+            double ex = k * (ref.cx * cos(rad) - ref.cy * sin(rad));
+            double ey = k * (ref.cx * sin(rad) + ref.cy * cos(rad));
+            double cover = fabs(m.sum / (ref.sum * k * k) - 1);
+            double shift = hypot(m.cx - ex, m.cy - ey);
+            if (cover > worst_cover) worst_cover = cover;
+            if (shift > worst_shift) worst_shift = shift;
+        }
+        printf("  %s x%.2f: slot %ux%u, coverage within %.2f%%, centroid within %.2f px\n",
+               c.src == &img_truck_rear ? "rear" : "side", k, t.side, t.side, worst_cover * 100, worst_shift);
+        check(worst_cover < 0.02, "coverage kept at every angle");
+        check(worst_shift < 0.5, "centroid follows the rotation");
+        truckCacheFree(&t);
+    }
+
+    // Tint: every covered pixel takes the colour, and the cache starts over
+    TruckCacheStats a, b;
+    getTruckCacheStats(&tc, &a);
+    truckCacheSetTint(&tc, 0x2196F3, 255);
+    const TruckCacheEntry* e = truckCacheGet(&tc, 0);
+    bool tinted = true;
+    for (int y = 0; y < (int)e->dsc.header.h; y++) {
+        for (int x = 0; x < (int)e->dsc.header.w; x++) {
+            if (entryAlpha(e, x, y) && entryRgb(e, x, y) != to565(0x21, 0x96, 0xF3)) tinted = false;
+        }
+    }
+    truckCacheSetTint(&tc, 0x2196F3, 255);
+    getTruckCacheStats(&tc, &b);
+    check(tinted, "tint baked into the rendering");
+    check(b.misses == a.misses + 1 && b.flushes == a.flushes + 1, "tint change re-renders once");
+    truckCacheFree(&tc);
+}
+
+static void checkCache() {
+    TruckCache tc;
+    truckCacheInit(&tc, &img_truck_rear, 32, 32, 256, 10, 2);
+    TruckCacheStats st;
+    getTruckCacheStats(&tc, &st);
+    check(st.slots == 2 && st.bytes == 2u * tc.side * tc.side * 3, "memory = slots x side^2 x 3");
+
+    // Quantization: +/-0.4 deg share key 0, 0.5 rounds away from zero
+    const int32_t rots[] = { 0, 4, -4, 1, -1 };
+    const TruckCacheEntry* e0 = truckCacheGet(&tc, 0);
+    for (int32_t r : rots) check(truckCacheGet(&tc, r) == e0, "same key within half a step");
+    check(truckCacheGet(&tc, 5)->key == 1 && truckCacheGet(&tc, -5)->key == -1, "half a step rounds away from 0");
+
+    // LRU: keys 1 and -1 are in; touching 1 makes 0 replace -1, then -1 replace 0
+    truckCacheGet(&tc, 10);
+    getTruckCacheStats(&tc, &st);
+    uint32_t ev = st.evictions;
+    const TruckCacheEntry* e = truckCacheGet(&tc, 0);
+    check(e->key == 0 && e != truckCacheGet(&tc, 10), "key 0 rendered beside key 1");
+    check(truckCacheGet(&tc, -10)->key == -1, "key -1 rendered again");
+    check(truckCacheGet(&tc, 10)->key == 1, "key 1 (used last) survived");
+    getTruckCacheStats(&tc, &st);
+    check(st.evictions == ev + 2, "two evictions");
+
+    // gen changes exactly when a slot is re-rendered
+    const TruckCacheEntry* a = truckCacheGet(&tc, 100);
+    uint32_t gen = a->gen;
+    check(truckCacheGet(&tc, 101)->gen == gen, "hit keeps gen");
+    truckCacheGet(&tc, 200);
+    truckCacheGet(&tc, 300);
+    check(truckCacheGet(&tc, 100)->gen != gen, "re-rendering bumps gen");
+
+    // Memory never grows
+    for (int32_t r = -900; r <= 900; r += 3) truckCacheGet(&tc, r);
+    getTruckCacheStats(&tc, &st);
+    check(st.bytes == 2u * tc.side * tc.side * 3, "memory fixed after a sweep");
+    truckCacheFree(&tc);
+
+    // No slots: the caller keeps transforming
+    check(!truckCacheInit(&tc, &img_truck_rear, 32, 32, 256, 10, 0) && truckCacheGet(&tc, 0) == NULL,
+          "zero slots returns NULL");
+}
+
+// --- Benchmark ---
+static std::vector<uint16_t> screen(LCD_H_RES * LVGL_BUF_HEIGHT * 3, 0x18E3);
+
+// Blend an RGB565A8 rendering into a 466 wide RGB565 buffer
+__attribute__((noinline)) static void blend(const TruckCacheEntry* e, int x0, int y0) {
+    int w = e->dsc.header.w, h = e->dsc.header.h;
+    const uint16_t* rgb = (const uint16_t*)e->dsc.data;
+    const uint8_t* alpha = e->dsc.data + (size_t)w * h * 2;
+    for (int y = 0; y < h; y++) {
+        uint16_t* row = screen.data() + (size_t)(y0 + y) * LCD_H_RES + x0;
+        for (int x = 0; x < w; x++) {
+            uint32_t a = alpha[y * w + x];
+            if (!a) continue;
+            uint16_t fg = rgb[y * w + x], bg = row[x];
+            if (a == 255) {
+                row[x] = fg;
+                continue;
+            }
+            uint32_t r = ((fg >> 11) * a + (bg >> 11) * (255 - a)) >> 8;
+            uint32_t g = (((fg >> 5) & 0x3F) * a + ((bg >> 5) & 0x3F) * (255 - a)) >> 8;
+            uint32_t b = ((fg & 0x1F) * a + (bg & 0x1F) * (255 - a)) >> 8;
+            row[x] = (uint16_t)((r << 11) | (g << 5) | b);
+        }
+    }
+}
+
+struct Trace {
+    const char* name;
+    float (*angle)(int frame);  // Degrees
+};
+
+static float traceSteady(int i) { return 12.3f + 0.05f * sinf(i * 0.7f); }
+static float traceRock04(int i) { return 12.5f + 0.4f * sinf(i * 0.3f); }
+static float traceRock09(int i) { return 12.5f + 0.9f * sinf(i * 0.3f); }
+static float traceSweep(int i) { return -30.0f + 60.0f * (i % 3000) / 3000.0f; }
+static float traceWalk(int i) {
+    static float a = 0;
+    static int last = -1;
+    if (i <= last) a = 0;
+    last = i;
+    a += ((rand() % 2001) - 1000) / 4000.0f; // +/-0.25 deg per frame
+    return a;
+}
+
+static const Trace traces[] = {
+    { "steady (+/-0.05 deg)", traceSteady },
+    { "rocking +/-0.4 deg", traceRock04 },
+    { "rocking +/-0.9 deg", traceRock09 },
+    { "sweep -30..30 deg", traceSweep },
+    { "random walk", traceWalk },
+};
+
+static void bench() {
+    const int frames = 3000;
+    const struct { const char* name; const lv_image_dsc_t* src; uint16_t scale; } trucks[] = {
+        { "rear 1x", &img_truck_rear, 256 }, { "side 1.25x", &img_truck_side, 320 },
+    };
+    printf("\n%d frames per trace, %d slots, %.1f deg step\n\n", frames, TRUCK_CACHE_SLOTS, TRUCK_CACHE_STEP / 10.0);
+    printf("  %-11s %-22s %7s %12s %12s %8s\n", "truck", "trace", "hits", "cached us", "transform us", "speedup");
+    for (auto& t : trucks) {
+        for (const Trace& tr : traces) {
+            double us[2];
+            uint32_t hits = 0;
+            for (int pass = 0; pass < 2; pass++) {
+                TruckCache tc;
+                truckCacheInit(&tc, t.src, 32, 32, t.scale, TRUCK_CACHE_STEP, TRUCK_CACHE_SLOTS);
+                srand(1);
+                auto t0 = std::chrono::steady_clock::now();
+                for (int i = 0; i < frames; i++) {
+                    if (pass == 1) truckCacheFlush(&tc); // Every frame rendered from scratch
+                    const TruckCacheEntry* e = truckCacheGet(&tc, (int32_t)lroundf(-tr.angle(i) * 10));
+                    blend(e, 100 + tc.side / 2 + e->ox, 60 + tc.side / 2 + e->oy);
+                }
+                us[pass] = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count() * 1e6 / frames;
+                TruckCacheStats st;
+                getTruckCacheStats(&tc, &st);
+                if (pass == 0) hits = st.hits;
+                truckCacheFree(&tc);
+            }
+            printf("  %-11s %-22s %6.1f%% %12.1f %12.1f %7.1fx\n", t.name, tr.name, 100.0 * hits / frames, us[0],
+                   us[1], us[1] / us[0]);
+        }
+    }
+    printf("\n(cached = lookup + blend, plus a render on a miss; transform = render + blend every frame)\n");
+}
+
+int main(int argc, char** argv) {
+    bool run_bench = !(argc > 1 && !strcmp(argv[1], "--check"));
+    printf("Checks:\n");
+    checkRenderings();
+    checkCache();
+    printf("%s\n", failures ? "FAIL" : "OK");
+    if (failures) return 1;
+    if (run_bench) bench();
+    return 0;
+}